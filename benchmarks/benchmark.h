@@ -0,0 +1,24 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+namespace veng::benchmark {
+// Median wall time of `repetitions` calls in milliseconds, after one untimed warm-up call.
+template<typename Function>
+double MeasureMilliseconds(const int repetitions, Function &&function) {
+    function();
+
+    std::vector<double> samples;
+    samples.reserve(repetitions);
+    for (int repetition = 0; repetition < repetitions; ++repetition) {
+        const auto start = std::chrono::steady_clock::now();
+        function();
+        samples.push_back(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    std::ranges::nth_element(samples, samples.begin() + samples.size() / 2);
+    return samples[samples.size() / 2];
+}
+} // veng::benchmark
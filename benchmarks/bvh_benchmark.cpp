@@ -0,0 +1,194 @@
+#include "bvh.h"
+
+#include <algorithm>
+#include <precomp.h>
+#include <random>
+
+#include <spdlog/spdlog.h>
+
+#include "benchmark.h"
+#include "glm/gtc/matrix_transform.hpp"
+
+namespace {
+constexpr std::size_t kObjectCount = 1000000;
+constexpr std::size_t kUpdateCount = 100000;
+constexpr std::size_t kRayCount = 100000;
+// Each checked ray is tested against every object.
+constexpr std::size_t kCheckedRayCount = 200;
+constexpr float kRayLength = 50.0f;
+
+bool Overlaps(const veng::Aabb &a, const veng::Aabb &b) {
+    return a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y && b.min.y <= a.max.y &&
+           a.min.z <= b.max.z && b.min.z <= a.max.z;
+}
+
+// Same slab test as the tree, so hit distances have to match exactly.
+std::optional<float> IntersectRay(const veng::Aabb &box, const glm::vec3 &origin, const glm::vec3 &inverse_direction,
+                                  const float max_distance) {
+    float entry = 0.0f;
+    float exit = max_distance;
+    for (glm::length_t axis = 0; axis < 3; ++axis) {
+        float slab_entry = (box.min[axis] - origin[axis]) * inverse_direction[axis];
+        float slab_exit = (box.max[axis] - origin[axis]) * inverse_direction[axis];
+        if (slab_entry > slab_exit) {
+            std::swap(slab_entry, slab_exit);
+        }
+        entry = std::fmax(entry, slab_entry);
+        exit = std::fmin(exit, slab_exit);
+    }
+    if (entry > exit) {
+        return std::nullopt;
+    }
+    return entry;
+}
+
+struct Ray {
+    glm::vec3 origin{};
+    glm::vec3 direction{};
+};
+
+class Benchmark {
+public:
+    Benchmark() : random_(3) {
+        const glm::mat4 view = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -5.0f));
+        const glm::mat4 proj = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 300.0f);
+        frustum_ = veng::Frustum::FromViewProjection(view, proj);
+
+        std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+        std::uniform_real_distribution<float> size(0.1f, 3.0f);
+        bounds_.reserve(kObjectCount);
+        for (std::size_t i = 0; i < kObjectCount; ++i) {
+            const glm::vec3 center = {position(random_), position(random_), position(random_)};
+            const glm::vec3 half_extent = {size(random_), size(random_), size(random_)};
+            bounds_.push_back({center - half_extent, center + half_extent});
+        }
+
+        std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+        rays_.reserve(kRayCount);
+        for (std::size_t i = 0; i < kRayCount; ++i) {
+            rays_.push_back({
+                {position(random_), position(random_), position(random_)},
+                {direction(random_), direction(random_), direction(random_)}
+            });
+        }
+        // Axis-parallel rays take the infinite inverse direction path.
+        rays_[0].direction = {1.0f, 0.0f, 0.0f};
+        rays_[1].direction = {0.0f, -1.0f, 0.0f};
+    }
+
+    bool Run() {
+        const double build_ms = veng::benchmark::MeasureMilliseconds(3, [this] { bvh_.Build(bounds_); });
+        spdlog::info("Build: {:.1f} ms, {} nodes", build_ms, bvh_.GetNodeCount());
+        CheckQueries("after Build");
+
+        const double frustum_ms = veng::benchmark::MeasureMilliseconds(25, [this] {
+            bvh_.QueryFrustum(frustum_, results_);
+        });
+        spdlog::info("QueryFrustum: {:.3f} ms, {} visible", frustum_ms, results_.size());
+
+        const veng::Aabb query_box = {{-40.0f, -40.0f, -40.0f}, {40.0f, 40.0f, 40.0f}};
+        const double box_ms = veng::benchmark::MeasureMilliseconds(25, [this, &query_box] {
+            bvh_.QueryBox(query_box, results_);
+        });
+        spdlog::info("QueryBox: {:.3f} ms, {} overlapping", box_ms, results_.size());
+
+        std::size_t hits = 0;
+        const double ray_ms = veng::benchmark::MeasureMilliseconds(5, [this, &hits] {
+            hits = 0;
+            for (const Ray &ray: rays_) {
+                hits += bvh_.Raycast(ray.origin, ray.direction, kRayLength).has_value() ? 1 : 0;
+            }
+        });
+        spdlog::info("Raycast: {:.1f} ms for {} rays, {} hits", ray_ms, rays_.size(), hits);
+
+        std::uniform_int_distribution<std::uint32_t> object(0, kObjectCount - 1);
+        std::uniform_real_distribution<float> offset(-2.0f, 2.0f);
+        const double update_ms = veng::benchmark::MeasureMilliseconds(5, [&] {
+            for (std::size_t i = 0; i < kUpdateCount; ++i) {
+                veng::Aabb &bounds = bounds_[object(random_)];
+                const glm::vec3 move = {offset(random_), offset(random_), offset(random_)};
+                bounds = {bounds.min + move, bounds.max + move};
+                bvh_.UpdateBounds(static_cast<std::uint32_t>(&bounds - bounds_.data()), bounds);
+            }
+        });
+        spdlog::info("UpdateBounds: {:.1f} ms for {} objects", update_ms, kUpdateCount);
+        CheckQueries("after UpdateBounds");
+
+        const double refit_ms = veng::benchmark::MeasureMilliseconds(5, [this] {
+            for (veng::Aabb &bounds: bounds_) {
+                bounds = {bounds.min + glm::vec3(0.5f, 0.0f, 0.0f), bounds.max + glm::vec3(0.5f, 0.0f, 0.0f)};
+            }
+            bvh_.Refit(bounds_);
+        });
+        spdlog::info("Refit: {:.1f} ms, including moving every object", refit_ms);
+        CheckQueries("after Refit");
+
+        return consistent_;
+    }
+
+private:
+    void Verify(const bool condition, const std::string_view what, const std::string_view when) {
+        if (!condition) {
+            consistent_ = false;
+            spdlog::error("{} {}", what, when);
+        }
+    }
+
+    void CheckQueries(const std::string_view when) {
+        veng::BoundingBoxes boxes;
+        boxes.Reserve(bounds_.size());
+        for (const veng::Aabb &bounds: bounds_) {
+            boxes.Add(bounds.min, bounds.max);
+        }
+        std::vector<std::uint32_t> expected;
+        veng::CullBoxes(frustum_, boxes, expected);
+        bvh_.QueryFrustum(frustum_, results_);
+        std::ranges::sort(results_);
+        Verify(results_ == expected, "QueryFrustum disagrees with CullBoxes", when);
+
+        const veng::Aabb query_box = {{-40.0f, -40.0f, -40.0f}, {40.0f, 40.0f, 40.0f}};
+        expected.clear();
+        for (std::uint32_t object = 0; object < bounds_.size(); ++object) {
+            if (Overlaps(bounds_[object], query_box)) {
+                expected.push_back(object);
+            }
+        }
+        bvh_.QueryBox(query_box, results_);
+        std::ranges::sort(results_);
+        Verify(results_ == expected, "QueryBox disagrees with brute force", when);
+
+        for (std::size_t i = 0; i < kCheckedRayCount; ++i) {
+            const Ray &ray = rays_[i];
+            const glm::vec3 inverse_direction = 1.0f / ray.direction;
+            std::optional<float> closest;
+            for (const veng::Aabb &bounds: bounds_) {
+                const std::optional<float> hit = IntersectRay(bounds, ray.origin, inverse_direction, kRayLength);
+                if (hit.has_value() && (!closest.has_value() || *hit < *closest)) {
+                    closest = hit;
+                }
+            }
+
+            const std::optional<veng::BvhRayHit> hit = bvh_.Raycast(ray.origin, ray.direction, kRayLength);
+            const bool same_hit = hit.has_value() == closest.has_value() &&
+                                  (!hit.has_value() || (hit->distance == *closest &&
+                                                        IntersectRay(bounds_[hit->object], ray.origin,
+                                                                     inverse_direction, kRayLength) == closest));
+            Verify(same_hit, "Raycast disagrees with brute force", when);
+        }
+    }
+
+    std::mt19937 random_;
+    veng::Frustum frustum_;
+    std::vector<veng::Aabb> bounds_;
+    std::vector<Ray> rays_;
+    veng::Bvh bvh_;
+    std::vector<std::uint32_t> results_;
+    bool consistent_ = true;
+};
+}
+
+int main() {
+    spdlog::info("BVH over {} objects", kObjectCount);
+    Benchmark benchmark;
+    return benchmark.Run() ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -0,0 +1,66 @@
+#include "frustum_culling.h"
+
+#include <array>
+#include <precomp.h>
+#include <random>
+
+#include <spdlog/spdlog.h>
+
+#include "benchmark.h"
+#include "glm/gtc/matrix_transform.hpp"
+
+namespace {
+constexpr std::size_t kObjectCount = 1000000;
+constexpr int kRepetitions = 25;
+
+constexpr std::array kPaths = {veng::SimdPath::Scalar, veng::SimdPath::Sse, veng::SimdPath::Avx2};
+constexpr std::array kPathNames = {"scalar", "sse", "avx2"};
+}
+
+int main() {
+    const glm::mat4 view = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -5.0f));
+    const glm::mat4 proj = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+    const veng::Frustum frustum = veng::Frustum::FromViewProjection(view, proj);
+
+    // Scattered well past the far plane, so a fair share of objects gets culled by every plane.
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> position(-150.0f, 150.0f);
+    std::uniform_real_distribution<float> size(0.1f, 3.0f);
+
+    veng::BoundingSpheres spheres;
+    veng::BoundingBoxes boxes;
+    spheres.Reserve(kObjectCount);
+    boxes.Reserve(kObjectCount);
+    for (std::size_t i = 0; i < kObjectCount; ++i) {
+        const glm::vec3 center = {position(random), position(random), position(random)};
+        const float radius = size(random);
+        spheres.Add(center, radius);
+        boxes.Add(center - glm::vec3(radius), center + glm::vec3(radius));
+    }
+
+    spdlog::info("Culling {} objects, best path {}", kObjectCount,
+                 kPathNames[static_cast<std::size_t>(veng::GetBestSimdPath())]);
+
+    std::vector<std::uint32_t> visible;
+    visible.reserve(kObjectCount);
+    for (std::size_t i = 0; i < kPaths.size(); ++i) {
+        const veng::SimdPath path = kPaths[i];
+        if (veng::GetSupportedSimdPath(path) != path) {
+            spdlog::info("{}: not supported", kPathNames[i]);
+            continue;
+        }
+
+        const double sphere_ms = veng::benchmark::MeasureMilliseconds(kRepetitions, [&] {
+            veng::CullSpheres(frustum, spheres, visible, path);
+        });
+        const std::size_t visible_spheres = visible.size();
+        const double box_ms = veng::benchmark::MeasureMilliseconds(kRepetitions, [&] {
+            veng::CullBoxes(frustum, boxes, visible, path);
+        });
+
+        spdlog::info("{}: spheres {:.3f} ms ({} visible), boxes {:.3f} ms ({} visible)", kPathNames[i], sphere_ms,
+                     visible_spheres, box_ms, visible.size());
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,60 @@
+#include "job_system.h"
+
+#include <algorithm>
+#include <atomic>
+#include <precomp.h>
+#include <thread>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "benchmark.h"
+
+namespace {
+constexpr std::size_t kElementCount = 4000000;
+constexpr std::size_t kGrain = 4096;
+constexpr std::uint32_t kEmptyJobCount = 100000;
+constexpr int kRepetitions = 15;
+}
+
+int main() {
+    std::vector<float> input(kElementCount);
+    for (std::size_t i = 0; i < kElementCount; ++i) {
+        input[i] = static_cast<float>(i);
+    }
+    std::vector<float> output(kElementCount);
+
+    // The creating thread runs jobs in Wait too, so a system with N - 1 workers runs on N threads. One thread is the
+    // baseline every speedup is relative to.
+    const std::uint32_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+    double single_thread_ms = 0.0;
+    for (std::uint32_t thread_count = 1; thread_count <= max_threads; ++thread_count) {
+        veng::JobSystem jobs(thread_count - 1);
+
+        const double parallel_for_ms = veng::benchmark::MeasureMilliseconds(kRepetitions, [&] {
+            jobs.ParallelFor(kElementCount, kGrain, [&](const std::size_t begin, const std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i) {
+                    output[i] = std::sqrt(input[i]) * std::sin(input[i]);
+                }
+            });
+        });
+
+        // Measures scheduling overhead alone: every job is as cheap as it gets.
+        std::atomic<std::uint32_t> ran = 0;
+        const double empty_jobs_ms = veng::benchmark::MeasureMilliseconds(kRepetitions, [&] {
+            veng::JobCounter counter;
+            for (std::uint32_t i = 0; i < kEmptyJobCount; ++i) {
+                jobs.Submit([&] { ran.fetch_add(1, std::memory_order_relaxed); }, &counter);
+            }
+            jobs.Wait(counter);
+        });
+
+        if (thread_count == 1) {
+            single_thread_ms = parallel_for_ms;
+        }
+        spdlog::info("{} threads: ParallelFor over {} floats {:.3f} ms ({:.2f}x), {} empty jobs {:.3f} ms",
+                     thread_count, kElementCount, parallel_for_ms, single_thread_ms / parallel_for_ms, kEmptyJobCount,
+                     empty_jobs_ms);
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,106 @@
+#include "mesh_optimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <precomp.h>
+#include <random>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "benchmark.h"
+
+namespace {
+// 300 x 300 quads, 180k triangles.
+constexpr std::uint32_t kGridSize = 300;
+constexpr int kRepetitions = 9;
+
+// What a loader hands over for a triangle soup: three vertices per triangle, in random order.
+void MakeTriangleSoup(std::vector<veng::Vertex> &vertices, std::vector<std::uint32_t> &indices) {
+    const auto make_vertex = [](const std::uint32_t x, const std::uint32_t y) {
+        const float u = static_cast<float>(x) / kGridSize;
+        const float v = static_cast<float>(y) / kGridSize;
+        const float height = 1.0f - (u - 0.5f) * (u - 0.5f) - (v - 0.5f) * (v - 0.5f);
+        return veng::Vertex(glm::vec3(u, v, height), glm::vec2(u, v));
+    };
+
+    std::vector<std::array<veng::Vertex, 3>> triangles;
+    triangles.reserve(kGridSize * kGridSize * 2);
+    for (std::uint32_t y = 0; y < kGridSize; ++y) {
+        for (std::uint32_t x = 0; x < kGridSize; ++x) {
+            triangles.push_back({make_vertex(x, y), make_vertex(x + 1, y), make_vertex(x + 1, y + 1)});
+            triangles.push_back({make_vertex(x, y), make_vertex(x + 1, y + 1), make_vertex(x, y + 1)});
+        }
+    }
+    std::mt19937 random(1);
+    std::ranges::shuffle(triangles, random);
+
+    for (const std::array<veng::Vertex, 3> &triangle: triangles) {
+        for (const veng::Vertex &vertex: triangle) {
+            indices.push_back(static_cast<std::uint32_t>(vertices.size()));
+            vertices.push_back(vertex);
+        }
+    }
+}
+}
+
+int main() {
+    std::vector<veng::Vertex> soup_vertices;
+    std::vector<std::uint32_t> soup_indices;
+    MakeTriangleSoup(soup_vertices, soup_indices);
+    spdlog::info("Optimizing {} triangles, {} vertices", soup_indices.size() / 3, soup_vertices.size());
+
+    // Every step restores its input first; copying into the already sized buffers is timed on its own for reference.
+    std::vector<veng::Vertex> vertices = soup_vertices;
+    std::vector<std::uint32_t> indices = soup_indices;
+    const double copy_ms = veng::benchmark::MeasureMilliseconds(kRepetitions, [&] {
+        vertices.assign(soup_vertices.begin(), soup_vertices.end());
+        indices.assign(soup_indices.begin(), soup_indices.end());
+    });
+    spdlog::info("Restoring the input: {} ms", copy_ms);
+
+    const double deduplicate_ms = veng::benchmark::MeasureMilliseconds(kRepetitions, [&] {
+        vertices.assign(soup_vertices.begin(), soup_vertices.end());
+        indices.assign(soup_indices.begin(), soup_indices.end());
+        veng::DeduplicateVertices(vertices, indices);
+    });
+    spdlog::info("DeduplicateVertices: {} ms, {} vertices left", deduplicate_ms, vertices.size());
+
+    const std::vector<veng::Vertex> unique_vertices = vertices;
+    const std::vector<std::uint32_t> shuffled_indices = indices;
+    const auto vertex_count = static_cast<std::uint32_t>(unique_vertices.size());
+    const double cache_ms = veng::benchmark::MeasureMilliseconds(kRepetitions, [&] {
+        indices.assign(shuffled_indices.begin(), shuffled_indices.end());
+        veng::OptimizeVertexCache(indices, vertex_count);
+    });
+    spdlog::info("OptimizeVertexCache: {} ms, ACMR {} -> {}", cache_ms,
+                 veng::AnalyzeVertexCache(shuffled_indices, vertex_count).acmr,
+                 veng::AnalyzeVertexCache(indices, vertex_count).acmr);
+
+    const std::vector<std::uint32_t> cache_indices = indices;
+    const double overdraw_ms = veng::benchmark::MeasureMilliseconds(kRepetitions, [&] {
+        indices.assign(cache_indices.begin(), cache_indices.end());
+        veng::OptimizeOverdraw(indices, unique_vertices);
+    });
+    spdlog::info("OptimizeOverdraw: {} ms, ACMR {}", overdraw_ms,
+                 veng::AnalyzeVertexCache(indices, vertex_count).acmr);
+
+    const std::vector<std::uint32_t> overdraw_indices = indices;
+    const double fetch_ms = veng::benchmark::MeasureMilliseconds(kRepetitions, [&] {
+        vertices.assign(unique_vertices.begin(), unique_vertices.end());
+        indices.assign(overdraw_indices.begin(), overdraw_indices.end());
+        veng::OptimizeVertexFetch(vertices, indices);
+    });
+    spdlog::info("OptimizeVertexFetch: {} ms", fetch_ms);
+
+    veng::MeshOptimizationReport report;
+    const double mesh_ms = veng::benchmark::MeasureMilliseconds(kRepetitions, [&] {
+        vertices.assign(soup_vertices.begin(), soup_vertices.end());
+        indices.assign(soup_indices.begin(), soup_indices.end());
+        report = veng::OptimizeMesh(vertices, indices);
+    });
+    spdlog::info("OptimizeMesh: {} ms, {} -> {} vertices, ACMR {} -> {}, ATVR {} -> {}", mesh_ms,
+                 report.vertex_count_before, report.vertex_count_after, report.before.acmr, report.after.acmr,
+                 report.before.atvr, report.after.atvr);
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,64 @@
+#include "transform_store.h"
+
+#include <array>
+#include <precomp.h>
+#include <random>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "benchmark.h"
+
+namespace {
+constexpr std::size_t kObjectCount = 200000;
+constexpr int kRepetitions = 25;
+
+constexpr std::array kPaths = {veng::SimdPath::Scalar, veng::SimdPath::Sse, veng::SimdPath::Avx2};
+constexpr std::array kPathNames = {"scalar", "sse", "avx2"};
+}
+
+int main() {
+    std::mt19937 random(1);
+    std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> component(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> scale(0.1f, 4.0f);
+
+    veng::TransformStore store;
+    store.Reserve(kObjectCount);
+    for (std::size_t i = 0; i < kObjectCount; ++i) {
+        const glm::vec4 rotation = {component(random), component(random), component(random), component(random)};
+        const float inverse_length = 1.0f / std::sqrt(rotation.x * rotation.x + rotation.y * rotation.y +
+                                                      rotation.z * rotation.z + rotation.w * rotation.w);
+        store.Add({position(random), position(random), position(random)},
+                  glm::quat(rotation.w * inverse_length, rotation.x * inverse_length, rotation.y * inverse_length,
+                            rotation.z * inverse_length),
+                  {scale(random), scale(random), scale(random)});
+    }
+
+    spdlog::info("Writing {} world matrices, best path {}", kObjectCount,
+                 kPathNames[static_cast<std::size_t>(veng::GetBestSimdPath())]);
+
+    // Mapped GPU memory is always aligned and gets streamed to; starting one float in forces plain stores instead.
+    std::vector<glm::mat4> storage(kObjectCount + 1);
+    const std::span<glm::mat4> aligned(storage.data(), kObjectCount);
+    const std::span<glm::mat4> misaligned(reinterpret_cast<glm::mat4 *>(reinterpret_cast<float *>(storage.data()) + 1),
+                                          kObjectCount);
+
+    for (std::size_t i = 0; i < kPaths.size(); ++i) {
+        const veng::SimdPath path = kPaths[i];
+        if (veng::GetSupportedSimdPath(path) != path) {
+            spdlog::info("{}: not supported", kPathNames[i]);
+            continue;
+        }
+
+        const double aligned_ms = veng::benchmark::MeasureMilliseconds(kRepetitions, [&] {
+            store.WriteWorldMatrices(0, aligned, path);
+        });
+        const double misaligned_ms = veng::benchmark::MeasureMilliseconds(kRepetitions, [&] {
+            store.WriteWorldMatrices(0, misaligned, path);
+        });
+        spdlog::info("{}: aligned {:.3f} ms, misaligned {:.3f} ms", kPathNames[i], aligned_ms, misaligned_ms);
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,56 @@
+# Script mode: cmake -DSHADER_BINARIES="a.spv|b.spv" -DOUTPUT_FILE=embedded_shaders.cpp -P EmbedShaders.cmake
+# Turns each SPIR-V binary into a constexpr word array so shaders ship inside the executable.
+
+if (NOT DEFINED SHADER_BINARIES OR NOT DEFINED OUTPUT_FILE)
+    message(FATAL_ERROR "SHADER_BINARIES and OUTPUT_FILE are required")
+endif()
+
+string(REPLACE "|" ";" SHADER_BINARIES "${SHADER_BINARIES}")
+
+set(ARRAYS "")
+set(ENTRIES "")
+set(SHADER_COUNT 0)
+
+foreach(SHADER_BINARY IN LISTS SHADER_BINARIES)
+    cmake_path(GET SHADER_BINARY FILENAME BINARY_NAME)
+    string(REGEX REPLACE "\\.spv$" "" SHADER_NAME "${BINARY_NAME}")
+    string(MAKE_C_IDENTIFIER "${SHADER_NAME}" SHADER_IDENTIFIER)
+
+    file(SIZE "${SHADER_BINARY}" BINARY_SIZE)
+    math(EXPR WORD_REMAINDER "${BINARY_SIZE} % 4")
+    if (BINARY_SIZE EQUAL 0 OR NOT WORD_REMAINDER EQUAL 0)
+        message(FATAL_ERROR "${SHADER_BINARY} is not a SPIR-V binary")
+    endif()
+
+    # SPIR-V is a little-endian word stream; swap each group of four bytes into a word literal.
+    file(READ "${SHADER_BINARY}" BINARY_HEX HEX)
+    string(REGEX REPLACE "(..)(..)(..)(..)" "0x\\4\\3\\2\\1u, " WORDS "${BINARY_HEX}")
+    # CMake regexes have no counted repetition, so spell out eight words per line.
+    string(REPEAT "0x........u, " 7 SEVEN_WORDS)
+    string(REGEX REPLACE "(${SEVEN_WORDS}0x........u,) " "\\1\n        " WORDS "${WORDS}")
+    string(REGEX REPLACE ",(\n        )?$" "" WORDS "${WORDS}")
+    string(REGEX REPLACE ", $" "" WORDS "${WORDS}")
+
+    string(APPEND ARRAYS "alignas(4) constexpr std::uint32_t k_${SHADER_IDENTIFIER}[] = {\n        ${WORDS}\n};\n\n")
+    string(APPEND ENTRIES "        EmbeddedShader{\"${SHADER_NAME}\", k_${SHADER_IDENTIFIER}},\n")
+    math(EXPR SHADER_COUNT "${SHADER_COUNT} + 1")
+endforeach()
+
+set(CONTENT "// Generated by cmake/EmbedShaders.cmake from the compiled shaders. Do not edit.
+#include \"embedded_shaders.h\"
+
+#include <array>
+
+namespace veng {
+namespace {
+${ARRAYS}constexpr std::array<EmbeddedShader, ${SHADER_COUNT}> kEmbeddedShaders = {
+${ENTRIES}};
+}
+
+std::span<const EmbeddedShader> GetEmbeddedShaders() {
+    return kEmbeddedShaders;
+}
+} // veng
+")
+
+file(WRITE "${OUTPUT_FILE}" "${CONTENT}")
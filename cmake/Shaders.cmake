@@ -1,3 +1,5 @@
+# Compiles the given shaders to SPIR-V next to the build and embeds the binaries into a generated C++ source.
+# The generated source is returned in ${TARGET_NAME}_EMBEDDED_SOURCE for the executable to compile in.
 function(add_shaders TARGET_NAME)
     set(SHADER_SOURCE_FILES ${ARGN})
     list(LENGTH SHADER_SOURCE_FILES FILE_COUNT)
@@ -5,28 +7,40 @@ function(add_shaders TARGET_NAME)
         message(FATAL_ERROR "Cannot add shaders target without shader files!")
     endif()
 
-    set(SHADER_COMMANDS)
     set(SHADER_PRODUCTS)
 
     foreach(SHADER_SOURCE IN LISTS SHADER_SOURCE_FILES)
         cmake_path(ABSOLUTE_PATH SHADER_SOURCE NORMALIZE)
         cmake_path(GET SHADER_SOURCE FILENAME SHADER_NAME)
 
-        # COMMANDS
-        list(APPEND SHADER_COMMANDS COMMAND)
-        list(APPEND SHADER_COMMANDS Vulkan::glslc)
-        list(APPEND SHADER_COMMANDS "${SHADER_SOURCE}")
-        list(APPEND SHADER_COMMANDS "-o")
-        list(APPEND SHADER_COMMANDS "${CMAKE_CURRENT_BINARY_DIR}/${SHADER_NAME}.spv")
-        # PRODUCTS
-        list(APPEND SHADER_PRODUCTS "${CMAKE_CURRENT_BINARY_DIR}/${SHADER_NAME}.spv")
-
+        set(SHADER_PRODUCT "${CMAKE_CURRENT_BINARY_DIR}/${SHADER_NAME}.spv")
+        add_custom_command(
+            OUTPUT "${SHADER_PRODUCT}"
+            COMMAND Vulkan::glslc "${SHADER_SOURCE}" -o "${SHADER_PRODUCT}" -MD -MF "${SHADER_PRODUCT}.d"
+            DEPENDS "${SHADER_SOURCE}"
+            DEPFILE "${SHADER_PRODUCT}.d"
+            COMMENT "Compiling ${SHADER_NAME}"
+        )
+        list(APPEND SHADER_PRODUCTS "${SHADER_PRODUCT}")
     endforeach()
 
+    set(EMBEDDED_SOURCE "${CMAKE_CURRENT_BINARY_DIR}/${TARGET_NAME}_embedded.cpp")
+    set(EMBED_SCRIPT "${CMAKE_CURRENT_FUNCTION_LIST_DIR}/EmbedShaders.cmake")
+    # Lists do not survive as a single command argument, so they travel '|' separated.
+    string(REPLACE ";" "|" SHADER_BINARIES "${SHADER_PRODUCTS}")
+    add_custom_command(
+        OUTPUT "${EMBEDDED_SOURCE}"
+        COMMAND ${CMAKE_COMMAND} "-DSHADER_BINARIES=${SHADER_BINARIES}" "-DOUTPUT_FILE=${EMBEDDED_SOURCE}"
+                -P "${EMBED_SCRIPT}"
+        DEPENDS ${SHADER_PRODUCTS} "${EMBED_SCRIPT}"
+        COMMENT "Embedding Shaders..."
+        VERBATIM
+    )
+
     add_custom_target(${TARGET_NAME} ALL
-        ${SHADER_COMMANDS}
-        COMMENT "Compiling Shaders..."
+        DEPENDS ${SHADER_PRODUCTS} "${EMBEDDED_SOURCE}"
         SOURCES ${SHADER_SOURCE_FILES}
-        BYPRODUCTS ${SHADER_PRODUCTS}
     )
-endfunction()
\ No newline at end of file
+
+    set(${TARGET_NAME}_EMBEDDED_SOURCE "${EMBEDDED_SOURCE}" PARENT_SCOPE)
+endfunction()
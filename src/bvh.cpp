@@ -0,0 +1,436 @@
+#include "bvh.h"
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <precomp.h>
+#include <spdlog/spdlog.h>
+
+namespace veng {
+namespace {
+constexpr std::uint32_t kBinCount = 16;
+constexpr std::uint32_t kMaxLeafObjects = 4;
+// Relative to testing the bounds of one object.
+constexpr float kTraversalCost = 1.0f;
+constexpr std::uint32_t kNoParent = std::numeric_limits<std::uint32_t>::max();
+constexpr std::uint8_t kAllPlanes = 0b111111;
+
+Aabb EmptyAabb() {
+    return {glm::vec3(std::numeric_limits<float>::max()), glm::vec3(std::numeric_limits<float>::lowest())};
+}
+
+// Same operation order as the frustum culling paths, so both agree on what is visible.
+float PlaneDistance(const glm::vec4 &plane, const glm::vec3 &point) {
+    return plane.x * point.x + plane.y * point.y + plane.z * point.z + plane.w;
+}
+
+// The box is outside when even its corner furthest along the normal is behind the plane.
+glm::vec3 GetPositiveVertex(const Aabb &box, const glm::vec4 &plane) {
+    return {plane.x >= 0.0f ? box.max.x : box.min.x,
+            plane.y >= 0.0f ? box.max.y : box.min.y,
+            plane.z >= 0.0f ? box.max.z : box.min.z};
+}
+
+// The box is completely inside when even its corner furthest against the normal is in front of the plane.
+glm::vec3 GetNegativeVertex(const Aabb &box, const glm::vec4 &plane) {
+    return {plane.x >= 0.0f ? box.min.x : box.max.x,
+            plane.y >= 0.0f ? box.min.y : box.max.y,
+            plane.z >= 0.0f ? box.min.z : box.max.z};
+}
+
+bool IsInsidePlanes(const Frustum &frustum, const Aabb &box, const std::uint8_t planes) {
+    for (std::uint32_t plane_index = 0; plane_index < frustum.planes.size(); ++plane_index) {
+        const glm::vec4 &plane = frustum.planes[plane_index];
+        if ((planes & (1u << plane_index)) != 0 && PlaneDistance(plane, GetPositiveVertex(box, plane)) < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool Overlaps(const Aabb &a, const Aabb &b) {
+    return a.min.x <= b.max.x && b.min.x <= a.max.x &&
+           a.min.y <= b.max.y && b.min.y <= a.max.y &&
+           a.min.z <= b.max.z && b.min.z <= a.max.z;
+}
+
+// Slab test returning where the ray enters the box, or zero when it starts inside. Axes the ray runs parallel to
+// produce NaNs from 0 * inf, which fmin and fmax skip.
+std::optional<float> IntersectRay(const Aabb &box, const glm::vec3 &origin, const glm::vec3 &inverse_direction,
+                                  const float max_distance) {
+    float entry = 0.0f;
+    float exit = max_distance;
+    for (glm::length_t axis = 0; axis < 3; ++axis) {
+        float slab_entry = (box.min[axis] - origin[axis]) * inverse_direction[axis];
+        float slab_exit = (box.max[axis] - origin[axis]) * inverse_direction[axis];
+        if (slab_entry > slab_exit) {
+            std::swap(slab_entry, slab_exit);
+        }
+        entry = std::fmax(entry, slab_entry);
+        exit = std::fmin(exit, slab_exit);
+    }
+    if (entry > exit) {
+        return std::nullopt;
+    }
+    return entry;
+}
+
+// Objects are partitioned by value while building, so every pass over a node reads memory sequentially.
+struct BuildReference {
+    Aabb bounds;
+    glm::vec3 centroid{};
+    std::uint32_t object = 0;
+};
+
+std::uint32_t GetBin(const float centroid, const float centroid_min, const float bin_scale,
+                     const std::uint32_t bin_count) {
+    return std::min(bin_count - 1, static_cast<std::uint32_t>((centroid - centroid_min) * bin_scale));
+}
+
+// Partitions the objects by the cheapest binned split and returns how many ended up left of it; nothing when
+// keeping them in one leaf is cheaper.
+std::optional<std::uint32_t> PartitionObjects(const std::span<BuildReference> objects, const Aabb &node_bounds,
+                                              const Aabb &centroid_bounds) {
+    const auto count = static_cast<std::uint32_t>(objects.size());
+    // Small nodes make up most of the tree; sweeping more bins than objects only costs build time.
+    const std::uint32_t bin_count = std::min(kBinCount, count);
+    float best_cost = std::numeric_limits<float>::max();
+    std::optional<glm::length_t> best_axis;
+    std::uint32_t best_split = 0;
+
+    for (glm::length_t axis = 0; axis < 3; ++axis) {
+        const float extent = centroid_bounds.max[axis] - centroid_bounds.min[axis];
+        if (!(extent > 0.0f)) {
+            continue;
+        }
+        const float bin_scale = static_cast<float>(bin_count) / extent;
+
+        std::array<Aabb, kBinCount> bins;
+        std::fill_n(bins.begin(), bin_count, EmptyAabb());
+        std::array<std::uint32_t, kBinCount> bin_counts{};
+        for (const BuildReference &reference: objects) {
+            const std::uint32_t bin = GetBin(reference.centroid[axis], centroid_bounds.min[axis], bin_scale, bin_count);
+            bins[bin].Grow(reference.bounds);
+            ++bin_counts[bin];
+        }
+
+        // Cost of everything from each bin onwards, so the forward sweep can price every split in one pass.
+        std::array<float, kBinCount> right_costs{};
+        Aabb right = EmptyAabb();
+        std::uint32_t right_count = 0;
+        for (std::uint32_t bin = bin_count - 1; bin > 0; --bin) {
+            right.Grow(bins[bin]);
+            right_count += bin_counts[bin];
+            right_costs[bin] = right_count != 0 ? right.GetSurfaceArea() * static_cast<float>(right_count) : 0.0f;
+        }
+
+        Aabb left = EmptyAabb();
+        std::uint32_t left_count = 0;
+        for (std::uint32_t split = 1; split < bin_count; ++split) {
+            left.Grow(bins[split - 1]);
+            left_count += bin_counts[split - 1];
+            if (left_count == 0 || left_count == count) {
+                continue;
+            }
+            const float cost = left.GetSurfaceArea() * static_cast<float>(left_count) + right_costs[split];
+            if (cost < best_cost) {
+                best_cost = cost;
+                best_axis = axis;
+                best_split = split;
+            }
+        }
+    }
+
+    const float node_area = node_bounds.GetSurfaceArea();
+    const bool leaf_is_cheaper = !best_axis.has_value() ||
+                                 kTraversalCost * node_area + best_cost >= node_area * static_cast<float>(count);
+    if (count <= kMaxLeafObjects && leaf_is_cheaper) {
+        return std::nullopt;
+    }
+    if (!best_axis.has_value()) {
+        // Every centroid is the same point, so no plane separates them; halving still bounds the leaf size.
+        return count / 2;
+    }
+
+    const glm::length_t axis = *best_axis;
+    const float bin_scale = static_cast<float>(bin_count) / (centroid_bounds.max[axis] - centroid_bounds.min[axis]);
+    const auto middle = std::partition(objects.begin(), objects.end(), [&](const BuildReference &reference) {
+        return GetBin(reference.centroid[axis], centroid_bounds.min[axis], bin_scale, bin_count) < best_split;
+    });
+    return static_cast<std::uint32_t>(middle - objects.begin());
+}
+}
+
+void Aabb::Grow(const Aabb &other) {
+    min = glm::min(min, other.min);
+    max = glm::max(max, other.max);
+}
+
+glm::vec3 Aabb::GetCenter() const {
+    return (min + max) * 0.5f;
+}
+
+float Aabb::GetSurfaceArea() const {
+    const glm::vec3 extent = max - min;
+    return 2.0f * (extent.x * extent.y + extent.y * extent.z + extent.z * extent.x);
+}
+
+Aabb Aabb::Transformed(const glm::mat4 &transform) const {
+    const glm::vec3 center = GetCenter();
+    const glm::vec3 half_extent = (max - min) * 0.5f;
+    glm::vec3 transformed_center;
+    glm::vec3 transformed_half_extent;
+    for (glm::length_t row = 0; row < 3; ++row) {
+        transformed_center[row] = transform[0][row] * center.x + transform[1][row] * center.y +
+                                  transform[2][row] * center.z + transform[3][row];
+        transformed_half_extent[row] = std::abs(transform[0][row]) * half_extent.x +
+                                       std::abs(transform[1][row]) * half_extent.y +
+                                       std::abs(transform[2][row]) * half_extent.z;
+    }
+    return {transformed_center - transformed_half_extent, transformed_center + transformed_half_extent};
+}
+
+void Bvh::Build(const std::span<const Aabb> bounds) {
+    nodes_.clear();
+    parents_.clear();
+    object_bounds_.assign(bounds.begin(), bounds.end());
+    object_indices_.resize(bounds.size());
+    object_leaves_.assign(bounds.size(), 0);
+    if (bounds.empty()) {
+        return;
+    }
+
+    std::vector<BuildReference> references(bounds.size());
+    for (std::uint32_t object = 0; object < bounds.size(); ++object) {
+        references[object] = {bounds[object], bounds[object].GetCenter(), object};
+    }
+
+    nodes_.reserve(bounds.size() * 2 - 1);
+    parents_.reserve(bounds.size() * 2 - 1);
+
+    struct BuildTask {
+        std::uint32_t begin = 0;
+        std::uint32_t end = 0;
+        std::uint32_t parent = kNoParent;
+    };
+    std::vector<BuildTask> tasks = {{0, static_cast<std::uint32_t>(bounds.size()), kNoParent}};
+    while (!tasks.empty()) {
+        const BuildTask task = tasks.back();
+        tasks.pop_back();
+
+        // Left children are built straight after their parent; right children are linked once their index is known.
+        const auto node_index = static_cast<std::uint32_t>(nodes_.size());
+        if (task.parent != kNoParent && node_index != task.parent + 1) {
+            nodes_[task.parent].first = node_index;
+        }
+        parents_.push_back(task.parent);
+
+        Aabb node_bounds = EmptyAabb();
+        Aabb centroid_bounds = EmptyAabb();
+        const std::span<BuildReference> objects(references.data() + task.begin, task.end - task.begin);
+        for (const BuildReference &reference: objects) {
+            node_bounds.Grow(reference.bounds);
+            centroid_bounds.Grow({reference.centroid, reference.centroid});
+        }
+        nodes_.push_back({node_bounds});
+
+        const std::optional<std::uint32_t> left_count = PartitionObjects(objects, node_bounds, centroid_bounds);
+        if (!left_count.has_value()) {
+            nodes_.back().first = task.begin;
+            nodes_.back().count = task.end - task.begin;
+            for (std::uint32_t position = task.begin; position < task.end; ++position) {
+                object_indices_[position] = references[position].object;
+                object_leaves_[references[position].object] = node_index;
+            }
+            continue;
+        }
+
+        const std::uint32_t middle = task.begin + *left_count;
+        tasks.push_back({middle, task.end, node_index});
+        tasks.push_back({task.begin, middle, node_index});
+    }
+}
+
+void Bvh::UpdateBounds(const std::uint32_t object, const Aabb &bounds) {
+    object_bounds_[object] = bounds;
+    for (std::uint32_t index = object_leaves_[object]; index != kNoParent; index = parents_[index]) {
+        const Aabb refitted = ComputeNodeBounds(nodes_[index], index);
+        // Every node encloses exactly its children, so once one stays the same, so does everything above it.
+        if (refitted == nodes_[index].bounds) {
+            break;
+        }
+        nodes_[index].bounds = refitted;
+    }
+}
+
+void Bvh::Refit(const std::span<const Aabb> bounds) {
+    if (bounds.size() != object_bounds_.size()) {
+        spdlog::error("Cannot refit a BVH of {} objects to {} bounds!", object_bounds_.size(), bounds.size());
+        return;
+    }
+    object_bounds_.assign(bounds.begin(), bounds.end());
+
+    // Children always come after their parent, so walking backwards refits them first.
+    for (std::size_t index = nodes_.size(); index-- > 0;) {
+        nodes_[index].bounds = ComputeNodeBounds(nodes_[index], static_cast<std::uint32_t>(index));
+    }
+}
+
+void Bvh::QueryFrustum(const Frustum &frustum, std::vector<std::uint32_t> &visible) const {
+    visible.clear();
+    if (nodes_.empty()) {
+        return;
+    }
+
+    // Planes a node is completely inside of are not tested again anywhere below it.
+    std::vector<std::pair<std::uint32_t, std::uint8_t>> stack = {{0, kAllPlanes}};
+    while (!stack.empty()) {
+        auto [index, planes] = stack.back();
+        stack.pop_back();
+        const Node &node = nodes_[index];
+
+        bool culled = false;
+        for (std::uint32_t plane_index = 0; plane_index < frustum.planes.size() && planes != 0; ++plane_index) {
+            const std::uint8_t plane_bit = 1u << plane_index;
+            if ((planes & plane_bit) == 0) {
+                continue;
+            }
+            const glm::vec4 &plane = frustum.planes[plane_index];
+            if (PlaneDistance(plane, GetPositiveVertex(node.bounds, plane)) < 0.0f) {
+                culled = true;
+                break;
+            }
+            if (PlaneDistance(plane, GetNegativeVertex(node.bounds, plane)) >= 0.0f) {
+                planes &= ~plane_bit;
+            }
+        }
+        if (culled) {
+            continue;
+        }
+
+        if (!node.IsLeaf()) {
+            stack.emplace_back(node.first, planes);
+            stack.emplace_back(index + 1, planes);
+            continue;
+        }
+        for (std::uint32_t position = node.first; position < node.first + node.count; ++position) {
+            const std::uint32_t object = object_indices_[position];
+            if (planes == 0 || IsInsidePlanes(frustum, object_bounds_[object], planes)) {
+                visible.push_back(object);
+            }
+        }
+    }
+}
+
+void Bvh::QueryBox(const Aabb &box, std::vector<std::uint32_t> &overlapping) const {
+    overlapping.clear();
+    if (nodes_.empty()) {
+        return;
+    }
+
+    std::vector<std::uint32_t> stack = {0};
+    while (!stack.empty()) {
+        const std::uint32_t index = stack.back();
+        stack.pop_back();
+        const Node &node = nodes_[index];
+        if (!Overlaps(node.bounds, box)) {
+            continue;
+        }
+
+        if (!node.IsLeaf()) {
+            stack.push_back(node.first);
+            stack.push_back(index + 1);
+            continue;
+        }
+        for (std::uint32_t position = node.first; position < node.first + node.count; ++position) {
+            const std::uint32_t object = object_indices_[position];
+            if (Overlaps(object_bounds_[object], box)) {
+                overlapping.push_back(object);
+            }
+        }
+    }
+}
+
+std::optional<BvhRayHit> Bvh::Raycast(const glm::vec3 &origin, const glm::vec3 &direction,
+                                      const float max_distance) const {
+    if (nodes_.empty()) {
+        return std::nullopt;
+    }
+
+    const glm::vec3 inverse_direction = 1.0f / direction;
+    const std::optional<float> root_entry = IntersectRay(nodes_[0].bounds, origin, inverse_direction, max_distance);
+    if (!root_entry.has_value()) {
+        return std::nullopt;
+    }
+
+    std::optional<BvhRayHit> closest;
+    float closest_distance = max_distance;
+    // Nodes with where the ray enters them, so ones behind a hit found in the meantime are skipped without a test.
+    std::vector<std::pair<std::uint32_t, float>> stack = {{0, *root_entry}};
+    while (!stack.empty()) {
+        const auto [index, entry] = stack.back();
+        stack.pop_back();
+        if (entry > closest_distance) {
+            continue;
+        }
+        const Node &node = nodes_[index];
+
+        if (node.IsLeaf()) {
+            for (std::uint32_t position = node.first; position < node.first + node.count; ++position) {
+                const std::uint32_t object = object_indices_[position];
+                const std::optional<float> hit = IntersectRay(object_bounds_[object], origin, inverse_direction,
+                                                              closest_distance);
+                if (hit.has_value() && (!closest.has_value() || *hit < closest->distance)) {
+                    closest = BvhRayHit{object, *hit};
+                    closest_distance = *hit;
+                }
+            }
+            continue;
+        }
+
+        const std::optional<float> left_entry = IntersectRay(nodes_[index + 1].bounds, origin, inverse_direction,
+                                                             closest_distance);
+        const std::optional<float> right_entry = IntersectRay(nodes_[node.first].bounds, origin, inverse_direction,
+                                                              closest_distance);
+        // The nearer child goes on top, so a hit inside it can prune the farther one.
+        const bool left_is_nearer = left_entry.has_value() &&
+                                    (!right_entry.has_value() || *left_entry <= *right_entry);
+        if (left_is_nearer) {
+            if (right_entry.has_value()) {
+                stack.emplace_back(node.first, *right_entry);
+            }
+            stack.emplace_back(index + 1, *left_entry);
+        } else {
+            if (left_entry.has_value()) {
+                stack.emplace_back(index + 1, *left_entry);
+            }
+            if (right_entry.has_value()) {
+                stack.emplace_back(node.first, *right_entry);
+            }
+        }
+    }
+    return closest;
+}
+
+std::size_t Bvh::GetNodeCount() const {
+    return nodes_.size();
+}
+
+std::size_t Bvh::GetObjectCount() const {
+    return object_bounds_.size();
+}
+
+Aabb Bvh::ComputeNodeBounds(const Node &node, const std::uint32_t index) const {
+    if (!node.IsLeaf()) {
+        Aabb bounds = nodes_[index + 1].bounds;
+        bounds.Grow(nodes_[node.first].bounds);
+        return bounds;
+    }
+
+    Aabb bounds = EmptyAabb();
+    for (std::uint32_t position = node.first; position < node.first + node.count; ++position) {
+        bounds.Grow(object_bounds_[object_indices_[position]]);
+    }
+    return bounds;
+}
+} // veng
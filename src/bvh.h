@@ -0,0 +1,73 @@
+#pragma once
+
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "frustum_culling.h"
+
+namespace veng {
+struct Aabb {
+    glm::vec3 min{};
+    glm::vec3 max{};
+
+    void Grow(const Aabb &other);
+    [[nodiscard]] glm::vec3 GetCenter() const;
+    [[nodiscard]] float GetSurfaceArea() const;
+    // Smallest axis-aligned box enclosing this one once transformed.
+    [[nodiscard]] Aabb Transformed(const glm::mat4 &transform) const;
+    bool operator==(const Aabb &other) const = default;
+};
+
+struct BvhRayHit {
+    std::uint32_t object = 0;
+    // Where the ray enters the object's bounds, in multiples of the ray direction; zero when it starts inside them.
+    float distance = 0.0f;
+};
+
+// Bounding volume hierarchy over object bounds, built with a binned surface area heuristic. Nodes are flattened
+// depth-first into one array, so a node's left child directly follows it and the objects below any node are
+// contiguous. Objects are identified by their index in the bounds given to Build. Not thread safe while updating.
+class Bvh final {
+public:
+    void Build(std::span<const Aabb> bounds);
+    // Refits only the nodes above the object. The tree keeps the structure it was built with, so queries slow down
+    // as objects drift far from where they were; rebuild once that shows.
+    void UpdateBounds(std::uint32_t object, const Aabb &bounds);
+    // Refits every node to new bounds for the same objects in one bottom-up pass.
+    void Refit(std::span<const Aabb> bounds);
+
+    // Replace the output with the intersecting objects, in no particular order. An object counts as visible under
+    // the same rule CullBoxes uses.
+    void QueryFrustum(const Frustum &frustum, std::vector<std::uint32_t> &visible) const;
+    void QueryBox(const Aabb &box, std::vector<std::uint32_t> &overlapping) const;
+    // The object whose bounds the ray enters first, within max_distance multiples of the direction.
+    [[nodiscard]] std::optional<BvhRayHit> Raycast(const glm::vec3 &origin, const glm::vec3 &direction,
+                                                   float max_distance) const;
+
+    [[nodiscard]] std::size_t GetNodeCount() const;
+    [[nodiscard]] std::size_t GetObjectCount() const;
+
+private:
+    // 32 bytes, two to a cache line.
+    struct Node {
+        Aabb bounds;
+        // Leaves: first entry in object_indices_. Interior nodes: index of the right child.
+        std::uint32_t first = 0;
+        // Zero for interior nodes.
+        std::uint32_t count = 0;
+
+        [[nodiscard]] bool IsLeaf() const { return count != 0; }
+    };
+
+    [[nodiscard]] Aabb ComputeNodeBounds(const Node &node, std::uint32_t index) const;
+
+    std::vector<Node> nodes_;
+    // Objects in leaf order; leaves reference ranges of it.
+    std::vector<std::uint32_t> object_indices_;
+    std::vector<Aabb> object_bounds_;
+    // Kept apart from the nodes so traversal never loads them.
+    std::vector<std::uint32_t> parents_;
+    std::vector<std::uint32_t> object_leaves_;
+};
+} // veng
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "buffer_handle.h"
+#include "spirv_reflection.h"
+#include "texture_handle.h"
+
+namespace veng {
+struct ComputePipelineHandle {
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    // Owned by the layout cache, shared with every pipeline of the same interface.
+    VkPipelineLayout layout = VK_NULL_HANDLE;
+    std::vector<VkDescriptorSetLayout> set_layouts;
+    // What the shader declares, so dispatches can write descriptors of the right type.
+    std::vector<ReflectedBinding> bindings;
+    std::optional<VkPushConstantRange> push_constants;
+
+    [[nodiscard]] bool IsValid() const { return pipeline != VK_NULL_HANDLE; }
+};
+
+// A resource for one descriptor of a dispatch. Buffers go to uniform and storage buffer bindings, images to storage
+// and sampled image bindings. Storage bindings take images from CreateStorageImage; sampled ones also take textures
+// from CreateTexture, read in their own layout, as long as the compute queue is not a separate family.
+struct ComputeBinding {
+    std::uint32_t set = 0;
+    std::uint32_t binding = 0;
+    BufferHandle buffer{};
+    TextureHandle image{};
+};
+} // veng
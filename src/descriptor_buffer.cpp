@@ -0,0 +1,51 @@
+#include "descriptor_buffer.h"
+
+#include <algorithm>
+#include <precomp.h>
+
+namespace veng {
+void DescriptorBufferAllocator::Initialize(const VkDeviceSize capacity, const VkDeviceSize alignment) {
+    capacity_ = capacity;
+    alignment_ = std::max<VkDeviceSize>(alignment, 1);
+    head_ = 0;
+    used_ = 0;
+    free_ranges_.clear();
+}
+
+std::optional<VkDeviceSize> DescriptorBufferAllocator::Allocate(const VkDeviceSize size) {
+    const VkDeviceSize aligned_size = Align(size);
+    if (const auto it = free_ranges_.find(aligned_size); it != free_ranges_.end() && !it->second.empty()) {
+        const VkDeviceSize offset = it->second.back();
+        it->second.pop_back();
+        used_ += aligned_size;
+        return offset;
+    }
+
+    if (aligned_size > capacity_ - head_) {
+        return std::nullopt;
+    }
+
+    const VkDeviceSize offset = head_;
+    head_ += aligned_size;
+    used_ += aligned_size;
+    return offset;
+}
+
+void DescriptorBufferAllocator::Free(const VkDeviceSize offset, const VkDeviceSize size) {
+    const VkDeviceSize aligned_size = Align(size);
+    free_ranges_[aligned_size].push_back(offset);
+    used_ -= aligned_size;
+}
+
+VkDeviceSize DescriptorBufferAllocator::GetUsedSize() const {
+    return used_;
+}
+
+VkDeviceSize DescriptorBufferAllocator::GetCapacity() const {
+    return capacity_;
+}
+
+VkDeviceSize DescriptorBufferAllocator::Align(const VkDeviceSize size) const {
+    return (size + alignment_ - 1) / alignment_ * alignment_;
+}
+} // veng
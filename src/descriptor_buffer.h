@@ -0,0 +1,32 @@
+#pragma once
+
+#include <optional>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+namespace veng {
+// Sub-allocates descriptor set storage out of one VK_EXT_descriptor_buffer buffer. Only the offsets are managed
+// here; the buffer and the descriptor writes belong to the caller. Freed ranges are recycled through per-size free
+// lists, which suits the handful of distinct set layout sizes the engine uses. Not thread safe.
+class DescriptorBufferAllocator final {
+public:
+    void Initialize(VkDeviceSize capacity, VkDeviceSize alignment);
+
+    // Nothing when the buffer is full.
+    [[nodiscard]] std::optional<VkDeviceSize> Allocate(VkDeviceSize size);
+    void Free(VkDeviceSize offset, VkDeviceSize size);
+
+    [[nodiscard]] VkDeviceSize GetUsedSize() const;
+    [[nodiscard]] VkDeviceSize GetCapacity() const;
+
+private:
+    [[nodiscard]] VkDeviceSize Align(VkDeviceSize size) const;
+
+    VkDeviceSize capacity_ = 0;
+    VkDeviceSize alignment_ = 1;
+    VkDeviceSize head_ = 0;
+    VkDeviceSize used_ = 0;
+    std::unordered_map<VkDeviceSize, std::vector<VkDeviceSize>> free_ranges_;
+};
+} // veng
@@ -0,0 +1,82 @@
+#include "dynamic_resolution.h"
+
+#include <algorithm>
+#include <precomp.h>
+
+namespace veng {
+namespace {
+constexpr std::float_t kFrameTimeSmoothing = 0.1f;
+constexpr std::float_t kScaleUpHeadroom = 0.8f;
+// Timestamps are read back MAX_BUFFERED_FRAMES late, so a new scale needs a few frames before it shows up.
+constexpr std::uint32_t kSettleFrames = MAX_BUFFERED_FRAMES + 1;
+}
+
+DynamicResolution::DynamicResolution(const DynamicResolutionSettings &settings) {
+    SetSettings(settings);
+}
+
+void DynamicResolution::SetSettings(const DynamicResolutionSettings &settings) {
+    settings_ = settings;
+    settings_.min_scale = std::clamp(settings_.min_scale, 0.1f, 1.0f);
+    settings_.max_scale = std::clamp(settings_.max_scale, settings_.min_scale, 1.0f);
+    scale_ = settings_.max_scale;
+    smoothed_frame_time_ms_ = 0.0f;
+    frames_since_change_ = 0;
+}
+
+const DynamicResolutionSettings &DynamicResolution::GetSettings() const {
+    return settings_;
+}
+
+std::float_t DynamicResolution::ClampScale(const std::float_t scale) const {
+    return std::clamp(scale, settings_.min_scale, settings_.max_scale);
+}
+
+std::float_t DynamicResolution::Update(const std::float_t gpu_frame_time_ms) {
+    if (!settings_.enabled || gpu_frame_time_ms <= 0.0f) {
+        return scale_;
+    }
+
+    if (smoothed_frame_time_ms_ == 0.0f) {
+        smoothed_frame_time_ms_ = gpu_frame_time_ms;
+    } else {
+        smoothed_frame_time_ms_ += (gpu_frame_time_ms - smoothed_frame_time_ms_) * kFrameTimeSmoothing;
+    }
+
+    if (++frames_since_change_ <= kSettleFrames) {
+        return scale_;
+    }
+
+    const std::float_t step = std::max(settings_.scale_step, 0.01f);
+    std::float_t new_scale = scale_;
+
+    if (smoothed_frame_time_ms_ > settings_.target_frame_time_ms) {
+        // GPU cost follows the pixel count, which grows with the square of the scale.
+        new_scale = scale_ * std::sqrt(settings_.target_frame_time_ms / smoothed_frame_time_ms_);
+        new_scale = std::floor(new_scale / step + 0.001f) * step;
+    } else if (smoothed_frame_time_ms_ < settings_.target_frame_time_ms * kScaleUpHeadroom) {
+        new_scale = std::round((scale_ + step) / step) * step;
+    }
+
+    new_scale = ClampScale(new_scale);
+    if (new_scale != scale_) {
+        scale_ = new_scale;
+        smoothed_frame_time_ms_ = 0.0f;
+        frames_since_change_ = 0;
+    }
+
+    return scale_;
+}
+
+std::float_t DynamicResolution::GetScale() const {
+    return settings_.enabled ? scale_ : 1.0f;
+}
+
+VkExtent2D DynamicResolution::ScaleExtent(const VkExtent2D full_extent) const {
+    const std::float_t scale = GetScale();
+    return {
+        std::max(1u, static_cast<std::uint32_t>(std::round(static_cast<std::float_t>(full_extent.width) * scale))),
+        std::max(1u, static_cast<std::uint32_t>(std::round(static_cast<std::float_t>(full_extent.height) * scale)))
+    };
+}
+} // veng
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+namespace veng {
+struct DynamicResolutionSettings {
+    bool enabled = true;
+    std::float_t min_scale = 0.5f;
+    std::float_t max_scale = 1.0f;
+    std::float_t target_frame_time_ms = 16.6f;
+    std::float_t scale_step = 0.05f;
+};
+
+// Picks the fraction of the swapchain extent the scene is rendered at, based on measured GPU frame times.
+class DynamicResolution final {
+public:
+    explicit DynamicResolution(const DynamicResolutionSettings &settings = {});
+
+    void SetSettings(const DynamicResolutionSettings &settings);
+    [[nodiscard]] const DynamicResolutionSettings &GetSettings() const;
+
+    std::float_t Update(std::float_t gpu_frame_time_ms);
+    [[nodiscard]] std::float_t GetScale() const;
+    [[nodiscard]] VkExtent2D ScaleExtent(VkExtent2D full_extent) const;
+
+private:
+    [[nodiscard]] std::float_t ClampScale(std::float_t scale) const;
+
+    DynamicResolutionSettings settings_;
+    std::float_t scale_ = 1.0f;
+    std::float_t smoothed_frame_time_ms_ = 0.0f;
+    std::uint32_t frames_since_change_ = 0;
+};
+} // veng
@@ -0,0 +1,145 @@
+#include "dynamic_state.h"
+
+#include <precomp.h>
+
+namespace veng {
+namespace {
+VkPrimitiveTopology GetTopologyClass(const VkPrimitiveTopology topology) {
+    switch (topology) {
+        case VK_PRIMITIVE_TOPOLOGY_POINT_LIST:
+            return VK_PRIMITIVE_TOPOLOGY_POINT_LIST;
+        case VK_PRIMITIVE_TOPOLOGY_LINE_LIST:
+        case VK_PRIMITIVE_TOPOLOGY_LINE_STRIP:
+        case VK_PRIMITIVE_TOPOLOGY_LINE_LIST_WITH_ADJACENCY:
+        case VK_PRIMITIVE_TOPOLOGY_LINE_STRIP_WITH_ADJACENCY:
+            return VK_PRIMITIVE_TOPOLOGY_LINE_LIST;
+        case VK_PRIMITIVE_TOPOLOGY_PATCH_LIST:
+            return VK_PRIMITIVE_TOPOLOGY_PATCH_LIST;
+        default:
+            return VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    }
+}
+
+VkColorBlendEquationEXT GetBlendEquation(const VkPipelineColorBlendAttachmentState &state) {
+    VkColorBlendEquationEXT equation = {};
+    equation.srcColorBlendFactor = state.srcColorBlendFactor;
+    equation.dstColorBlendFactor = state.dstColorBlendFactor;
+    equation.colorBlendOp = state.colorBlendOp;
+    equation.srcAlphaBlendFactor = state.srcAlphaBlendFactor;
+    equation.dstAlphaBlendFactor = state.dstAlphaBlendFactor;
+    equation.alphaBlendOp = state.alphaBlendOp;
+    return equation;
+}
+}
+
+std::vector<VkDynamicState> GetDynamicStates(const DynamicStateSupport &support) {
+    std::vector<VkDynamicState> states = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+    if (support.extended_dynamic_state) {
+        states.insert(states.end(), {
+                          VK_DYNAMIC_STATE_CULL_MODE_EXT, VK_DYNAMIC_STATE_FRONT_FACE_EXT,
+                          VK_DYNAMIC_STATE_PRIMITIVE_TOPOLOGY_EXT, VK_DYNAMIC_STATE_DEPTH_TEST_ENABLE_EXT,
+                          VK_DYNAMIC_STATE_DEPTH_WRITE_ENABLE_EXT, VK_DYNAMIC_STATE_DEPTH_COMPARE_OP_EXT
+                      });
+    }
+    if (support.primitive_restart) {
+        states.push_back(VK_DYNAMIC_STATE_PRIMITIVE_RESTART_ENABLE_EXT);
+    }
+    if (support.color_blend) {
+        states.insert(states.end(), {
+                          VK_DYNAMIC_STATE_COLOR_BLEND_ENABLE_EXT, VK_DYNAMIC_STATE_COLOR_BLEND_EQUATION_EXT
+                      });
+    }
+    return states;
+}
+
+PipelineDescription GetPipelineKey(const PipelineDescription &description, const DynamicStateSupport &support) {
+    const PipelineDescription defaults;
+    PipelineDescription key = description;
+    if (support.extended_dynamic_state) {
+        key.cull_mode = defaults.cull_mode;
+        key.front_face = defaults.front_face;
+        key.topology = GetTopologyClass(description.topology);
+        key.depth_test = defaults.depth_test;
+        key.depth_write = defaults.depth_write;
+        key.depth_compare = defaults.depth_compare;
+    }
+    if (support.primitive_restart) {
+        key.primitive_restart = defaults.primitive_restart;
+    }
+    if (support.color_blend) {
+        key.blend_mode = defaults.blend_mode;
+    }
+    return key;
+}
+
+void DynamicStateTracker::Reset() {
+    cull_mode_.reset();
+    front_face_.reset();
+    topology_.reset();
+    depth_test_.reset();
+    depth_write_.reset();
+    depth_compare_.reset();
+    primitive_restart_.reset();
+    blend_mode_.reset();
+}
+
+template <typename T, typename Set>
+void DynamicStateTracker::Update(std::optional<T> &current, const T &value, Set &&set) {
+    if (current == value) {
+        ++skipped_count_;
+        return;
+    }
+
+    set(value);
+    current = value;
+    ++set_count_;
+}
+
+void DynamicStateTracker::Apply(VkCommandBuffer command_buffer, const PipelineDescription &description,
+                                const DynamicStateSupport &support) {
+    if (support.extended_dynamic_state) {
+        Update(cull_mode_, description.cull_mode, [command_buffer](const VkCullModeFlags cull_mode) {
+            vkCmdSetCullModeEXT(command_buffer, cull_mode);
+        });
+        Update(front_face_, description.front_face, [command_buffer](const VkFrontFace front_face) {
+            vkCmdSetFrontFaceEXT(command_buffer, front_face);
+        });
+        Update(topology_, description.topology, [command_buffer](const VkPrimitiveTopology topology) {
+            vkCmdSetPrimitiveTopologyEXT(command_buffer, topology);
+        });
+        Update(depth_test_, description.depth_test, [command_buffer](const bool depth_test) {
+            vkCmdSetDepthTestEnableEXT(command_buffer, depth_test ? VK_TRUE : VK_FALSE);
+        });
+        Update(depth_write_, description.depth_write, [command_buffer](const bool depth_write) {
+            vkCmdSetDepthWriteEnableEXT(command_buffer, depth_write ? VK_TRUE : VK_FALSE);
+        });
+        Update(depth_compare_, description.depth_compare, [command_buffer](const VkCompareOp depth_compare) {
+            vkCmdSetDepthCompareOpEXT(command_buffer, depth_compare);
+        });
+    }
+
+    if (support.primitive_restart) {
+        Update(primitive_restart_, description.primitive_restart, [command_buffer](const bool primitive_restart) {
+            vkCmdSetPrimitiveRestartEnableEXT(command_buffer, primitive_restart ? VK_TRUE : VK_FALSE);
+        });
+    }
+
+    if (support.color_blend) {
+        Update(blend_mode_, description.blend_mode, [command_buffer](const BlendMode blend_mode) {
+            const VkPipelineColorBlendAttachmentState state = GetBlendAttachmentState(blend_mode);
+            const VkBool32 enable = state.blendEnable;
+            const VkColorBlendEquationEXT equation = GetBlendEquation(state);
+            vkCmdSetColorBlendEnableEXT(command_buffer, 0, 1, &enable);
+            vkCmdSetColorBlendEquationEXT(command_buffer, 0, 1, &equation);
+        });
+    }
+}
+
+std::size_t DynamicStateTracker::GetSetCount() const {
+    return set_count_;
+}
+
+std::size_t DynamicStateTracker::GetSkippedCount() const {
+    return skipped_count_;
+}
+} // veng
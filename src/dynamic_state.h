@@ -0,0 +1,53 @@
+#pragma once
+
+#include <optional>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "pipeline_cache.h"
+
+namespace veng {
+// Which pipeline description fields the device lets command buffers set instead of baking them into pipelines.
+struct DynamicStateSupport {
+    // VK_EXT_extended_dynamic_state: cull mode, front face, topology within its class and the depth test.
+    bool extended_dynamic_state = false;
+    // VK_EXT_extended_dynamic_state2: primitive restart.
+    bool primitive_restart = false;
+    // VK_EXT_extended_dynamic_state3: color blend enable and equation.
+    bool color_blend = false;
+};
+
+// Dynamic states every pipeline is created with, viewport and scissor included.
+std::vector<VkDynamicState> GetDynamicStates(const DynamicStateSupport &support);
+
+// Resets the fields that are set per draw, so descriptions differing only in those share one pipeline. Topologies
+// are reduced to their class, which is all extended dynamic state lets a pipeline switch between.
+PipelineDescription GetPipelineKey(const PipelineDescription &description, const DynamicStateSupport &support);
+
+// Records the dynamic state last set on a command buffer so draws only pay for the commands that change something.
+class DynamicStateTracker final {
+public:
+    // Dynamic state is undefined at the start of a command buffer.
+    void Reset();
+    void Apply(VkCommandBuffer command_buffer, const PipelineDescription &description,
+               const DynamicStateSupport &support);
+
+    [[nodiscard]] std::size_t GetSetCount() const;
+    [[nodiscard]] std::size_t GetSkippedCount() const;
+
+private:
+    template <typename T, typename Set>
+    void Update(std::optional<T> &current, const T &value, Set &&set);
+
+    std::optional<VkCullModeFlags> cull_mode_;
+    std::optional<VkFrontFace> front_face_;
+    std::optional<VkPrimitiveTopology> topology_;
+    std::optional<bool> depth_test_;
+    std::optional<bool> depth_write_;
+    std::optional<VkCompareOp> depth_compare_;
+    std::optional<bool> primitive_restart_;
+    std::optional<BlendMode> blend_mode_;
+    std::size_t set_count_ = 0;
+    std::size_t skipped_count_ = 0;
+};
+} // veng
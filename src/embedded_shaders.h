@@ -0,0 +1,15 @@
+#pragma once
+
+#include <span>
+#include <string_view>
+
+namespace veng {
+struct EmbeddedShader {
+    // Source file name without the .spv suffix, e.g. "basic.vert".
+    std::string_view name;
+    std::span<const std::uint32_t> code;
+};
+
+// Defined in the source add_shaders() generates from the compiled SPIR-V.
+std::span<const EmbeddedShader> GetEmbeddedShaders();
+} // veng
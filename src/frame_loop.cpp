@@ -0,0 +1,64 @@
+#include "frame_loop.h"
+
+#include <algorithm>
+#include <precomp.h>
+
+namespace veng {
+FrameLoop::FrameLoop(const FrameLoopSettings &settings) : settings_(settings) {
+    settings_.fixed_step = std::max(settings_.fixed_step, std::chrono::nanoseconds(1));
+    settings_.max_steps_per_frame = std::max(settings_.max_steps_per_frame, 1u);
+}
+
+void FrameLoop::Run(const ContinueFunction &keep_running, const UpdateFunction &update, const RenderFunction &render) {
+    const float step_seconds = GetFixedStepSeconds();
+    Clock::time_point previous_time = Clock::now();
+
+    while (keep_running()) {
+        const Clock::time_point time = Clock::now();
+        const FrameStep frame = Advance(time - previous_time);
+        previous_time = time;
+
+        for (std::uint32_t step = 0; step < frame.steps; ++step) {
+            update(step_seconds);
+        }
+        render(frame.alpha);
+    }
+}
+
+FrameStep FrameLoop::Advance(std::chrono::nanoseconds elapsed) {
+    elapsed = std::max(elapsed, std::chrono::nanoseconds(0));
+    if (elapsed > settings_.max_frame_time) {
+        dropped_time_ += elapsed - settings_.max_frame_time;
+        elapsed = settings_.max_frame_time;
+    }
+    accumulator_ += elapsed;
+
+    FrameStep frame;
+    const std::int64_t due_steps = accumulator_ / settings_.fixed_step;
+    frame.steps = static_cast<std::uint32_t>(std::min<std::int64_t>(due_steps, settings_.max_steps_per_frame));
+    accumulator_ -= settings_.fixed_step * frame.steps;
+    if (frame.steps < due_steps) {
+        // Keeps the partial step, so the interpolation does not jump.
+        const std::chrono::nanoseconds behind = accumulator_ - accumulator_ % settings_.fixed_step;
+        dropped_time_ += behind;
+        accumulator_ -= behind;
+    }
+
+    simulated_steps_ += frame.steps;
+    frame.alpha = static_cast<float>(static_cast<double>(accumulator_.count()) /
+                                     static_cast<double>(settings_.fixed_step.count()));
+    return frame;
+}
+
+float FrameLoop::GetFixedStepSeconds() const {
+    return std::chrono::duration<float>(settings_.fixed_step).count();
+}
+
+std::uint64_t FrameLoop::GetSimulatedSteps() const {
+    return simulated_steps_;
+}
+
+std::chrono::nanoseconds FrameLoop::GetDroppedTime() const {
+    return dropped_time_;
+}
+} // veng
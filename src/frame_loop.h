@@ -0,0 +1,55 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+
+namespace veng {
+struct FrameLoopSettings {
+    std::chrono::nanoseconds fixed_step = std::chrono::nanoseconds(16'666'667);
+    // When the simulation cannot keep up, the time beyond this many steps is dropped and the game slows down, instead
+    // of every frame running more steps than the last.
+    std::uint32_t max_steps_per_frame = 8;
+    // Longer frames, e.g. after a breakpoint or while the window was being dragged, count as this long.
+    std::chrono::nanoseconds max_frame_time = std::chrono::milliseconds(250);
+};
+
+struct FrameStep {
+    // Fixed steps to simulate this frame.
+    std::uint32_t steps = 0;
+    // How far real time is past the last simulation state, in steps, in [0, 1).
+    float alpha = 0.0f;
+};
+
+// Decouples the simulation rate from the render rate. The simulation always advances in fixed steps, so it behaves
+// the same however fast frames are rendered, and rendering blends the last two simulation states by how far real time
+// has moved on since the last step. That puts the image at most one step behind the simulation.
+class FrameLoop final {
+public:
+    using Clock = std::chrono::steady_clock;
+    using ContinueFunction = std::function<bool()>;
+    // Advances the simulation by one step of the given seconds, keeping the state it replaces for interpolation.
+    using UpdateFunction = std::function<void(float step_seconds)>;
+    // Renders the state `alpha` of the way from the previous simulation state to the current one.
+    using RenderFunction = std::function<void(float alpha)>;
+
+    explicit FrameLoop(const FrameLoopSettings &settings = {});
+
+    // Runs frames until `keep_running` returns false. It is called at the start of every frame, e.g. to poll events.
+    void Run(const ContinueFunction &keep_running, const UpdateFunction &update, const RenderFunction &render);
+    // Accounts for `elapsed` real time and returns what the frame has to do. Run feeds it from the clock; feeding it
+    // recorded frame times instead reproduces a run exactly.
+    FrameStep Advance(std::chrono::nanoseconds elapsed);
+
+    [[nodiscard]] float GetFixedStepSeconds() const;
+    [[nodiscard]] std::uint64_t GetSimulatedSteps() const;
+    // Real time that went unsimulated because frames hit the catch-up limits.
+    [[nodiscard]] std::chrono::nanoseconds GetDroppedTime() const;
+
+private:
+    FrameLoopSettings settings_;
+    // Real time not simulated yet, always less than a step between frames.
+    std::chrono::nanoseconds accumulator_{0};
+    std::uint64_t simulated_steps_ = 0;
+    std::chrono::nanoseconds dropped_time_{0};
+};
+} // veng
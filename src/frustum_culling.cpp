@@ -0,0 +1,298 @@
+#include "frustum_culling.h"
+
+#include <bit>
+#include <precomp.h>
+
+#if defined(VENG_SIMD_X86)
+#include <immintrin.h>
+#endif
+
+namespace veng {
+namespace {
+glm::vec4 NormalizePlane(const glm::vec4 &plane) {
+    const float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+    return plane / length;
+}
+
+// Shared by the scalar path and the SIMD tails, so every path computes distances with the same operation order.
+float PlaneDistance(const glm::vec4 &plane, const float x, const float y, const float z) {
+    return plane.x * x + plane.y * y + plane.z * z + plane.w;
+}
+
+bool IsSphereVisible(const Frustum &frustum, const BoundingSpheres &spheres, const std::size_t index) {
+    for (const glm::vec4 &plane: frustum.planes) {
+        const float distance = PlaneDistance(plane, spheres.center_x[index], spheres.center_y[index],
+                                             spheres.center_z[index]);
+        if (distance < -spheres.radius[index]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Only the box corner furthest along the plane normal needs testing.
+bool IsBoxVisible(const Frustum &frustum, const BoundingBoxes &boxes, const std::size_t index) {
+    for (const glm::vec4 &plane: frustum.planes) {
+        const float x = plane.x >= 0.0f ? boxes.max_x[index] : boxes.min_x[index];
+        const float y = plane.y >= 0.0f ? boxes.max_y[index] : boxes.min_y[index];
+        const float z = plane.z >= 0.0f ? boxes.max_z[index] : boxes.min_z[index];
+        if (PlaneDistance(plane, x, y, z) < 0.0f) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void CullSpheresScalar(const Frustum &frustum, const BoundingSpheres &spheres, const std::size_t begin,
+                       std::uint32_t *&output) {
+    for (std::size_t index = begin; index < spheres.Size(); ++index) {
+        if (IsSphereVisible(frustum, spheres, index)) {
+            *output++ = static_cast<std::uint32_t>(index);
+        }
+    }
+}
+
+void CullBoxesScalar(const Frustum &frustum, const BoundingBoxes &boxes, const std::size_t begin,
+                     std::uint32_t *&output) {
+    for (std::size_t index = begin; index < boxes.Size(); ++index) {
+        if (IsBoxVisible(frustum, boxes, index)) {
+            *output++ = static_cast<std::uint32_t>(index);
+        }
+    }
+}
+
+void AppendVisible(std::uint32_t mask, const std::size_t base, std::uint32_t *&output) {
+    while (mask != 0) {
+        *output++ = static_cast<std::uint32_t>(base + std::countr_zero(mask));
+        mask &= mask - 1;
+    }
+}
+
+#if defined(VENG_SIMD_X86)
+// Returns the index the scalar tail has to continue from.
+std::size_t CullSpheresSse(const Frustum &frustum, const BoundingSpheres &spheres, std::uint32_t *&output) {
+    constexpr std::size_t kWidth = 4;
+    const std::size_t batch_end = spheres.Size() / kWidth * kWidth;
+    for (std::size_t base = 0; base < batch_end; base += kWidth) {
+        const __m128 x = _mm_loadu_ps(spheres.center_x.data() + base);
+        const __m128 y = _mm_loadu_ps(spheres.center_y.data() + base);
+        const __m128 z = _mm_loadu_ps(spheres.center_z.data() + base);
+        const __m128 negative_radius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(spheres.radius.data() + base));
+
+        std::uint32_t mask = (1u << kWidth) - 1;
+        for (const glm::vec4 &plane: frustum.planes) {
+            __m128 distance = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.x), x), _mm_mul_ps(_mm_set1_ps(plane.y), y));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane.z), z));
+            distance = _mm_add_ps(distance, _mm_set1_ps(plane.w));
+            mask &= static_cast<std::uint32_t>(_mm_movemask_ps(_mm_cmpge_ps(distance, negative_radius)));
+            if (mask == 0) {
+                break;
+            }
+        }
+        AppendVisible(mask, base, output);
+    }
+    return batch_end;
+}
+
+std::size_t CullBoxesSse(const Frustum &frustum, const BoundingBoxes &boxes, std::uint32_t *&output) {
+    constexpr std::size_t kWidth = 4;
+    const std::size_t batch_end = boxes.Size() / kWidth * kWidth;
+    for (std::size_t base = 0; base < batch_end; base += kWidth) {
+        std::uint32_t mask = (1u << kWidth) - 1;
+        for (const glm::vec4 &plane: frustum.planes) {
+            const __m128 x = _mm_loadu_ps((plane.x >= 0.0f ? boxes.max_x : boxes.min_x).data() + base);
+            const __m128 y = _mm_loadu_ps((plane.y >= 0.0f ? boxes.max_y : boxes.min_y).data() + base);
+            const __m128 z = _mm_loadu_ps((plane.z >= 0.0f ? boxes.max_z : boxes.min_z).data() + base);
+
+            __m128 distance = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.x), x), _mm_mul_ps(_mm_set1_ps(plane.y), y));
+            distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane.z), z));
+            distance = _mm_add_ps(distance, _mm_set1_ps(plane.w));
+            mask &= static_cast<std::uint32_t>(_mm_movemask_ps(_mm_cmpge_ps(distance, _mm_setzero_ps())));
+            if (mask == 0) {
+                break;
+            }
+        }
+        AppendVisible(mask, base, output);
+    }
+    return batch_end;
+}
+
+VENG_TARGET_AVX2 std::size_t CullSpheresAvx2(const Frustum &frustum, const BoundingSpheres &spheres,
+                                             std::uint32_t *&output) {
+    constexpr std::size_t kWidth = 8;
+    const std::size_t batch_end = spheres.Size() / kWidth * kWidth;
+    for (std::size_t base = 0; base < batch_end; base += kWidth) {
+        const __m256 x = _mm256_loadu_ps(spheres.center_x.data() + base);
+        const __m256 y = _mm256_loadu_ps(spheres.center_y.data() + base);
+        const __m256 z = _mm256_loadu_ps(spheres.center_z.data() + base);
+        const __m256 negative_radius = _mm256_sub_ps(_mm256_setzero_ps(),
+                                                     _mm256_loadu_ps(spheres.radius.data() + base));
+
+        std::uint32_t mask = (1u << kWidth) - 1;
+        for (const glm::vec4 &plane: frustum.planes) {
+            __m256 distance = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.x), x),
+                                            _mm256_mul_ps(_mm256_set1_ps(plane.y), y));
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(plane.z), z));
+            distance = _mm256_add_ps(distance, _mm256_set1_ps(plane.w));
+            mask &= static_cast<std::uint32_t>(_mm256_movemask_ps(
+                _mm256_cmp_ps(distance, negative_radius, _CMP_GE_OQ)));
+            if (mask == 0) {
+                break;
+            }
+        }
+        AppendVisible(mask, base, output);
+    }
+    return batch_end;
+}
+
+VENG_TARGET_AVX2 std::size_t CullBoxesAvx2(const Frustum &frustum, const BoundingBoxes &boxes,
+                                           std::uint32_t *&output) {
+    constexpr std::size_t kWidth = 8;
+    const std::size_t batch_end = boxes.Size() / kWidth * kWidth;
+    for (std::size_t base = 0; base < batch_end; base += kWidth) {
+        std::uint32_t mask = (1u << kWidth) - 1;
+        for (const glm::vec4 &plane: frustum.planes) {
+            const __m256 x = _mm256_loadu_ps((plane.x >= 0.0f ? boxes.max_x : boxes.min_x).data() + base);
+            const __m256 y = _mm256_loadu_ps((plane.y >= 0.0f ? boxes.max_y : boxes.min_y).data() + base);
+            const __m256 z = _mm256_loadu_ps((plane.z >= 0.0f ? boxes.max_z : boxes.min_z).data() + base);
+
+            __m256 distance = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.x), x),
+                                            _mm256_mul_ps(_mm256_set1_ps(plane.y), y));
+            distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(plane.z), z));
+            distance = _mm256_add_ps(distance, _mm256_set1_ps(plane.w));
+            mask &= static_cast<std::uint32_t>(_mm256_movemask_ps(
+                _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_GE_OQ)));
+            if (mask == 0) {
+                break;
+            }
+        }
+        AppendVisible(mask, base, output);
+    }
+    return batch_end;
+}
+#endif
+}
+
+Frustum Frustum::FromViewProjection(const glm::mat4 &view, const glm::mat4 &proj) {
+    const glm::mat4 view_proj = proj * view;
+    const auto row = [&view_proj](const int index) {
+        return glm::vec4(view_proj[0][index], view_proj[1][index], view_proj[2][index], view_proj[3][index]);
+    };
+
+    Frustum frustum;
+    frustum.planes[0] = NormalizePlane(row(3) + row(0));
+    frustum.planes[1] = NormalizePlane(row(3) - row(0));
+    frustum.planes[2] = NormalizePlane(row(3) + row(1));
+    frustum.planes[3] = NormalizePlane(row(3) - row(1));
+    frustum.planes[4] = NormalizePlane(row(2));
+    frustum.planes[5] = NormalizePlane(row(3) - row(2));
+    return frustum;
+}
+
+void BoundingSpheres::Add(const glm::vec3 &center, const float sphere_radius) {
+    center_x.push_back(center.x);
+    center_y.push_back(center.y);
+    center_z.push_back(center.z);
+    radius.push_back(sphere_radius);
+}
+
+void BoundingSpheres::Reserve(const std::size_t count) {
+    center_x.reserve(count);
+    center_y.reserve(count);
+    center_z.reserve(count);
+    radius.reserve(count);
+}
+
+void BoundingSpheres::Clear() {
+    center_x.clear();
+    center_y.clear();
+    center_z.clear();
+    radius.clear();
+}
+
+std::size_t BoundingSpheres::Size() const {
+    return radius.size();
+}
+
+void BoundingBoxes::Add(const glm::vec3 &min, const glm::vec3 &max) {
+    min_x.push_back(min.x);
+    min_y.push_back(min.y);
+    min_z.push_back(min.z);
+    max_x.push_back(max.x);
+    max_y.push_back(max.y);
+    max_z.push_back(max.z);
+}
+
+void BoundingBoxes::Reserve(const std::size_t count) {
+    min_x.reserve(count);
+    min_y.reserve(count);
+    min_z.reserve(count);
+    max_x.reserve(count);
+    max_y.reserve(count);
+    max_z.reserve(count);
+}
+
+void BoundingBoxes::Clear() {
+    min_x.clear();
+    min_y.clear();
+    min_z.clear();
+    max_x.clear();
+    max_y.clear();
+    max_z.clear();
+}
+
+std::size_t BoundingBoxes::Size() const {
+    return min_x.size();
+}
+
+void CullSpheres(const Frustum &frustum, const BoundingSpheres &spheres, std::vector<std::uint32_t> &visible,
+                 const SimdPath path) {
+    // Sized for the worst case up front so the batches can write without bounds checks.
+    visible.resize(spheres.Size());
+    std::uint32_t *output = visible.data();
+
+    std::size_t tail_begin = 0;
+#if defined(VENG_SIMD_X86)
+    switch (GetSupportedSimdPath(path)) {
+        case SimdPath::Avx2:
+            tail_begin = CullSpheresAvx2(frustum, spheres, output);
+            break;
+        case SimdPath::Sse:
+            tail_begin = CullSpheresSse(frustum, spheres, output);
+            break;
+        case SimdPath::Scalar:
+            break;
+    }
+#else
+    static_cast<void>(path);
+#endif
+    CullSpheresScalar(frustum, spheres, tail_begin, output);
+
+    visible.resize(output - visible.data());
+}
+
+void CullBoxes(const Frustum &frustum, const BoundingBoxes &boxes, std::vector<std::uint32_t> &visible,
+               const SimdPath path) {
+    visible.resize(boxes.Size());
+    std::uint32_t *output = visible.data();
+
+    std::size_t tail_begin = 0;
+#if defined(VENG_SIMD_X86)
+    switch (GetSupportedSimdPath(path)) {
+        case SimdPath::Avx2:
+            tail_begin = CullBoxesAvx2(frustum, boxes, output);
+            break;
+        case SimdPath::Sse:
+            tail_begin = CullBoxesSse(frustum, boxes, output);
+            break;
+        case SimdPath::Scalar:
+            break;
+    }
+#else
+    static_cast<void>(path);
+#endif
+    CullBoxesScalar(frustum, boxes, tail_begin, output);
+
+    visible.resize(output - visible.data());
+}
+} // veng
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <vector>
+
+#include "simd.h"
+
+namespace veng {
+// Planes as (normal, distance) with normals pointing inwards and normalized, so signed distances are in world units.
+struct Frustum {
+    std::array<glm::vec4, 6> planes{};
+
+    // Uses Vulkan's clip volume (0 <= z <= w), so the planes match what the rasterizer clips against.
+    static Frustum FromViewProjection(const glm::mat4 &view, const glm::mat4 &proj);
+};
+
+// Structure-of-arrays bounds, so batches of objects load straight into SIMD registers.
+struct BoundingSpheres {
+    std::vector<float> center_x;
+    std::vector<float> center_y;
+    std::vector<float> center_z;
+    std::vector<float> radius;
+
+    void Add(const glm::vec3 &center, float sphere_radius);
+    void Reserve(std::size_t count);
+    void Clear();
+    [[nodiscard]] std::size_t Size() const;
+};
+
+struct BoundingBoxes {
+    std::vector<float> min_x;
+    std::vector<float> min_y;
+    std::vector<float> min_z;
+    std::vector<float> max_x;
+    std::vector<float> max_y;
+    std::vector<float> max_z;
+
+    void Add(const glm::vec3 &min, const glm::vec3 &max);
+    void Reserve(std::size_t count);
+    void Clear();
+    [[nodiscard]] std::size_t Size() const;
+};
+
+// Replaces `visible` with the ascending indices of the objects intersecting the frustum; objects touching a plane
+// count as visible. Paths the CPU or build does not support fall back to the widest one that is.
+void CullSpheres(const Frustum &frustum, const BoundingSpheres &spheres, std::vector<std::uint32_t> &visible,
+                 SimdPath path = GetBestSimdPath());
+void CullBoxes(const Frustum &frustum, const BoundingBoxes &boxes, std::vector<std::uint32_t> &visible,
+               SimdPath path = GetBestSimdPath());
+} // veng
@@ -14,6 +14,12 @@ namespace veng {
             std::cout << "Failed to create GLFW window" << std::endl;
             std::exit(EXIT_FAILURE);
         }
+
+        glm::ivec2 frame_buffer_size;
+        glfwGetFramebufferSize(window_, &frame_buffer_size.x, &frame_buffer_size.y);
+        frame_buffer_size_.store(frame_buffer_size);
+        glfwSetWindowUserPointer(window_, this);
+        glfwSetFramebufferSizeCallback(window_, &GLFW_Window::OnFrameBufferResized);
     }
 
     GLFW_Window::~GLFW_Window() {
@@ -27,9 +33,7 @@ namespace veng {
     }
 
     glm::ivec2 GLFW_Window::GetFrameBufferSize() const {
-        glm::ivec2 size;
-        glfwGetFramebufferSize(window_, &size.x, &size.y);
-        return size;
+        return frame_buffer_size_.load();
     }
 
     bool GLFW_Window::ShouldClose() const {
@@ -40,6 +44,11 @@ namespace veng {
         return window_;
     }
 
+    void GLFW_Window::OnFrameBufferResized(GLFWwindow *window, const std::int32_t width, const std::int32_t height) {
+        auto *owner = static_cast<GLFW_Window *>(glfwGetWindowUserPointer(window));
+        owner->frame_buffer_size_.store(glm::ivec2(width, height));
+    }
+
     bool GLFW_Window::TryMoveToMonitor(const std::uint16_t monitor) const {
         if (const gsl::span<GLFWmonitor *> monitors = GetMonitors(); monitor < monitors.size()) {
             MoveWindowToMonitor(window_, monitors[monitor]);
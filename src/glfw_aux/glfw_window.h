@@ -1,4 +1,6 @@
 #pragma once
+#include <atomic>
+
 #include "GLFW/glfw3.h"
 
 struct GLFWwindow;
@@ -12,6 +14,7 @@ namespace veng {
 
         glm::ivec2 GetWindowSize() const;
 
+        // Safe to call from any thread, e.g. the render thread; updated whenever events are polled.
         glm::ivec2 GetFrameBufferSize() const;
 
         bool ShouldClose() const;
@@ -21,6 +24,10 @@ namespace veng {
         bool TryMoveToMonitor(std::uint16_t monitor) const;
 
     private:
+        static void OnFrameBufferResized(GLFWwindow *window, std::int32_t width, std::int32_t height);
+
         GLFWwindow *window_;
+        // GLFW only answers size queries on the main thread.
+        std::atomic<glm::ivec2> frame_buffer_size_;
     };
 }
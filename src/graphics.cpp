@@ -4,6 +4,7 @@
 
 #include "graphics.h"
 
+#include <algorithm>
 #include <iostream>
 #include <precomp.h>
 #include <cstring>
@@ -15,6 +16,7 @@
 #include "uniform_transformations.h"
 #include "utilities.h"
 #include "vertex.h"
+#include "vulkan_extensions.h"
 
 #pragma region VK_FUNCITON_EXT_IMPL
 
@@ -231,6 +233,16 @@ Graphics::QueueFamilyIndices Graphics::FindQueueFamilies(VkPhysicalDevice device
         }
     }
 
+    indices.compute_family = indices.graphics_family;
+    if (settings_.use_async_compute) {
+        const auto compute_family_it = std::ranges::find_if(queue_families, [](const VkQueueFamilyProperties &props) {
+            return (props.queueFlags & VK_QUEUE_COMPUTE_BIT) && !(props.queueFlags & VK_QUEUE_GRAPHICS_BIT);
+        });
+        if (compute_family_it != queue_families.end()) {
+            indices.compute_family = compute_family_it - queue_families.begin();
+        }
+    }
+
     return indices;
 }
 
@@ -293,6 +305,31 @@ void Graphics::PickPhysicalDevice() {
     physical_device_ = devices[0];
 }
 
+void Graphics::ChooseSampleCount() {
+    VkPhysicalDeviceProperties device_properties = {};
+    vkGetPhysicalDeviceProperties(physical_device_, &device_properties);
+
+    const VkSampleCountFlags supported_counts = device_properties.limits.framebufferColorSampleCounts &
+                                                device_properties.limits.framebufferDepthSampleCounts;
+
+    constexpr std::array candidates = {
+        VK_SAMPLE_COUNT_8_BIT, VK_SAMPLE_COUNT_4_BIT, VK_SAMPLE_COUNT_2_BIT
+    };
+
+    msaa_samples_ = VK_SAMPLE_COUNT_1_BIT;
+    for (const VkSampleCountFlagBits candidate: candidates) {
+        if (candidate <= settings_.msaa_samples && (supported_counts & candidate)) {
+            msaa_samples_ = candidate;
+            break;
+        }
+    }
+
+    if (msaa_samples_ != settings_.msaa_samples) {
+        spdlog::warn("Requested {}x MSAA, using {}x", static_cast<std::uint32_t>(settings_.msaa_samples),
+                     static_cast<std::uint32_t>(msaa_samples_));
+    }
+}
+
 std::vector<VkPhysicalDevice> Graphics::GetPhysicalDevices() const {
     std::uint32_t device_count = 0;
     vkEnumeratePhysicalDevices(instance_, &device_count, nullptr);
@@ -315,7 +352,7 @@ void Graphics::CreateLogicalDeviceAndQueues() {
     }
 
     std::set<std::uint32_t> unique_queue_families = {
-        indices.graphics_family.value(), indices.present_family.value()
+        indices.graphics_family.value(), indices.present_family.value(), indices.compute_family.value()
     };
 
     std::float_t queue_priorities = 1.0f;
@@ -336,13 +373,158 @@ void Graphics::CreateLogicalDeviceAndQueues() {
     required_features.depthBounds = true;
     required_features.depthClamp = true;
 
+    VkPhysicalDeviceSynchronization2FeaturesKHR synchronization2_features = {};
+    synchronization2_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR;
+    synchronization2_features.synchronization2 = VK_TRUE;
+    // Core in Vulkan 1.2 and supported by every 1.2 device; orders compute work after the previous frame's draws.
+    VkPhysicalDeviceTimelineSemaphoreFeatures timeline_semaphore_features = {};
+    timeline_semaphore_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+    timeline_semaphore_features.timelineSemaphore = VK_TRUE;
+
+    std::vector<gsl::czstring> enabled_extensions(required_device_extensions_.begin(),
+                                                  required_device_extensions_.end());
+    const std::vector<VkExtensionProperties> available_extensions = GetDeviceAvailableExtensions(physical_device_);
+    const auto is_available = [&available_extensions](const gsl::czstring extension_name) {
+        return IsDeviceExtensionWithinList(available_extensions, extension_name);
+    };
+    const auto chain = [](void *&head, auto &features) {
+        features.pNext = head;
+        head = &features;
+    };
+
+    VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT pipeline_library_features = {};
+    pipeline_library_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT;
+    VkPhysicalDeviceExtendedDynamicStateFeaturesEXT dynamic_state_features = {};
+    dynamic_state_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_FEATURES_EXT;
+    VkPhysicalDeviceExtendedDynamicState2FeaturesEXT dynamic_state2_features = {};
+    dynamic_state2_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_2_FEATURES_EXT;
+    VkPhysicalDeviceExtendedDynamicState3FeaturesEXT dynamic_state3_features = {};
+    dynamic_state3_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTENDED_DYNAMIC_STATE_3_FEATURES_EXT;
+
+    VkPhysicalDeviceShaderObjectFeaturesEXT shader_object_features = {};
+    shader_object_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_OBJECT_FEATURES_EXT;
+    VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamic_rendering_features = {};
+    dynamic_rendering_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+
+    VkPhysicalDeviceDescriptorBufferFeaturesEXT descriptor_buffer_features = {};
+    descriptor_buffer_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT;
+    VkPhysicalDeviceBufferDeviceAddressFeatures buffer_device_address_features = {};
+    buffer_device_address_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_BUFFER_DEVICE_ADDRESS_FEATURES;
+
+    // Optional features are queried in one go; only the ones in use are chained into the device afterwards.
+    void *supported_chain = nullptr;
+    if (settings_.use_pipeline_libraries && is_available(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME) &&
+        is_available(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME)) {
+        chain(supported_chain, pipeline_library_features);
+    }
+    if (settings_.use_extended_dynamic_state) {
+        if (is_available(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME)) {
+            chain(supported_chain, dynamic_state_features);
+        }
+        if (is_available(VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME)) {
+            chain(supported_chain, dynamic_state2_features);
+        }
+        if (is_available(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME)) {
+            chain(supported_chain, dynamic_state3_features);
+        }
+    }
+
+    // Shader objects can only draw into dynamic rendering instances, never into render pass objects.
+    if (settings_.render_backend == RenderBackend::ShaderObjects &&
+        is_available(VK_EXT_SHADER_OBJECT_EXTENSION_NAME) && is_available(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME)) {
+        chain(supported_chain, shader_object_features);
+        chain(supported_chain, dynamic_rendering_features);
+    }
+
+    // Descriptor buffers are located through their device address.
+    if (settings_.use_descriptor_buffers && is_available(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME)) {
+        chain(supported_chain, descriptor_buffer_features);
+        chain(supported_chain, buffer_device_address_features);
+    }
+
+    if (supported_chain != nullptr) {
+        VkPhysicalDeviceFeatures2 supported_features = {};
+        supported_features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+        supported_features.pNext = supported_chain;
+        vkGetPhysicalDeviceFeatures2(physical_device_, &supported_features);
+    }
+
+    pipeline_library_supported_ = pipeline_library_features.graphicsPipelineLibrary == VK_TRUE;
+    dynamic_state_support_.extended_dynamic_state = dynamic_state_features.extendedDynamicState == VK_TRUE;
+    dynamic_state_support_.primitive_restart = dynamic_state2_features.extendedDynamicState2 == VK_TRUE;
+    dynamic_state_support_.color_blend = dynamic_state3_features.extendedDynamicState3ColorBlendEnable == VK_TRUE &&
+                                         dynamic_state3_features.extendedDynamicState3ColorBlendEquation == VK_TRUE;
+
+    if (settings_.render_backend == RenderBackend::ShaderObjects) {
+        if (shader_object_features.shaderObject == VK_TRUE && dynamic_rendering_features.dynamicRendering == VK_TRUE) {
+            render_backend_ = RenderBackend::ShaderObjects;
+        } else {
+            spdlog::warn("Shader objects are not supported, rendering with pipelines");
+        }
+    }
+
+    descriptor_buffer_supported_ = descriptor_buffer_features.descriptorBuffer == VK_TRUE &&
+                                   buffer_device_address_features.bufferDeviceAddress == VK_TRUE;
+    if (descriptor_buffer_supported_) {
+        set_layout_flags_ = VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+        pipeline_create_flags_ = VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+
+        descriptor_buffer_properties_.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT;
+        VkPhysicalDeviceProperties2 properties = {};
+        properties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+        properties.pNext = &descriptor_buffer_properties_;
+        vkGetPhysicalDeviceProperties2(physical_device_, &properties);
+        descriptor_buffer_properties_.pNext = nullptr;
+        spdlog::info("Writing descriptors into descriptor buffers");
+    } else if (settings_.use_descriptor_buffers) {
+        spdlog::warn("Descriptor buffers are not supported, allocating descriptor sets from pools");
+    }
+
+    // The queried structures now hold exactly the supported features, so enabling them as they are is valid.
+    void *enabled_chain = nullptr;
+    if (pipeline_library_supported_) {
+        enabled_extensions.push_back(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME);
+        enabled_extensions.push_back(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+        chain(enabled_chain, pipeline_library_features);
+    }
+    if (dynamic_state_support_.extended_dynamic_state) {
+        enabled_extensions.push_back(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME);
+        chain(enabled_chain, dynamic_state_features);
+    }
+    if (dynamic_state_support_.primitive_restart) {
+        enabled_extensions.push_back(VK_EXT_EXTENDED_DYNAMIC_STATE_2_EXTENSION_NAME);
+        chain(enabled_chain, dynamic_state2_features);
+    }
+    if (dynamic_state_support_.color_blend) {
+        enabled_extensions.push_back(VK_EXT_EXTENDED_DYNAMIC_STATE_3_EXTENSION_NAME);
+        chain(enabled_chain, dynamic_state3_features);
+    }
+    if (render_backend_ == RenderBackend::ShaderObjects) {
+        enabled_extensions.push_back(VK_EXT_SHADER_OBJECT_EXTENSION_NAME);
+        enabled_extensions.push_back(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+        chain(enabled_chain, shader_object_features);
+        chain(enabled_chain, dynamic_rendering_features);
+    }
+    if (descriptor_buffer_supported_) {
+        // Capture and replay support costs performance and is only meant for tools.
+        descriptor_buffer_features.descriptorBufferCaptureReplay = VK_FALSE;
+        buffer_device_address_features.bufferDeviceAddressCaptureReplay = VK_FALSE;
+        buffer_device_address_features.bufferDeviceAddressMultiDevice = VK_FALSE;
+        enabled_extensions.push_back(VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME);
+        chain(enabled_chain, descriptor_buffer_features);
+        chain(enabled_chain, buffer_device_address_features);
+    }
+    timeline_semaphore_features.pNext = enabled_chain;
+    synchronization2_features.pNext = &timeline_semaphore_features;
+
     VkDeviceCreateInfo create_info = {};
     create_info.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    create_info.pNext = &synchronization2_features;
     create_info.queueCreateInfoCount = queue_create_infos.size();
     create_info.pQueueCreateInfos = queue_create_infos.data();
     create_info.pEnabledFeatures = &required_features;
-    create_info.enabledExtensionCount = required_device_extensions_.size();
-    create_info.ppEnabledExtensionNames = required_device_extensions_.data();
+    create_info.enabledExtensionCount = enabled_extensions.size();
+    create_info.ppEnabledExtensionNames = enabled_extensions.data();
     create_info.enabledLayerCount = 0;
 
     if (vkCreateDevice(physical_device_, &create_info, nullptr, &device_) != VK_SUCCESS) {
@@ -350,8 +532,16 @@ void Graphics::CreateLogicalDeviceAndQueues() {
         std::exit(EXIT_FAILURE);
     }
 
+    LoadDeviceExtensionFunctions(device_);
+
     vkGetDeviceQueue(device_, indices.graphics_family.value(), 0, &graphics_queue_);
     vkGetDeviceQueue(device_, indices.present_family.value(), 0, &present_queue_);
+    vkGetDeviceQueue(device_, indices.compute_family.value(), 0, &compute_queue_);
+    graphics_family_ = indices.graphics_family.value();
+    compute_family_ = indices.compute_family.value();
+    if (compute_family_ != graphics_family_) {
+        spdlog::info("Dispatching compute work on async compute queue family {}", compute_family_);
+    }
 }
 
 #pragma endregion
@@ -424,6 +614,25 @@ std::uint32_t Graphics::ChooseImageCount(const VkSurfaceCapabilitiesKHR &capabil
     return image_count;
 }
 
+void Graphics::ChooseUpscaleMethod(const VkSurfaceCapabilitiesKHR &capabilities) {
+    // The scene target shares the surface format, so one query covers both ends of the upscale.
+    VkFormatProperties format_properties = {};
+    vkGetPhysicalDeviceFormatProperties(physical_device_, surface_format_.format, &format_properties);
+    const VkFormatFeatureFlags features = format_properties.optimalTilingFeatures;
+
+    upscale_filter_ = (features & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT) != 0
+                          ? VK_FILTER_LINEAR
+                          : VK_FILTER_NEAREST;
+    blit_upscale_ = (features & VK_FORMAT_FEATURE_BLIT_SRC_BIT) != 0 &&
+                    (features & VK_FORMAT_FEATURE_BLIT_DST_BIT) != 0 &&
+                    (capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT) != 0;
+
+    if (!blit_upscale_ && (features & VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT) == 0) {
+        spdlog::error("The surface format can neither be blitted nor sampled to upscale the scene!");
+        std::exit(EXIT_FAILURE);
+    }
+}
+
 
 void Graphics::CreateSwapChain() {
     SwapChainSupportDetails properties = FindSwapChainSupport(physical_device_);
@@ -431,6 +640,8 @@ void Graphics::CreateSwapChain() {
     surface_format_ = ChooseSwapchainSurfaceFormat(properties.formats);
     present_mode_ = ChooseSwapchainPresentMode(properties.present_modes);
     extent_ = ChooseSwapchainExtent(properties.capabilities);
+    render_extent_ = dynamic_resolution_.ScaleExtent(extent_);
+    ChooseUpscaleMethod(properties.capabilities);
 
     std::uint32_t image_count = ChooseImageCount(properties.capabilities);
 
@@ -443,6 +654,9 @@ void Graphics::CreateSwapChain() {
     create_info.imageExtent = extent_;
     create_info.imageArrayLayers = 1;
     create_info.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    if (blit_upscale_) {
+        create_info.imageUsage |= VK_IMAGE_USAGE_TRANSFER_DST_BIT;
+    }
     create_info.presentMode = present_mode_;
     create_info.preTransform = properties.capabilities.currentTransform;
     create_info.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
@@ -474,6 +688,19 @@ void Graphics::CreateSwapChain() {
 
     swap_chain_images_.resize(actual_image_count);
     vkGetSwapchainImagesKHR(device_, swap_chain_, &actual_image_count, swap_chain_images_.data());
+
+    // Presentation can still be waiting on the semaphore after the frame's fence has signaled, so it belongs to the
+    // image: it is only signaled again once that image has been presented and acquired anew.
+    render_finished_semaphores_.resize(actual_image_count);
+    for (VkSemaphore &semaphore: render_finished_semaphores_) {
+        VkSemaphoreCreateInfo semaphore_create_info = {};
+        semaphore_create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+        if (vkCreateSemaphore(device_, &semaphore_create_info, nullptr, &semaphore) != VK_SUCCESS) {
+            spdlog::error("Failed to create semaphore!");
+            std::exit(EXIT_FAILURE);
+        }
+    }
 }
 
 VkImageView Graphics::CreateImageView(VkImage image, VkFormat format, VkImageAspectFlags aspect_flags) const {
@@ -516,17 +743,13 @@ void Graphics::CreateImageViews() {
 
 #pragma region GRAPHICS_PIPELINE
 
-VkShaderModule Graphics::CreateShaderModule(gsl::span<std::uint8_t> buffer) const {
-    if (buffer.empty()) {
-        return VK_NULL_HANDLE;
-    }
-
+VkShaderModule Graphics::CreateShaderModule(const std::span<const std::uint32_t> code) const {
     VkShaderModule shader_module;
 
     VkShaderModuleCreateInfo create_info = {};
     create_info.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
-    create_info.codeSize = buffer.size();
-    create_info.pCode = reinterpret_cast<std::uint32_t *>(buffer.data());
+    create_info.codeSize = code.size_bytes();
+    create_info.pCode = code.data();
 
     if (vkCreateShaderModule(device_, &create_info, nullptr, &shader_module) != VK_SUCCESS) {
         return VK_NULL_HANDLE;
@@ -535,73 +758,164 @@ VkShaderModule Graphics::CreateShaderModule(gsl::span<std::uint8_t> buffer) cons
     return shader_module;
 }
 
+std::optional<ShaderReflection> Graphics::ReflectPipeline(const PipelineDescription &description) const {
+    const ShaderCode vertex_code = shader_registry_.Find(description.vertex_shader);
+    const ShaderCode fragment_code = shader_registry_.Find(description.fragment_shader);
+
+    std::optional<ShaderReflection> reflection = ReflectShader(vertex_code.words);
+    const std::optional<ShaderReflection> fragment_reflection = ReflectShader(fragment_code.words);
+    if (!reflection.has_value() || !fragment_reflection.has_value()) {
+        spdlog::error("Failed to reflect shaders {} / {}!", description.vertex_shader, description.fragment_shader);
+        return std::nullopt;
+    }
+
+    reflection->Merge(fragment_reflection.value());
+    return reflection;
+}
+
 void Graphics::CreateGraphicsPipeline() {
-    std::vector<uint8_t> basic_vertex_data = ReadFile("./basic.vert.spv");
-    VkShaderModule vertex_shader_module = CreateShaderModule(basic_vertex_data);
+    const std::optional<ShaderReflection> reflection = ReflectPipeline(PipelineDescription{});
+    if (reflection.has_value()) {
+        pipeline_layout_ = layout_cache_.GetPipelineLayout(reflection.value(), set_layout_flags_);
+    }
+
+    if (pipeline_layout_ == VK_NULL_HANDLE) {
+        spdlog::error("failed to create pipeline layout!");
+        exit(EXIT_FAILURE);
+    }
+
+    push_constant_stages_ = reflection->push_constants.has_value() ? reflection->push_constants->stageFlags : 0;
+
+    // Vulkan pipeline caches are internally synchronized, so every compile thread shares this one.
+    VkPipelineCacheCreateInfo pipeline_cache_create_info = {};
+    pipeline_cache_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+
+    if (vkCreatePipelineCache(device_, &pipeline_cache_create_info, nullptr, &vulkan_pipeline_cache_) != VK_SUCCESS) {
+        spdlog::warn("Failed to create pipeline cache, compiling without one");
+        vulkan_pipeline_cache_ = VK_NULL_HANDLE;
+    }
+
+    if (pipeline_library_supported_) {
+        pipeline_library_.Initialize(device_);
+        if (settings_.optimize_linked_pipelines) {
+            pipeline_cache_.SetOptimizer([this](const PipelineDescription &description) {
+                return CreatePipeline(description, true);
+            }, pipeline_workers_);
+        }
+        spdlog::info("Linking pipelines from graphics pipeline libraries");
+    }
+
+    // Shader objects replace the default pipeline; pipelines are still created if asked for explicitly.
+    if (render_backend_ == RenderBackend::ShaderObjects) {
+        spdlog::info("Rendering with shader objects");
+        return;
+    }
+
+    graphics_pipeline_ = GetPipeline(PipelineDescription{});
+    if (graphics_pipeline_ == VK_NULL_HANDLE) {
+        exit(EXIT_FAILURE);
+    }
+}
+
+VkPipeline Graphics::CreatePipeline(const PipelineDescription &description, const bool optimize) const {
+    const ShaderCode vertex_code = shader_registry_.Find(description.vertex_shader);
+    const ShaderCode fragment_code = shader_registry_.Find(description.fragment_shader);
+    if (vertex_code.IsEmpty() || fragment_code.IsEmpty()) {
+        spdlog::error("Failed to find shaders {} / {}!", description.vertex_shader, description.fragment_shader);
+        return VK_NULL_HANDLE;
+    }
+
+    const std::optional<ShaderReflection> reflection = ReflectPipeline(description);
+    if (!reflection.has_value()) {
+        return VK_NULL_HANDLE;
+    }
+
+    VkPipelineLayout pipeline_layout = layout_cache_.GetPipelineLayout(reflection.value(), set_layout_flags_);
+    if (pipeline_layout == VK_NULL_HANDLE) {
+        return VK_NULL_HANDLE;
+    }
+
+    const VertexLayout vertex_layout = description.vertex_layout.attributes.empty()
+                                           ? VertexLayout::FromReflection(reflection.value())
+                                           : description.vertex_layout;
+    // Matrix inputs are reflected per column, so every location they span has to be provided.
+    for (const ReflectedVertexInput &input: reflection->vertex_inputs) {
+        if (input.format == VK_FORMAT_UNDEFINED) {
+            spdlog::error("{} reads vertex input location {} with a type vertex layouts cannot describe!",
+                          description.vertex_shader, input.location);
+            return VK_NULL_HANDLE;
+        }
+
+        const bool provided = std::ranges::any_of(vertex_layout.attributes,
+                                                  [&input](const VkVertexInputAttributeDescription &attribute) {
+                                                      return attribute.location == input.location;
+                                                  });
+        if (!provided) {
+            spdlog::error("{} reads vertex input location {} that the vertex layout does not provide!",
+                          description.vertex_shader, input.location);
+            return VK_NULL_HANDLE;
+        }
+    }
+
+    VkShaderModule vertex_shader_module = CreateShaderModule(vertex_code.words);
     gsl::final_action _destroy_vertex_shader([this, vertex_shader_module]() {
         vkDestroyShaderModule(device_, vertex_shader_module, nullptr);
     });
 
-    std::vector<uint8_t> basic_fragment_data = ReadFile("./basic.frag.spv");
-    VkShaderModule fragment_shader_module = CreateShaderModule(basic_fragment_data);
+    VkShaderModule fragment_shader_module = CreateShaderModule(fragment_code.words);
     gsl::final_action _destroy_fragment_shader([this, fragment_shader_module]() {
         vkDestroyShaderModule(device_, fragment_shader_module, nullptr);
     });
 
     if (vertex_shader_module == VK_NULL_HANDLE || fragment_shader_module == VK_NULL_HANDLE) {
-        spdlog::error("Failed to create shader modules!");
-        exit(EXIT_FAILURE);
+        spdlog::error("Failed to create shader modules for {} / {}!", description.vertex_shader,
+                      description.fragment_shader);
+        return VK_NULL_HANDLE;
     }
 
+    const ShaderSpecialization specialization(description.shader_features);
+
     VkPipelineShaderStageCreateInfo vertex_create_info = {};
     vertex_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     vertex_create_info.stage = VK_SHADER_STAGE_VERTEX_BIT;
     vertex_create_info.module = vertex_shader_module;
     vertex_create_info.pName = "main";
+    vertex_create_info.pSpecializationInfo = specialization.GetInfo();
 
     VkPipelineShaderStageCreateInfo fragment_create_info = {};
     fragment_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     fragment_create_info.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
     fragment_create_info.module = fragment_shader_module;
     fragment_create_info.pName = "main";
+    fragment_create_info.pSpecializationInfo = specialization.GetInfo();
 
     std::array stage_infos = {vertex_create_info, fragment_create_info};
 
-    std::array dynamic_states = {
-        VK_DYNAMIC_STATE_VIEWPORT,
-        VK_DYNAMIC_STATE_SCISSOR
-    };
+    const std::vector<VkDynamicState> dynamic_states = GetDynamicStates(dynamic_state_support_);
 
     VkPipelineDynamicStateCreateInfo dynamic_state_create_info = {};
     dynamic_state_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
     dynamic_state_create_info.dynamicStateCount = dynamic_states.size();
     dynamic_state_create_info.pDynamicStates = dynamic_states.data();
 
-    VkViewport viewport = GetViewport();
-
-    VkRect2D scissor = GetScissor();
-
+    // Viewport and scissor are dynamic, so nothing that changes with the swapchain is read here; this runs on
+    // pipeline worker threads as well.
     VkPipelineViewportStateCreateInfo viewport_state_create_info = {};
     viewport_state_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
     viewport_state_create_info.viewportCount = 1;
-    viewport_state_create_info.pViewports = &viewport;
     viewport_state_create_info.scissorCount = 1;
-    viewport_state_create_info.pScissors = &scissor;
-
-    auto vertex_binding_description = Vertex::GetBindingDescription();
-    auto vertex_attribute_descriptions = Vertex::GetAttributeDescriptions();
 
     VkPipelineVertexInputStateCreateInfo vertex_input_state_create_info = {};
     vertex_input_state_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-    vertex_input_state_create_info.vertexBindingDescriptionCount = 1;
-    vertex_input_state_create_info.pVertexBindingDescriptions = &vertex_binding_description;
-    vertex_input_state_create_info.vertexAttributeDescriptionCount = vertex_attribute_descriptions.size();
-    vertex_input_state_create_info.pVertexAttributeDescriptions = vertex_attribute_descriptions.data();
+    vertex_input_state_create_info.vertexBindingDescriptionCount = vertex_layout.bindings.size();
+    vertex_input_state_create_info.pVertexBindingDescriptions = vertex_layout.bindings.data();
+    vertex_input_state_create_info.vertexAttributeDescriptionCount = vertex_layout.attributes.size();
+    vertex_input_state_create_info.pVertexAttributeDescriptions = vertex_layout.attributes.data();
 
     VkPipelineInputAssemblyStateCreateInfo input_assembly_create_info = {};
     input_assembly_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-    input_assembly_create_info.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
-    input_assembly_create_info.primitiveRestartEnable = VK_FALSE;
+    input_assembly_create_info.topology = description.topology;
+    input_assembly_create_info.primitiveRestartEnable = description.primitive_restart ? VK_TRUE : VK_FALSE;
 
     VkPipelineRasterizationStateCreateInfo rasterization_create_info = {};
     rasterization_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
@@ -609,36 +923,26 @@ void Graphics::CreateGraphicsPipeline() {
     rasterization_create_info.rasterizerDiscardEnable = VK_FALSE;
     rasterization_create_info.polygonMode = VK_POLYGON_MODE_FILL;
     rasterization_create_info.lineWidth = 1.0f;
-    rasterization_create_info.cullMode = VK_CULL_MODE_NONE;
-    rasterization_create_info.frontFace = VK_FRONT_FACE_CLOCKWISE;
+    rasterization_create_info.cullMode = description.cull_mode;
+    rasterization_create_info.frontFace = description.front_face;
     rasterization_create_info.depthBiasEnable = VK_FALSE;
 
     VkPipelineMultisampleStateCreateInfo multisample_create_info = {};
     multisample_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
     multisample_create_info.sampleShadingEnable = VK_FALSE;
-    multisample_create_info.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+    multisample_create_info.rasterizationSamples = msaa_samples_;
 
     VkPipelineDepthStencilStateCreateInfo depthStencil_create_info = {};
     depthStencil_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
-    depthStencil_create_info.depthTestEnable = VK_TRUE;
-    depthStencil_create_info.depthWriteEnable = VK_TRUE;
-    depthStencil_create_info.depthCompareOp = VK_COMPARE_OP_LESS;
+    depthStencil_create_info.depthTestEnable = description.depth_test ? VK_TRUE : VK_FALSE;
+    depthStencil_create_info.depthWriteEnable = description.depth_write ? VK_TRUE : VK_FALSE;
+    depthStencil_create_info.depthCompareOp = description.depth_compare;
     depthStencil_create_info.depthBoundsTestEnable = VK_FALSE;
     depthStencil_create_info.minDepthBounds = 0.0f;
     depthStencil_create_info.maxDepthBounds = 1.0f;
     depthStencil_create_info.stencilTestEnable = VK_FALSE;
 
-    VkPipelineColorBlendAttachmentState color_blend_attachment_state = {};
-    color_blend_attachment_state.colorWriteMask =
-            VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
-
-    color_blend_attachment_state.blendEnable = VK_TRUE;
-    color_blend_attachment_state.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
-    color_blend_attachment_state.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
-    color_blend_attachment_state.colorBlendOp = VK_BLEND_OP_ADD;
-    color_blend_attachment_state.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
-    color_blend_attachment_state.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
-    color_blend_attachment_state.alphaBlendOp = VK_BLEND_OP_ADD;
+    VkPipelineColorBlendAttachmentState color_blend_attachment_state = GetBlendAttachmentState(description.blend_mode);
 
     VkPipelineColorBlendStateCreateInfo color_blend_create_info = {};
     color_blend_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
@@ -646,32 +950,9 @@ void Graphics::CreateGraphicsPipeline() {
     color_blend_create_info.attachmentCount = 1;
     color_blend_create_info.pAttachments = &color_blend_attachment_state;
 
-    VkPipelineLayoutCreateInfo pipeline_layout_create_info = {};
-    pipeline_layout_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
-
-    VkPushConstantRange model_matrix_range = {};
-    model_matrix_range.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-    model_matrix_range.offset = 0;
-    model_matrix_range.size = sizeof(glm::mat4);
-
-    pipeline_layout_create_info.pushConstantRangeCount = 1;
-    pipeline_layout_create_info.pPushConstantRanges = &model_matrix_range;
-
-    std::array descriptor_set_layouts = {
-        uniform_set_layout_,
-        texture_set_layout_
-    };
-
-    pipeline_layout_create_info.setLayoutCount = descriptor_set_layouts.size();
-    pipeline_layout_create_info.pSetLayouts = descriptor_set_layouts.data();
-
-    if (vkCreatePipelineLayout(device_, &pipeline_layout_create_info, nullptr, &pipeline_layout_) != VK_SUCCESS) {
-        spdlog::error("failed to create pipeline layout!");
-        exit(EXIT_FAILURE);
-    }
-
     VkGraphicsPipelineCreateInfo pipeline_create_info = {};
     pipeline_create_info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipeline_create_info.flags = pipeline_create_flags_;
     pipeline_create_info.stageCount = stage_infos.size();
     pipeline_create_info.pStages = stage_infos.data();
     pipeline_create_info.pVertexInputState = &vertex_input_state_create_info;
@@ -682,23 +963,180 @@ void Graphics::CreateGraphicsPipeline() {
     pipeline_create_info.pDepthStencilState = &depthStencil_create_info;
     pipeline_create_info.pColorBlendState = &color_blend_create_info;
     pipeline_create_info.pDynamicState = &dynamic_state_create_info;
-    pipeline_create_info.layout = pipeline_layout_;
+    pipeline_create_info.layout = pipeline_layout;
     pipeline_create_info.renderPass = render_pass_;
     pipeline_create_info.subpass = 0;
 
-    if (vkCreateGraphicsPipelines(device_, VK_NULL_HANDLE, 1, &pipeline_create_info, nullptr, &graphics_pipeline_) !=
+    if (!pipeline_library_supported_) {
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        if (vkCreateGraphicsPipelines(device_, vulkan_pipeline_cache_, 1, &pipeline_create_info, nullptr, &pipeline) !=
+            VK_SUCCESS) {
+            spdlog::error("failed to create graphics pipeline!");
+            return VK_NULL_HANDLE;
+        }
+        return pipeline;
+    }
+
+    // Each part only reads the state that belongs to it, so all of them are built from the same create info.
+    const auto create_part = [this, &pipeline_create_info, &vertex_create_info, &fragment_create_info](
+        const PipelineLibraryPart part) -> VkPipeline {
+        VkGraphicsPipelineLibraryCreateInfoEXT library_create_info = {};
+        library_create_info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT;
+        library_create_info.flags = GetPipelineLibraryFlags(part);
+
+        VkGraphicsPipelineCreateInfo part_create_info = pipeline_create_info;
+        part_create_info.pNext = &library_create_info;
+        part_create_info.flags |= VK_PIPELINE_CREATE_LIBRARY_BIT_KHR |
+                                  VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT;
+        part_create_info.stageCount = 0;
+        part_create_info.pStages = nullptr;
+        if (part == PipelineLibraryPart::PreRasterization) {
+            part_create_info.stageCount = 1;
+            part_create_info.pStages = &vertex_create_info;
+        } else if (part == PipelineLibraryPart::FragmentShader) {
+            part_create_info.stageCount = 1;
+            part_create_info.pStages = &fragment_create_info;
+        }
+
+        VkPipeline library = VK_NULL_HANDLE;
+        if (vkCreateGraphicsPipelines(device_, vulkan_pipeline_cache_, 1, &part_create_info, nullptr, &library) !=
+            VK_SUCCESS) {
+            spdlog::error("failed to create graphics pipeline library part {}!", static_cast<std::uint32_t>(part));
+            return VK_NULL_HANDLE;
+        }
+        return library;
+    };
+
+    // Parts are keyed by the vertex layout actually used, which may have been derived from the shader.
+    PipelineDescription library_description = description;
+    library_description.vertex_layout = vertex_layout;
+
+    std::array<VkPipeline, kPipelineLibraryPartCount> libraries = {};
+    for (std::size_t index = 0; index < libraries.size(); ++index) {
+        libraries[index] = pipeline_library_.GetOrCreate(library_description, static_cast<PipelineLibraryPart>(index),
+                                                          create_part);
+        if (libraries[index] == VK_NULL_HANDLE) {
+            return VK_NULL_HANDLE;
+        }
+    }
+
+    return LinkPipeline(libraries, pipeline_layout, optimize);
+}
+
+VkPipeline Graphics::LinkPipeline(const std::span<const VkPipeline> libraries, VkPipelineLayout layout,
+                                  const bool optimize) const {
+    VkPipelineLibraryCreateInfoKHR library_info = {};
+    library_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR;
+    library_info.libraryCount = libraries.size();
+    library_info.pLibraries = libraries.data();
+
+    VkGraphicsPipelineCreateInfo link_create_info = {};
+    link_create_info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    link_create_info.pNext = &library_info;
+    link_create_info.flags = pipeline_create_flags_;
+    if (optimize) {
+        link_create_info.flags |= VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT;
+    }
+    link_create_info.layout = layout;
+
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    if (vkCreateGraphicsPipelines(device_, vulkan_pipeline_cache_, 1, &link_create_info, nullptr, &pipeline) !=
         VK_SUCCESS) {
-        spdlog::error("failed to create graphics pipeline!");
-        exit(EXIT_FAILURE);
+        spdlog::error("failed to link graphics pipeline!");
+        return VK_NULL_HANDLE;
+    }
+
+    return pipeline;
+}
+
+VkPipeline Graphics::GetPipeline(const PipelineDescription &description) {
+    return pipeline_cache_.GetOrCreate(GetPipelineKey(description, dynamic_state_support_),
+                                       [this](const PipelineDescription &missing) {
+                                           return CreatePipeline(missing);
+                                       });
+}
+
+void Graphics::SetPipeline(const PipelineDescription &description) {
+    if (render_backend_ == RenderBackend::ShaderObjects) {
+        BindShaderObjects(description);
+        return;
+    }
+
+    VkPipeline pipeline = GetPipeline(description);
+    if (pipeline == VK_NULL_HANDLE) {
+        return;
+    }
+
+    skip_draws_ = false;
+    if (pipeline != bound_pipeline_) {
+        vkCmdBindPipeline(buffered_frames_[current_frame_].command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+        bound_pipeline_ = pipeline;
+    }
+    dynamic_state_.Apply(buffered_frames_[current_frame_].command_buffer, description, dynamic_state_support_);
+}
+
+const PipelineCache &Graphics::GetPipelineCache() const {
+    return pipeline_cache_;
+}
+
+RenderBackend Graphics::GetRenderBackend() const {
+    return render_backend_;
+}
+
+const Frustum &Graphics::GetViewFrustum() const {
+    return view_frustum_;
+}
+
+PipelineHandle Graphics::CompilePipelineAsync(const PipelineDescription &description) {
+    return pipeline_cache_.GetOrCreateAsync(GetPipelineKey(description, dynamic_state_support_),
+                                            [this](const PipelineDescription &missing) {
+                                                return CreatePipeline(missing);
+                                            }, pipeline_workers_);
+}
+
+void Graphics::SetFallbackPipeline(const PipelineDescription &description) {
+    if (render_backend_ == RenderBackend::ShaderObjects) {
+        return;
+    }
+
+    fallback_pipeline_ = GetPipeline(description);
+}
+
+void Graphics::RetryFailedPipelines() {
+    pipeline_cache_.RetryFailed();
+}
+
+bool Graphics::TrySetPipeline(const PipelineDescription &description) {
+    // Shader objects compile quickly enough to be created on first use.
+    if (render_backend_ == RenderBackend::ShaderObjects) {
+        return BindShaderObjects(description);
+    }
+
+    VkPipeline pipeline = CompilePipelineAsync(description).Get();
+    if (pipeline == VK_NULL_HANDLE) {
+        pipeline = fallback_pipeline_;
     }
+
+    skip_draws_ = pipeline == VK_NULL_HANDLE;
+    if (skip_draws_) {
+        return false;
+    }
+
+    if (pipeline != bound_pipeline_) {
+        vkCmdBindPipeline(buffered_frames_[current_frame_].command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
+        bound_pipeline_ = pipeline;
+    }
+    // A fallback draws with the requested state too; with dynamic state it only differs in the shaders.
+    dynamic_state_.Apply(buffered_frames_[current_frame_].command_buffer, description, dynamic_state_support_);
+    return true;
 }
 
 VkViewport Graphics::GetViewport() const {
     VkViewport viewport = {};
     viewport.x = 0.0f;
     viewport.y = 0.0f;
-    viewport.width = static_cast<std::float_t>(extent_.width);
-    viewport.height = static_cast<float>(extent_.height);
+    viewport.width = static_cast<std::float_t>(render_extent_.width);
+    viewport.height = static_cast<float>(render_extent_.height);
     viewport.minDepth = 0.0f;
     viewport.maxDepth = 1.0f;
 
@@ -708,29 +1146,37 @@ VkViewport Graphics::GetViewport() const {
 VkRect2D Graphics::GetScissor() const {
     VkRect2D scissor = {};
     scissor.offset = {0, 0};
-    scissor.extent = extent_;
+    scissor.extent = render_extent_;
 
     return scissor;
 }
 
 void Graphics::CreateRenderPass() {
+    const bool multisampled = msaa_samples_ != VK_SAMPLE_COUNT_1_BIT;
+
     VkAttachmentDescription color_attachments_description = {};
     color_attachments_description.format = surface_format_.format;
-    color_attachments_description.samples = VK_SAMPLE_COUNT_1_BIT;
+    color_attachments_description.samples = msaa_samples_;
     color_attachments_description.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-    color_attachments_description.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    color_attachments_description.storeOp = multisampled
+                                                ? VK_ATTACHMENT_STORE_OP_DONT_CARE
+                                                : VK_ATTACHMENT_STORE_OP_STORE;
     color_attachments_description.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     color_attachments_description.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     color_attachments_description.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    color_attachments_description.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    // Left ready for whichever way the upscale reads the scene target.
+    const ResourceState upscale_read = GetAccessState(GetSceneColorAccess());
+    color_attachments_description.finalLayout = multisampled
+                                                    ? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
+                                                    : upscale_read.layout;
 
     VkAttachmentReference color_attachment_reference = {};
     color_attachment_reference.attachment = 0;
     color_attachment_reference.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
 
     VkAttachmentDescription depth_attachment_description = {};
-    depth_attachment_description.format = VK_FORMAT_D32_SFLOAT;
-    depth_attachment_description.samples = VK_SAMPLE_COUNT_1_BIT;
+    depth_attachment_description.format = depth_format_;
+    depth_attachment_description.samples = msaa_samples_;
     depth_attachment_description.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
     depth_attachment_description.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     depth_attachment_description.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
@@ -742,23 +1188,51 @@ void Graphics::CreateRenderPass() {
     depth_attachment_reference.attachment = 1;
     depth_attachment_reference.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
+    VkAttachmentDescription resolve_attachment_description = {};
+    resolve_attachment_description.format = surface_format_.format;
+    resolve_attachment_description.samples = VK_SAMPLE_COUNT_1_BIT;
+    resolve_attachment_description.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    resolve_attachment_description.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    resolve_attachment_description.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    resolve_attachment_description.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    resolve_attachment_description.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    resolve_attachment_description.finalLayout = upscale_read.layout;
+
+    VkAttachmentReference resolve_attachment_reference = {};
+    resolve_attachment_reference.attachment = 2;
+    resolve_attachment_reference.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
     VkSubpassDescription main_subpass = {};
     main_subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
     main_subpass.colorAttachmentCount = 1;
     main_subpass.pColorAttachments = &color_attachment_reference;
     main_subpass.pDepthStencilAttachment = &depth_attachment_reference;
+    main_subpass.pResolveAttachments = multisampled ? &resolve_attachment_reference : nullptr;
 
     VkSubpassDependency dependency = {};
     dependency.srcSubpass = VK_SUBPASS_EXTERNAL;
     dependency.dstSubpass = 0;
     dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
-                              VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+                              VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
     dependency.srcAccessMask = 0;
     dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
                               VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
     dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
 
-    std::array attachments = {color_attachments_description, depth_attachment_description};
+    VkSubpassDependency blit_dependency = {};
+    blit_dependency.srcSubpass = 0;
+    blit_dependency.dstSubpass = VK_SUBPASS_EXTERNAL;
+    blit_dependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+    blit_dependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    blit_dependency.dstStageMask = static_cast<VkPipelineStageFlags>(upscale_read.stages);
+    blit_dependency.dstAccessMask = blit_upscale_ ? VK_ACCESS_TRANSFER_READ_BIT : VK_ACCESS_SHADER_READ_BIT;
+
+    std::array dependencies = {dependency, blit_dependency};
+
+    std::vector attachments = {color_attachments_description, depth_attachment_description};
+    if (multisampled) {
+        attachments.push_back(resolve_attachment_description);
+    }
 
     VkRenderPassCreateInfo render_pass_create_info = {};
     render_pass_create_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
@@ -766,8 +1240,8 @@ void Graphics::CreateRenderPass() {
     render_pass_create_info.pAttachments = attachments.data();
     render_pass_create_info.subpassCount = 1;
     render_pass_create_info.pSubpasses = &main_subpass;
-    render_pass_create_info.dependencyCount = 1;
-    render_pass_create_info.pDependencies = &dependency;
+    render_pass_create_info.dependencyCount = dependencies.size();
+    render_pass_create_info.pDependencies = dependencies.data();
 
     if (vkCreateRenderPass(device_, &render_pass_create_info, nullptr, &render_pass_) != VK_SUCCESS) {
         spdlog::error("failed to create render pass!");
@@ -780,24 +1254,23 @@ void Graphics::CreateRenderPass() {
 #pragma region DRAWING
 
 void Graphics::CreateFramebuffers() {
-    swap_chain_framebuffers_.resize(swap_chain_image_views_.size());
-    for (uint32_t i = 0; i < swap_chain_image_views_.size(); i++) {
-        std::array attachments = {swap_chain_image_views_[i], depth_texture_.image_view};
-
-        VkFramebufferCreateInfo framebuffer_create_info = {};
-        framebuffer_create_info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
-        framebuffer_create_info.renderPass = render_pass_;
-        framebuffer_create_info.attachmentCount = attachments.size();
-        framebuffer_create_info.pAttachments = attachments.data();
-        framebuffer_create_info.width = extent_.width;
-        framebuffer_create_info.height = extent_.height;
-        framebuffer_create_info.layers = 1;
+    std::vector attachments = {scene_color_texture_.image_view, depth_texture_.image_view};
+    if (msaa_samples_ != VK_SAMPLE_COUNT_1_BIT) {
+        attachments = {msaa_color_texture_.image_view, depth_texture_.image_view, scene_color_texture_.image_view};
+    }
 
-        if (vkCreateFramebuffer(device_, &framebuffer_create_info, nullptr, &swap_chain_framebuffers_[i]) !=
-            VK_SUCCESS) {
-            spdlog::error("failed to create framebuffer!");
-            exit(EXIT_FAILURE);
-        }
+    VkFramebufferCreateInfo framebuffer_create_info = {};
+    framebuffer_create_info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+    framebuffer_create_info.renderPass = render_pass_;
+    framebuffer_create_info.attachmentCount = attachments.size();
+    framebuffer_create_info.pAttachments = attachments.data();
+    framebuffer_create_info.width = extent_.width;
+    framebuffer_create_info.height = extent_.height;
+    framebuffer_create_info.layers = 1;
+
+    if (vkCreateFramebuffer(device_, &framebuffer_create_info, nullptr, &scene_framebuffer_) != VK_SUCCESS) {
+        spdlog::error("failed to create framebuffer!");
+        exit(EXIT_FAILURE);
     }
 }
 
@@ -831,7 +1304,7 @@ void Graphics::CreateCommandBuffer() {
     }
 }
 
-void Graphics::BeginCommands() const {
+void Graphics::BeginCommands() {
     vkResetCommandBuffer(buffered_frames_[current_frame_].command_buffer, 0);
     VkCommandBufferBeginInfo begin_info = {};
     begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
@@ -840,12 +1313,32 @@ void Graphics::BeginCommands() const {
         throw std::runtime_error("failed to begin command buffer");
     }
 
+    if (timestamps_supported_) {
+        vkCmdResetQueryPool(buffered_frames_[current_frame_].command_buffer,
+                            buffered_frames_[current_frame_].timestamp_query_pool, 0, 2);
+        vkCmdWriteTimestamp(buffered_frames_[current_frame_].command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                            buffered_frames_[current_frame_].timestamp_query_pool, 0);
+    }
+
+    BindDescriptorBuffer(buffered_frames_[current_frame_].command_buffer);
+
+    if (render_backend_ == RenderBackend::ShaderObjects) {
+        VkCommandBuffer command_buffer = buffered_frames_[current_frame_].command_buffer;
+        BeginRendering(command_buffer);
+        SetShaderObjectState(command_buffer);
+        bound_shaders_ = {};
+        bound_vertex_layout_.reset();
+        dynamic_state_.Reset();
+        BindShaderObjects(PipelineDescription{});
+        return;
+    }
+
     VkRenderPassBeginInfo render_pass_info = {};
     render_pass_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
     render_pass_info.renderPass = render_pass_;
-    render_pass_info.framebuffer = swap_chain_framebuffers_[current_image_index_];
+    render_pass_info.framebuffer = scene_framebuffer_;
     render_pass_info.renderArea.offset = {0, 0};
-    render_pass_info.renderArea.extent = extent_;
+    render_pass_info.renderArea.extent = render_extent_;
 
     std::array<VkClearValue, 2> clear_value = {};
     clear_value[0].color = {0.0f, 0.0f, 0.0f, 1.0f};
@@ -858,6 +1351,11 @@ void Graphics::BeginCommands() const {
 
     vkCmdBindPipeline(buffered_frames_[current_frame_].command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
                       graphics_pipeline_);
+    bound_pipeline_ = graphics_pipeline_;
+    skip_draws_ = false;
+    dynamic_state_.Reset();
+    dynamic_state_.Apply(buffered_frames_[current_frame_].command_buffer, PipelineDescription{},
+                         dynamic_state_support_);
     const VkViewport viewport = GetViewport();
     const VkRect2D scissor = GetScissor();
 
@@ -865,88 +1363,529 @@ void Graphics::BeginCommands() const {
     vkCmdSetScissor(buffered_frames_[current_frame_].command_buffer, 0, 1, &scissor);
 }
 
-void Graphics::EndCommands() const {
-    vkCmdEndRenderPass(buffered_frames_[current_frame_].command_buffer);
-    if (vkEndCommandBuffer(buffered_frames_[current_frame_].command_buffer) != VK_SUCCESS) {
-        throw std::runtime_error("failed to record command buffer!");
+void Graphics::EndCommands() {
+    if (render_backend_ == RenderBackend::ShaderObjects) {
+        EndRendering(buffered_frames_[current_frame_].command_buffer);
+    } else {
+        vkCmdEndRenderPass(buffered_frames_[current_frame_].command_buffer);
     }
-}
-
-void Graphics::CreateSignals() {
-    for (Frame &buffered_frame: buffered_frames_) {
-        VkSemaphoreCreateInfo semaphore_create_info = {};
-        semaphore_create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
-
-        if (vkCreateSemaphore(device_, &semaphore_create_info, nullptr,
-                              &buffered_frame.image_available_semaphore) != VK_SUCCESS) {
-            std::exit(EXIT_FAILURE);
-        }
-
-        if (vkCreateSemaphore(device_, &semaphore_create_info, nullptr,
-                              &buffered_frame.render_finished_semaphore) != VK_SUCCESS) {
-            std::exit(EXIT_FAILURE);
-        }
-
-        VkFenceCreateInfo fence_create_info = {};
-        fence_create_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-        fence_create_info.flags = VK_FENCE_CREATE_SIGNALED_BIT;
 
-        if (vkCreateFence(device_, &fence_create_info, nullptr, &buffered_frame.still_rendering_fence) !=
-            VK_SUCCESS) {
-            std::exit(EXIT_FAILURE);
-        }
+    // The scene pass leaves the scene target ready for the upscale to read; the swapchain image is waited on at the
+    // stage the upscale first touches it when the frame is submitted.
+    frame_graph_.Reset();
+    const RenderGraphResource scene_color = frame_graph_.ImportImage(
+        "scene_color", scene_color_texture_.image, VK_IMAGE_ASPECT_COLOR_BIT, GetAccessState(GetSceneColorAccess()));
+    const RenderGraphResource swapchain_image = frame_graph_.ImportImage(
+        "swapchain", swap_chain_images_[current_image_index_], VK_IMAGE_ASPECT_COLOR_BIT,
+        {GetUpscaleStage(), VK_ACCESS_2_NONE, VK_IMAGE_LAYOUT_UNDEFINED});
+
+    if (blit_upscale_) {
+        frame_graph_.AddPass("upscale", [&](RenderGraph::PassBuilder &builder) {
+            builder.Read(scene_color, RenderGraphAccess::TransferRead);
+            builder.Write(swapchain_image, RenderGraphAccess::TransferWrite);
+        }, std::bind_front(&Graphics::BlitSceneToSwapchain, this));
+    } else {
+        frame_graph_.AddPass("upscale", [&](RenderGraph::PassBuilder &builder) {
+            builder.Read(scene_color, RenderGraphAccess::FragmentShaderRead);
+            builder.Write(swapchain_image, RenderGraphAccess::ColorAttachmentWrite);
+        }, std::bind_front(&Graphics::DrawSceneToSwapchain, this));
     }
-}
+    frame_graph_.MarkOutput(swapchain_image, RenderGraphAccess::Present);
 
-bool Graphics::BeginFrame() {
-    vkWaitForFences(device_, 1, &buffered_frames_[current_frame_].still_rendering_fence, VK_TRUE, UINT64_MAX);
-    vkResetFences(device_, 1, &buffered_frames_[current_frame_].still_rendering_fence);
+    frame_graph_.Compile(&buffered_frames_[current_frame_].transient_pool);
+    frame_graph_.Execute(buffered_frames_[current_frame_].command_buffer);
 
-    VkResult result = vkAcquireNextImageKHR(device_, swap_chain_, UINT64_MAX,
-                                            buffered_frames_[current_frame_].image_available_semaphore,
-                                            VK_NULL_HANDLE,
-                                            &current_image_index_);
-    if (result == VK_ERROR_OUT_OF_DATE_KHR) {
-        RecreateSwapchain();
-        return false;
+    if (timestamps_supported_) {
+        vkCmdWriteTimestamp(buffered_frames_[current_frame_].command_buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                            buffered_frames_[current_frame_].timestamp_query_pool, 1);
     }
 
-    if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
-        throw std::runtime_error("failed to acquire swap chain image!");
+    if (vkEndCommandBuffer(buffered_frames_[current_frame_].command_buffer) != VK_SUCCESS) {
+        throw std::runtime_error("failed to record command buffer!");
     }
+}
 
-    BeginCommands();
-    SetModelMatrix(glm::mat4(1.0f));
+void Graphics::BlitSceneToSwapchain(VkCommandBuffer command_buffer) const {
+    VkImageBlit blit_region = {};
+    blit_region.srcSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    blit_region.srcSubresource.mipLevel = 0;
+    blit_region.srcSubresource.baseArrayLayer = 0;
+    blit_region.srcSubresource.layerCount = 1;
+    blit_region.srcOffsets[0] = {0, 0, 0};
+    blit_region.srcOffsets[1] = {
+        static_cast<std::int32_t>(render_extent_.width), static_cast<std::int32_t>(render_extent_.height), 1
+    };
+    blit_region.dstSubresource = blit_region.srcSubresource;
+    blit_region.dstOffsets[0] = {0, 0, 0};
+    blit_region.dstOffsets[1] = {static_cast<std::int32_t>(extent_.width), static_cast<std::int32_t>(extent_.height), 1};
 
-    return true;
+    vkCmdBlitImage(command_buffer, scene_color_texture_.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                   swap_chain_images_[current_image_index_], VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit_region,
+                   upscale_filter_);
 }
 
-void Graphics::EndFrame() {
+void Graphics::DrawSceneToSwapchain(VkCommandBuffer command_buffer) const {
+    VkRenderPassBeginInfo render_pass_info = {};
+    render_pass_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+    render_pass_info.renderPass = upscale_render_pass_;
+    render_pass_info.framebuffer = upscale_framebuffers_[current_image_index_];
+    render_pass_info.renderArea.offset = {0, 0};
+    render_pass_info.renderArea.extent = extent_;
+
+    vkCmdBeginRenderPass(command_buffer, &render_pass_info, VK_SUBPASS_CONTENTS_INLINE);
+    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, upscale_pipeline_);
+    vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, upscale_pipeline_layout_, 0, 1,
+                            &upscale_descriptor_set_, 0, nullptr);
+
+    const VkViewport viewport = {
+        0.0f, 0.0f, static_cast<std::float_t>(extent_.width), static_cast<std::float_t>(extent_.height), 0.0f, 1.0f
+    };
+    const VkRect2D scissor = {{0, 0}, extent_};
+    vkCmdSetViewport(command_buffer, 0, 1, &viewport);
+    vkCmdSetScissor(command_buffer, 0, 1, &scissor);
+
+    // The scene only covers the top left render_extent_ of its target.
+    const glm::vec2 uv_scale = {
+        static_cast<std::float_t>(render_extent_.width) / static_cast<std::float_t>(extent_.width),
+        static_cast<std::float_t>(render_extent_.height) / static_cast<std::float_t>(extent_.height)
+    };
+    vkCmdPushConstants(command_buffer, upscale_pipeline_layout_, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(uv_scale),
+                       &uv_scale);
+    vkCmdDraw(command_buffer, 3, 1, 0, 0);
+    vkCmdEndRenderPass(command_buffer);
+}
+
+RenderGraphAccess Graphics::GetSceneColorAccess() const {
+    return blit_upscale_ ? RenderGraphAccess::TransferRead : RenderGraphAccess::FragmentShaderRead;
+}
+
+VkPipelineStageFlags2 Graphics::GetUpscaleStage() const {
+    return blit_upscale_ ? VK_PIPELINE_STAGE_2_TRANSFER_BIT : VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+}
+
+void Graphics::CreateUpscalePass() {
+    if (blit_upscale_) {
+        return;
+    }
+    spdlog::info("The surface format cannot be blitted, upscaling with a fullscreen pass");
+
+    VkAttachmentDescription color_attachment_description = {};
+    color_attachment_description.format = surface_format_.format;
+    color_attachment_description.samples = VK_SAMPLE_COUNT_1_BIT;
+    color_attachment_description.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    color_attachment_description.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    color_attachment_description.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    color_attachment_description.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    // The frame graph transitions the swapchain image around the pass.
+    color_attachment_description.initialLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    color_attachment_description.finalLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    VkAttachmentReference color_attachment_reference = {};
+    color_attachment_reference.attachment = 0;
+    color_attachment_reference.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    VkSubpassDescription subpass = {};
+    subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+    subpass.colorAttachmentCount = 1;
+    subpass.pColorAttachments = &color_attachment_reference;
+
+    VkRenderPassCreateInfo render_pass_create_info = {};
+    render_pass_create_info.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+    render_pass_create_info.attachmentCount = 1;
+    render_pass_create_info.pAttachments = &color_attachment_description;
+    render_pass_create_info.subpassCount = 1;
+    render_pass_create_info.pSubpasses = &subpass;
+
+    if (vkCreateRenderPass(device_, &render_pass_create_info, nullptr, &upscale_render_pass_) != VK_SUCCESS) {
+        spdlog::error("failed to create upscale render pass!");
+        std::exit(EXIT_FAILURE);
+    }
+
+    VkSamplerCreateInfo sampler_create_info = {};
+    sampler_create_info.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+    sampler_create_info.magFilter = upscale_filter_;
+    sampler_create_info.minFilter = upscale_filter_;
+    sampler_create_info.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+    sampler_create_info.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler_create_info.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler_create_info.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+    sampler_create_info.maxAnisotropy = 1.0f;
+
+    if (vkCreateSampler(device_, &sampler_create_info, nullptr, &upscale_sampler_) != VK_SUCCESS) {
+        spdlog::error("failed to create upscale sampler!");
+        std::exit(EXIT_FAILURE);
+    }
+
+    PipelineDescription description = {};
+    description.vertex_shader = "upscale.vert";
+    description.fragment_shader = "upscale.frag";
+    const std::optional<ShaderReflection> reflection = ReflectPipeline(description);
+    if (!reflection.has_value()) {
+        std::exit(EXIT_FAILURE);
+    }
+
+    // Bound as a plain descriptor set even when the scene uses descriptor buffers.
+    upscale_pipeline_layout_ = layout_cache_.GetPipelineLayout(reflection.value());
+    const VkDescriptorSetLayout set_layout = layout_cache_.GetSetLayout(reflection.value(), 0);
+    if (upscale_pipeline_layout_ == VK_NULL_HANDLE || set_layout == VK_NULL_HANDLE) {
+        spdlog::error("failed to create upscale pipeline layout!");
+        std::exit(EXIT_FAILURE);
+    }
+
+    VkDescriptorPoolSize pool_size = {};
+    pool_size.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    pool_size.descriptorCount = 1;
+
+    VkDescriptorPoolCreateInfo pool_create_info = {};
+    pool_create_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    pool_create_info.maxSets = 1;
+    pool_create_info.poolSizeCount = 1;
+    pool_create_info.pPoolSizes = &pool_size;
+
+    if (vkCreateDescriptorPool(device_, &pool_create_info, nullptr, &upscale_descriptor_pool_) != VK_SUCCESS) {
+        spdlog::error("Failed to create descriptor pool!");
+        std::exit(EXIT_FAILURE);
+    }
+
+    VkDescriptorSetAllocateInfo set_allocate_info = {};
+    set_allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    set_allocate_info.descriptorPool = upscale_descriptor_pool_;
+    set_allocate_info.descriptorSetCount = 1;
+    set_allocate_info.pSetLayouts = &set_layout;
+
+    if (vkAllocateDescriptorSets(device_, &set_allocate_info, &upscale_descriptor_set_) != VK_SUCCESS) {
+        spdlog::error("Failed to allocate descriptor set!");
+        std::exit(EXIT_FAILURE);
+    }
+
+    const ShaderCode vertex_code = shader_registry_.Find(description.vertex_shader);
+    const ShaderCode fragment_code = shader_registry_.Find(description.fragment_shader);
+    VkShaderModule vertex_shader_module = CreateShaderModule(vertex_code.words);
+    gsl::final_action _destroy_vertex_shader([this, vertex_shader_module]() {
+        vkDestroyShaderModule(device_, vertex_shader_module, nullptr);
+    });
+
+    VkShaderModule fragment_shader_module = CreateShaderModule(fragment_code.words);
+    gsl::final_action _destroy_fragment_shader([this, fragment_shader_module]() {
+        vkDestroyShaderModule(device_, fragment_shader_module, nullptr);
+    });
+
+    if (vertex_shader_module == VK_NULL_HANDLE || fragment_shader_module == VK_NULL_HANDLE) {
+        spdlog::error("Failed to create shader modules for the upscale pass!");
+        std::exit(EXIT_FAILURE);
+    }
+
+    std::array<VkPipelineShaderStageCreateInfo, 2> stage_infos = {};
+    stage_infos[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stage_infos[0].stage = VK_SHADER_STAGE_VERTEX_BIT;
+    stage_infos[0].module = vertex_shader_module;
+    stage_infos[0].pName = "main";
+    stage_infos[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    stage_infos[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    stage_infos[1].module = fragment_shader_module;
+    stage_infos[1].pName = "main";
+
+    const std::array dynamic_states = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+
+    VkPipelineDynamicStateCreateInfo dynamic_state_create_info = {};
+    dynamic_state_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    dynamic_state_create_info.dynamicStateCount = dynamic_states.size();
+    dynamic_state_create_info.pDynamicStates = dynamic_states.data();
+
+    VkPipelineViewportStateCreateInfo viewport_state_create_info = {};
+    viewport_state_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    viewport_state_create_info.viewportCount = 1;
+    viewport_state_create_info.scissorCount = 1;
+
+    // The triangle is generated from gl_VertexIndex.
+    VkPipelineVertexInputStateCreateInfo vertex_input_state_create_info = {};
+    vertex_input_state_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+
+    VkPipelineInputAssemblyStateCreateInfo input_assembly_create_info = {};
+    input_assembly_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    input_assembly_create_info.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+
+    VkPipelineRasterizationStateCreateInfo rasterization_create_info = {};
+    rasterization_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    rasterization_create_info.polygonMode = VK_POLYGON_MODE_FILL;
+    rasterization_create_info.lineWidth = 1.0f;
+    rasterization_create_info.cullMode = VK_CULL_MODE_NONE;
+
+    VkPipelineMultisampleStateCreateInfo multisample_create_info = {};
+    multisample_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    multisample_create_info.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+
+    VkPipelineColorBlendAttachmentState color_blend_attachment_state = GetBlendAttachmentState(BlendMode::Opaque);
+
+    VkPipelineColorBlendStateCreateInfo color_blend_create_info = {};
+    color_blend_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    color_blend_create_info.attachmentCount = 1;
+    color_blend_create_info.pAttachments = &color_blend_attachment_state;
+
+    VkGraphicsPipelineCreateInfo pipeline_create_info = {};
+    pipeline_create_info.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipeline_create_info.stageCount = stage_infos.size();
+    pipeline_create_info.pStages = stage_infos.data();
+    pipeline_create_info.pVertexInputState = &vertex_input_state_create_info;
+    pipeline_create_info.pInputAssemblyState = &input_assembly_create_info;
+    pipeline_create_info.pViewportState = &viewport_state_create_info;
+    pipeline_create_info.pRasterizationState = &rasterization_create_info;
+    pipeline_create_info.pMultisampleState = &multisample_create_info;
+    pipeline_create_info.pColorBlendState = &color_blend_create_info;
+    pipeline_create_info.pDynamicState = &dynamic_state_create_info;
+    pipeline_create_info.layout = upscale_pipeline_layout_;
+    pipeline_create_info.renderPass = upscale_render_pass_;
+    pipeline_create_info.subpass = 0;
+
+    if (vkCreateGraphicsPipelines(device_, vulkan_pipeline_cache_, 1, &pipeline_create_info, nullptr,
+                                  &upscale_pipeline_) != VK_SUCCESS) {
+        spdlog::error("failed to create upscale pipeline!");
+        std::exit(EXIT_FAILURE);
+    }
+}
+
+void Graphics::CreateUpscaleFramebuffers() {
+    if (blit_upscale_) {
+        return;
+    }
+
+    upscale_framebuffers_.resize(swap_chain_image_views_.size());
+    auto iter = upscale_framebuffers_.begin();
+    for (VkImageView image_view: swap_chain_image_views_) {
+        VkFramebufferCreateInfo framebuffer_create_info = {};
+        framebuffer_create_info.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+        framebuffer_create_info.renderPass = upscale_render_pass_;
+        framebuffer_create_info.attachmentCount = 1;
+        framebuffer_create_info.pAttachments = &image_view;
+        framebuffer_create_info.width = extent_.width;
+        framebuffer_create_info.height = extent_.height;
+        framebuffer_create_info.layers = 1;
+
+        if (vkCreateFramebuffer(device_, &framebuffer_create_info, nullptr, &*iter) != VK_SUCCESS) {
+            spdlog::error("failed to create framebuffer!");
+            std::exit(EXIT_FAILURE);
+        }
+        std::advance(iter, 1);
+    }
+
+    // The scene target is recreated with the swapchain; nothing reads the set while the device is idle for that.
+    VkDescriptorImageInfo image_info = {};
+    image_info.sampler = upscale_sampler_;
+    image_info.imageView = scene_color_texture_.image_view;
+    image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+
+    VkWriteDescriptorSet descriptor_write = {};
+    descriptor_write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+    descriptor_write.dstSet = upscale_descriptor_set_;
+    descriptor_write.dstBinding = 0;
+    descriptor_write.dstArrayElement = 0;
+    descriptor_write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    descriptor_write.descriptorCount = 1;
+    descriptor_write.pImageInfo = &image_info;
+
+    vkUpdateDescriptorSets(device_, 1, &descriptor_write, 0, nullptr);
+}
+
+void Graphics::CreateSignals() {
+    for (Frame &buffered_frame: buffered_frames_) {
+        VkSemaphoreCreateInfo semaphore_create_info = {};
+        semaphore_create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+        if (vkCreateSemaphore(device_, &semaphore_create_info, nullptr,
+                              &buffered_frame.image_available_semaphore) != VK_SUCCESS) {
+            std::exit(EXIT_FAILURE);
+        }
+
+        VkFenceCreateInfo fence_create_info = {};
+        fence_create_info.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        fence_create_info.flags = VK_FENCE_CREATE_SIGNALED_BIT;
+
+        if (vkCreateFence(device_, &fence_create_info, nullptr, &buffered_frame.still_rendering_fence) !=
+            VK_SUCCESS) {
+            std::exit(EXIT_FAILURE);
+        }
+    }
+}
+
+void Graphics::CreateTimestampQueries() {
+    VkPhysicalDeviceProperties device_properties = {};
+    vkGetPhysicalDeviceProperties(physical_device_, &device_properties);
+
+    std::uint32_t queue_family_count = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(physical_device_, &queue_family_count, nullptr);
+    std::vector<VkQueueFamilyProperties> queue_families(queue_family_count);
+    vkGetPhysicalDeviceQueueFamilyProperties(physical_device_, &queue_family_count, queue_families.data());
+
+    const std::uint32_t graphics_family = FindQueueFamilies(physical_device_).graphics_family.value();
+    timestamps_supported_ = queue_families[graphics_family].timestampValidBits > 0 &&
+                            device_properties.limits.timestampPeriod > 0.0f;
+    timestamp_period_ = device_properties.limits.timestampPeriod;
+
+    if (!timestamps_supported_) {
+        spdlog::warn("GPU timestamps unsupported, dynamic resolution disabled");
+        return;
+    }
+
+    VkQueryPoolCreateInfo query_pool_create_info = {};
+    query_pool_create_info.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    query_pool_create_info.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    query_pool_create_info.queryCount = 2;
+
+    for (Frame &buffered_frame: buffered_frames_) {
+        if (vkCreateQueryPool(device_, &query_pool_create_info, nullptr, &buffered_frame.timestamp_query_pool) !=
+            VK_SUCCESS) {
+            spdlog::error("Failed to create timestamp query pool!");
+            std::exit(EXIT_FAILURE);
+        }
+    }
+}
+
+void Graphics::CreateTransientPools() {
+    for (Frame &buffered_frame: buffered_frames_) {
+        buffered_frame.transient_pool.Initialize(device_, physical_device_);
+    }
+}
+
+void Graphics::UpdateRenderScale() {
+    Frame &frame = buffered_frames_[current_frame_];
+    if (timestamps_supported_ && frame.timestamps_written) {
+        std::array<std::uint64_t, 2> timestamps = {};
+        const VkResult result = vkGetQueryPoolResults(device_, frame.timestamp_query_pool, 0, timestamps.size(),
+                                                      sizeof(timestamps), timestamps.data(), sizeof(std::uint64_t),
+                                                      VK_QUERY_RESULT_64_BIT);
+        if (result == VK_SUCCESS && timestamps[1] > timestamps[0]) {
+            const std::float_t gpu_frame_time_ms = static_cast<std::float_t>(timestamps[1] - timestamps[0]) *
+                                                   timestamp_period_ / 1000000.0f;
+            dynamic_resolution_.Update(gpu_frame_time_ms);
+        }
+    }
+
+    render_extent_ = dynamic_resolution_.ScaleExtent(extent_);
+}
+
+void Graphics::SetDynamicResolution(const DynamicResolutionSettings &settings) {
+    dynamic_resolution_.SetSettings(settings);
+}
+
+std::float_t Graphics::GetRenderScale() const {
+    return dynamic_resolution_.GetScale();
+}
+
+VkSampleCountFlagBits Graphics::GetSampleCount() const {
+    return msaa_samples_;
+}
+
+bool Graphics::BeginFrame() {
+    if (swapchain_out_of_date_) {
+        RecreateSwapchain();
+        if (swapchain_out_of_date_) {
+            return false;
+        }
+    }
+
+    vkWaitForFences(device_, 1, &buffered_frames_[current_frame_].still_rendering_fence, VK_TRUE, UINT64_MAX);
+    // The graphics submission waited on this frame's compute work, so the fence covers it as well.
+    vkResetDescriptorPool(device_, buffered_frames_[current_frame_].compute_descriptor_pool, 0);
+    buffered_frames_[current_frame_].compute_recorded = false;
+    UpdateRenderScale();
+
+    VkResult result = vkAcquireNextImageKHR(device_, swap_chain_, UINT64_MAX,
+                                            buffered_frames_[current_frame_].image_available_semaphore,
+                                            VK_NULL_HANDLE,
+                                            &current_image_index_);
+    if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+        RecreateSwapchain();
+        return false;
+    }
+
+    if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
+        throw std::runtime_error("failed to acquire swap chain image!");
+    }
+    // Only once a frame will be submitted, or the next BeginFrame would wait on a fence nothing signals.
+    vkResetFences(device_, 1, &buffered_frames_[current_frame_].still_rendering_fence);
+
+    BeginCommands();
+    buffered_frames_[current_frame_].timestamps_written = timestamps_supported_;
+    SetModelMatrix(glm::mat4(1.0f));
+
+    return true;
+}
+
+void Graphics::EndFrame() {
     EndCommands();
 
+    std::vector wait_semaphores = {buffered_frames_[current_frame_].image_available_semaphore};
+    // The legacy stage bits share their values with the synchronization2 ones.
+    std::vector wait_stage_flags = {static_cast<VkPipelineStageFlags>(GetUpscaleStage())};
+
+    if (buffered_frames_[current_frame_].compute_recorded) {
+        vkEndCommandBuffer(buffered_frames_[current_frame_].compute_command_buffer);
+
+        VkSubmitInfo compute_submit_info = {};
+        compute_submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+
+        // Dispatches may overwrite what the previous frame's draws still read, so they wait for that submission.
+        constexpr VkPipelineStageFlags compute_wait_stage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+        VkTimelineSemaphoreSubmitInfo compute_timeline_info = {};
+        compute_timeline_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+        compute_timeline_info.waitSemaphoreValueCount = 1;
+        compute_timeline_info.pWaitSemaphoreValues = &graphics_timeline_value_;
+        compute_submit_info.pNext = &compute_timeline_info;
+        compute_submit_info.waitSemaphoreCount = 1;
+        compute_submit_info.pWaitSemaphores = &graphics_timeline_semaphore_;
+        compute_submit_info.pWaitDstStageMask = &compute_wait_stage;
+
+        compute_submit_info.commandBufferCount = 1;
+        compute_submit_info.pCommandBuffers = &buffered_frames_[current_frame_].compute_command_buffer;
+        compute_submit_info.signalSemaphoreCount = 1;
+        compute_submit_info.pSignalSemaphores = &buffered_frames_[current_frame_].compute_finished_semaphore;
+
+        if (vkQueueSubmit(compute_queue_, 1, &compute_submit_info, VK_NULL_HANDLE) != VK_SUCCESS) {
+            throw std::runtime_error("failed to submit compute command buffer");
+        }
+
+        // Results may feed anything from indirect arguments and vertex fetch onwards.
+        wait_semaphores.push_back(buffered_frames_[current_frame_].compute_finished_semaphore);
+        wait_stage_flags.push_back(VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+                                   VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+    }
+
     VkSubmitInfo submit_info = {};
     submit_info.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
-    VkPipelineStageFlags wait_stage_flags = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-    submit_info.waitSemaphoreCount = 1;
-    submit_info.pWaitSemaphores = &buffered_frames_[current_frame_].image_available_semaphore;
-    submit_info.pWaitDstStageMask = &wait_stage_flags;
+    submit_info.waitSemaphoreCount = wait_semaphores.size();
+    submit_info.pWaitSemaphores = wait_semaphores.data();
+    submit_info.pWaitDstStageMask = wait_stage_flags.data();
 
     submit_info.commandBufferCount = 1;
     submit_info.pCommandBuffers = &buffered_frames_[current_frame_].command_buffer;
 
-    submit_info.signalSemaphoreCount = 1;
-    submit_info.pSignalSemaphores = &buffered_frames_[current_frame_].render_finished_semaphore;
+    const std::array signal_semaphores = {render_finished_semaphores_[current_image_index_],
+                                          graphics_timeline_semaphore_};
+    submit_info.signalSemaphoreCount = signal_semaphores.size();
+    submit_info.pSignalSemaphores = signal_semaphores.data();
+
+    // Values for the binary semaphores are ignored.
+    const std::vector<std::uint64_t> wait_values(wait_semaphores.size(), 0);
+    const std::array<std::uint64_t, 2> signal_values = {0, graphics_timeline_value_ + 1};
+    VkTimelineSemaphoreSubmitInfo timeline_info = {};
+    timeline_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+    timeline_info.waitSemaphoreValueCount = wait_values.size();
+    timeline_info.pWaitSemaphoreValues = wait_values.data();
+    timeline_info.signalSemaphoreValueCount = signal_values.size();
+    timeline_info.pSignalSemaphoreValues = signal_values.data();
+    submit_info.pNext = &timeline_info;
 
     if (vkQueueSubmit(graphics_queue_, 1, &submit_info, buffered_frames_[current_frame_].still_rendering_fence) !=
         VK_SUCCESS) {
         throw std::runtime_error("failed to submit framebuffer command buffer submission");
     }
+    ++graphics_timeline_value_;
 
     VkPresentInfoKHR present_info = {};
     present_info.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
     present_info.waitSemaphoreCount = 1;
-    present_info.pWaitSemaphores = &buffered_frames_[current_frame_].render_finished_semaphore;
+    present_info.pWaitSemaphores = &render_finished_semaphores_[current_image_index_];
     present_info.swapchainCount = 1;
     present_info.pSwapchains = &swap_chain_;
     present_info.pImageIndices = &current_image_index_;
@@ -958,14 +1897,16 @@ void Graphics::EndFrame() {
         throw std::runtime_error("failed to present!");
     }
 
-    current_frame_ = (current_frame_++) % MAX_BUFFERED_FRAMES;
+    current_frame_ = (current_frame_ + 1) % MAX_BUFFERED_FRAMES;
 }
 
 void Graphics::RecreateSwapchain() {
-    glm::ivec2 window_size = window_->GetWindowSize();
-    while (window_size.x == 0 || window_size.y == 0) {
-        window_size = window_->GetFrameBufferSize();
-        glfwWaitEvents();
+    // Waiting for events here would block on a render thread, which must not touch GLFW, so a minimized window just
+    // skips frames.
+    const glm::ivec2 frame_buffer_size = window_->GetFrameBufferSize();
+    swapchain_out_of_date_ = frame_buffer_size.x == 0 || frame_buffer_size.y == 0;
+    if (swapchain_out_of_date_) {
+        return;
     }
 
     vkDeviceWaitIdle(device_);
@@ -973,19 +1914,38 @@ void Graphics::RecreateSwapchain() {
 
     CreateSwapChain();
     CreateImageViews();
+    CreateDepthResources();
+    CreateSceneColorResources();
     CreateFramebuffers();
+    CreateUpscaleFramebuffers();
 }
 
 void Graphics::CleanupSwapchain() {
     if (device_ == VK_NULL_HANDLE)
         return;
 
-    for (const auto framebuffer: swap_chain_framebuffers_)
+    if (scene_framebuffer_ != VK_NULL_HANDLE)
+        vkDestroyFramebuffer(device_, scene_framebuffer_, nullptr);
+    scene_framebuffer_ = VK_NULL_HANDLE;
+
+    for (auto framebuffer: upscale_framebuffers_)
         vkDestroyFramebuffer(device_, framebuffer, nullptr);
+    upscale_framebuffers_.clear();
+
+    DestroyTexture(scene_color_texture_);
+    DestroyTexture(msaa_color_texture_);
+    DestroyTexture(depth_texture_);
+    scene_color_texture_ = {};
+    msaa_color_texture_ = {};
+    depth_texture_ = {};
 
     for (auto image_view: swap_chain_image_views_)
         vkDestroyImageView(device_, image_view, nullptr);
 
+    for (auto semaphore: render_finished_semaphores_)
+        vkDestroySemaphore(device_, semaphore, nullptr);
+    render_finished_semaphores_.clear();
+
     if (swap_chain_ != VK_NULL_HANDLE)
         vkDestroySwapchainKHR(device_, swap_chain_, nullptr);
 }
@@ -995,28 +1955,44 @@ void Graphics::CleanupSwapchain() {
 
 #pragma region BUFFERS
 
-std::uint32_t Graphics::FindMemoryType(const std::uint32_t memory_type_bits,
-                                       const VkMemoryPropertyFlags properties) const {
+std::optional<std::uint32_t> Graphics::TryFindMemoryType(const std::uint32_t memory_type_bits,
+                                                         const VkMemoryPropertyFlags properties) const {
     VkPhysicalDeviceMemoryProperties memory_properties;
     vkGetPhysicalDeviceMemoryProperties(physical_device_, &memory_properties);
     const gsl::span<VkMemoryType> memory_types(memory_properties.memoryTypes, memory_properties.memoryTypeCount);
 
     for (uint32_t i = 0; i < memory_types.size(); i++)
-        if (memory_type_bits & (1 << i) && memory_types[i].propertyFlags & properties)
+        if (memory_type_bits & (1 << i) && (memory_types[i].propertyFlags & properties) == properties)
             return i;
 
+    return std::nullopt;
+}
+
+std::uint32_t Graphics::FindMemoryType(const std::uint32_t memory_type_bits,
+                                       const VkMemoryPropertyFlags properties) const {
+    if (const std::optional<std::uint32_t> memory_type = TryFindMemoryType(memory_type_bits, properties)) {
+        return memory_type.value();
+    }
+
     throw std::runtime_error("failed to find suitable memory type!");
 }
 
 BufferHandle Graphics::CreateBuffer(const VkDeviceSize size, VkBufferUsageFlags usage,
-                                    VkMemoryPropertyFlags properties) const {
+                                    VkMemoryPropertyFlags properties, const bool compute_shared) const {
     BufferHandle buffer = {};
 
+    const std::array queue_families = {graphics_family_, compute_family_};
+
     VkBufferCreateInfo buffer_info = {};
     buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
     buffer_info.size = size;
     buffer_info.usage = usage;
     buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    if (compute_shared && compute_family_ != graphics_family_) {
+        buffer_info.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        buffer_info.queueFamilyIndexCount = queue_families.size();
+        buffer_info.pQueueFamilyIndices = queue_families.data();
+    }
 
     if (vkCreateBuffer(device_, &buffer_info, VK_NULL_HANDLE, &buffer.buffer) != VK_SUCCESS)
         throw std::runtime_error("failed to create vertex buffer!");
@@ -1026,10 +2002,17 @@ BufferHandle Graphics::CreateBuffer(const VkDeviceSize size, VkBufferUsageFlags
 
     const std::uint32_t memory_type_index = FindMemoryType(memory_requirements.memoryTypeBits, properties);
 
+    VkMemoryAllocateFlagsInfo allocate_flags_info = {};
+    allocate_flags_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
+    allocate_flags_info.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
+
     VkMemoryAllocateInfo memory_allocate_info = {};
     memory_allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
     memory_allocate_info.allocationSize = memory_requirements.size;
     memory_allocate_info.memoryTypeIndex = memory_type_index;
+    if (usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT) {
+        memory_allocate_info.pNext = &allocate_flags_info;
+    }
 
     if (vkAllocateMemory(device_, &memory_allocate_info, VK_NULL_HANDLE, &buffer.memory) != VK_SUCCESS)
         throw std::runtime_error("failed to allocate vertex buffer memory!");
@@ -1040,7 +2023,15 @@ BufferHandle Graphics::CreateBuffer(const VkDeviceSize size, VkBufferUsageFlags
 }
 
 BufferHandle Graphics::CreateVertexBuffer(const gsl::span<Vertex> vertices) const {
-    const VkDeviceSize size = vertices.size() * sizeof(Vertex);
+    return CreateVertexBufferFromBytes(gsl::as_bytes(vertices));
+}
+
+BufferHandle Graphics::CreateVertexBuffer(const gsl::span<const PackedVertex> vertices) const {
+    return CreateVertexBufferFromBytes(gsl::as_bytes(vertices));
+}
+
+BufferHandle Graphics::CreateVertexBufferFromBytes(const gsl::span<const std::byte> data) const {
+    const VkDeviceSize size = data.size();
     BufferHandle staging_handle = CreateBuffer(
         size,
         VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
@@ -1049,7 +2040,7 @@ BufferHandle Graphics::CreateVertexBuffer(const gsl::span<Vertex> vertices) cons
 
     void *mapped_data;
     vkMapMemory(device_, staging_handle.memory, 0, size, 0, &mapped_data);
-    std::memcpy(mapped_data, vertices.data(), size);
+    std::memcpy(mapped_data, data.data(), size);
     vkUnmapMemory(device_, staging_handle.memory);
 
     BufferHandle gpu_handle = CreateBuffer(size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
@@ -1100,10 +2091,12 @@ void Graphics::DestroyBuffer(const BufferHandle handle) const {
 }
 
 void Graphics::RenderBuffer(const BufferHandle buffer_handle, const std::uint32_t vertex_count) const {
+    if (skip_draws_) {
+        return;
+    }
+
     VkDeviceSize offset = 0;
-    vkCmdBindDescriptorSets(buffered_frames_[current_frame_].command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                            pipeline_layout_, 0, 1, &buffered_frames_[current_frame_].uniform_set,
-                            0, VK_NULL_HANDLE);
+    BindUniformSet(buffered_frames_[current_frame_].command_buffer);
     vkCmdBindVertexBuffers(buffered_frames_[current_frame_].command_buffer, 0, 1, &buffer_handle.buffer, &offset);
     vkCmdDraw(buffered_frames_[current_frame_].command_buffer, vertex_count, 1, 0, 0);
     SetModelMatrix(glm::mat4(1.0f));
@@ -1111,22 +2104,52 @@ void Graphics::RenderBuffer(const BufferHandle buffer_handle, const std::uint32_
 
 void Graphics::RenderIndexedBuffer(BufferHandle vertex_buffer, BufferHandle index_buffer,
                                    std::uint32_t index_count) const {
+    if (skip_draws_) {
+        return;
+    }
+
     VkDeviceSize offset = 0;
-    vkCmdBindDescriptorSets(buffered_frames_[current_frame_].command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-                            pipeline_layout_, 0, 1, &buffered_frames_[current_frame_].uniform_set,
-                            0, VK_NULL_HANDLE);
+    BindUniformSet(buffered_frames_[current_frame_].command_buffer);
     vkCmdBindVertexBuffers(buffered_frames_[current_frame_].command_buffer, 0, 1, &vertex_buffer.buffer, &offset);
     vkCmdBindIndexBuffer(buffered_frames_[current_frame_].command_buffer, index_buffer.buffer, 0, VK_INDEX_TYPE_UINT32);
     vkCmdDrawIndexed(buffered_frames_[current_frame_].command_buffer, index_count, 1, 0, 0, 0);
     SetModelMatrix(glm::mat4(1.0f));
 }
 
+std::span<glm::mat4> Graphics::GetInstanceTransforms() const {
+    return {static_cast<glm::mat4 *>(buffered_frames_[current_frame_].instance_buffer_location),
+            settings_.max_instances};
+}
+
+void Graphics::RenderIndexedBufferInstanced(BufferHandle vertex_buffer, BufferHandle index_buffer,
+                                            std::uint32_t index_count, std::uint32_t first_instance,
+                                            std::uint32_t instance_count) const {
+    if (skip_draws_) {
+        return;
+    }
+    if (first_instance + instance_count > settings_.max_instances) {
+        spdlog::error("Instances up to {} do not fit the {} instance transforms of a frame!",
+                      first_instance + instance_count, settings_.max_instances);
+        return;
+    }
+
+    const Frame &frame = buffered_frames_[current_frame_];
+    const std::array vertex_buffers = {vertex_buffer.buffer, frame.instance_buffer_handle.buffer};
+    constexpr std::array<VkDeviceSize, 2> offsets = {0, 0};
+    BindUniformSet(frame.command_buffer);
+    vkCmdBindVertexBuffers(frame.command_buffer, 0, vertex_buffers.size(), vertex_buffers.data(), offsets.data());
+    vkCmdBindIndexBuffer(frame.command_buffer, index_buffer.buffer, 0, VK_INDEX_TYPE_UINT32);
+    vkCmdDrawIndexed(frame.command_buffer, index_count, instance_count, 0, 0, first_instance);
+    SetModelMatrix(glm::mat4(1.0f));
+}
+
 void Graphics::SetModelMatrix(const glm::mat4 &model) const {
-    vkCmdPushConstants(buffered_frames_[current_frame_].command_buffer, pipeline_layout_, VK_SHADER_STAGE_VERTEX_BIT, 0,
+    vkCmdPushConstants(buffered_frames_[current_frame_].command_buffer, pipeline_layout_, push_constant_stages_, 0,
                        sizeof(model), &model);
 }
 
-void Graphics::SetViewProjection(const glm::mat4 &view, const glm::mat4 &proj) const {
+void Graphics::SetViewProjection(const glm::mat4 &view, const glm::mat4 &proj) {
+    view_frustum_ = Frustum::FromViewProjection(view, proj);
     UniformTransformations uniforms{view, proj};
     memcpy(buffered_frames_[current_frame_].uniform_buffer_location, &uniforms, sizeof(UniformTransformations));
 }
@@ -1166,7 +2189,12 @@ void Graphics::EndTransientCommandBuffer(VkCommandBuffer command_buffer) const {
 void Graphics::CreateUniformBuffers() {
     for (Frame &frame: buffered_frames_) {
         VkDeviceSize buffer_size = sizeof(UniformTransformations);
-        frame.uniform_buffer_handle = CreateBuffer(buffer_size, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+        // Descriptor buffers reference the uniforms by address.
+        VkBufferUsageFlags usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+        if (descriptor_buffer_supported_) {
+            usage |= VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+        }
+        frame.uniform_buffer_handle = CreateBuffer(buffer_size, usage,
                                                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
                                                    VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
 
@@ -1174,37 +2202,28 @@ void Graphics::CreateUniformBuffers() {
     }
 }
 
-void Graphics::CreateDescriptorSetLayouts() {
-    VkDescriptorSetLayoutBinding uniform_layout_binding = {};
-    uniform_layout_binding.binding = 0;
-    uniform_layout_binding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-    uniform_layout_binding.descriptorCount = 1;
-    uniform_layout_binding.stageFlags = VK_SHADER_STAGE_ALL_GRAPHICS;
-
-    VkDescriptorSetLayoutCreateInfo uniform_layout_info = {};
-    uniform_layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-    uniform_layout_info.bindingCount = 1;
-    uniform_layout_info.pBindings = &uniform_layout_binding;
-
-    if (vkCreateDescriptorSetLayout(device_, &uniform_layout_info, nullptr, &uniform_set_layout_) !=
-        VK_SUCCESS) {
-        spdlog::error("Failed to create descriptor set layout!");
-        std::exit(EXIT_FAILURE);
+void Graphics::CreateInstanceBuffers() {
+    for (Frame &frame: buffered_frames_) {
+        const VkDeviceSize buffer_size = sizeof(glm::mat4) * settings_.max_instances;
+        frame.instance_buffer_handle = CreateBuffer(buffer_size, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+                                                    VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                                    VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+
+        vkMapMemory(device_, frame.instance_buffer_handle.memory, 0, buffer_size, 0, &frame.instance_buffer_location);
     }
+}
 
-    VkDescriptorSetLayoutBinding texture_layout_binding = {};
-    texture_layout_binding.binding = 0;
-    texture_layout_binding.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-    texture_layout_binding.descriptorCount = 1;
-    texture_layout_binding.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+void Graphics::CreateDescriptorSetLayouts() {
+    layout_cache_.Initialize(device_);
 
-    VkDescriptorSetLayoutCreateInfo texture_layout_info = {};
-    texture_layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
-    texture_layout_info.bindingCount = 1;
-    texture_layout_info.pBindings = &texture_layout_binding;
+    // The per-frame camera uniforms live in set 0 and material textures in set 1 of the default shaders.
+    const std::optional<ShaderReflection> reflection = ReflectPipeline(PipelineDescription{});
+    if (reflection.has_value()) {
+        uniform_set_layout_ = layout_cache_.GetSetLayout(reflection.value(), 0, set_layout_flags_);
+        texture_set_layout_ = layout_cache_.GetSetLayout(reflection.value(), 1, set_layout_flags_);
+    }
 
-    if (vkCreateDescriptorSetLayout(device_, &texture_layout_info, nullptr, &texture_set_layout_) !=
-        VK_SUCCESS) {
+    if (uniform_set_layout_ == VK_NULL_HANDLE || texture_set_layout_ == VK_NULL_HANDLE) {
         spdlog::error("Failed to create descriptor set layout!");
         std::exit(EXIT_FAILURE);
     }
@@ -1277,6 +2296,90 @@ void Graphics::CreateDescriptorSets() {
     }
 }
 
+void Graphics::CreateDescriptorBuffer() {
+    constexpr VkDeviceSize kDescriptorBufferSize = 4 * 1024 * 1024;
+    // Combined image samplers count against the sampler limits as well as the resource ones.
+    const VkDeviceSize capacity = std::min({
+        kDescriptorBufferSize, descriptor_buffer_properties_.maxResourceDescriptorBufferRange,
+        descriptor_buffer_properties_.maxSamplerDescriptorBufferRange
+    });
+
+    descriptor_buffer_ = CreateBuffer(capacity,
+                                      VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT |
+                                      VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT |
+                                      VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+                                      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    vkMapMemory(device_, descriptor_buffer_.memory, 0, capacity, 0, &descriptor_buffer_location_);
+
+    VkBufferDeviceAddressInfo address_info = {};
+    address_info.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
+    address_info.buffer = descriptor_buffer_.buffer;
+    descriptor_buffer_address_ = vkGetBufferDeviceAddress(device_, &address_info);
+
+    descriptor_allocator_.Initialize(capacity, descriptor_buffer_properties_.descriptorBufferOffsetAlignment);
+
+    vkGetDescriptorSetLayoutSizeEXT(device_, texture_set_layout_, &texture_set_size_);
+    vkGetDescriptorSetLayoutBindingOffsetEXT(device_, texture_set_layout_, 0, &texture_binding_offset_);
+
+    VkDeviceSize uniform_set_size = 0;
+    VkDeviceSize uniform_binding_offset = 0;
+    vkGetDescriptorSetLayoutSizeEXT(device_, uniform_set_layout_, &uniform_set_size);
+    vkGetDescriptorSetLayoutBindingOffsetEXT(device_, uniform_set_layout_, 0, &uniform_binding_offset);
+
+    for (Frame &frame: buffered_frames_) {
+        const std::optional<VkDeviceSize> offset = descriptor_allocator_.Allocate(uniform_set_size);
+        if (!offset.has_value()) {
+            spdlog::error("Failed to allocate uniform descriptors!");
+            std::exit(EXIT_FAILURE);
+        }
+        frame.uniform_set_offset = offset.value();
+
+        VkBufferDeviceAddressInfo uniform_address_info = {};
+        uniform_address_info.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
+        uniform_address_info.buffer = frame.uniform_buffer_handle.buffer;
+
+        VkDescriptorAddressInfoEXT descriptor_address_info = {};
+        descriptor_address_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT;
+        descriptor_address_info.address = vkGetBufferDeviceAddress(device_, &uniform_address_info);
+        descriptor_address_info.range = sizeof(UniformTransformations);
+        descriptor_address_info.format = VK_FORMAT_UNDEFINED;
+
+        VkDescriptorGetInfoEXT descriptor_info = {};
+        descriptor_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT;
+        descriptor_info.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        descriptor_info.data.pUniformBuffer = &descriptor_address_info;
+
+        vkGetDescriptorEXT(device_, &descriptor_info, descriptor_buffer_properties_.uniformBufferDescriptorSize,
+                           static_cast<std::byte *>(descriptor_buffer_location_) + frame.uniform_set_offset +
+                           uniform_binding_offset);
+    }
+}
+
+void Graphics::BindDescriptorBuffer(VkCommandBuffer command_buffer) const {
+    if (!descriptor_buffer_supported_) {
+        return;
+    }
+
+    VkDescriptorBufferBindingInfoEXT binding_info = {};
+    binding_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT;
+    binding_info.address = descriptor_buffer_address_;
+    binding_info.usage = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT |
+                         VK_BUFFER_USAGE_SAMPLER_DESCRIPTOR_BUFFER_BIT_EXT;
+    vkCmdBindDescriptorBuffersEXT(command_buffer, 1, &binding_info);
+}
+
+void Graphics::BindUniformSet(VkCommandBuffer command_buffer) const {
+    if (descriptor_buffer_supported_) {
+        constexpr std::uint32_t buffer_index = 0;
+        vkCmdSetDescriptorBufferOffsetsEXT(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout_, 0, 1,
+                                           &buffer_index, &buffered_frames_[current_frame_].uniform_set_offset);
+        return;
+    }
+
+    vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout_, 0, 1,
+                            &buffered_frames_[current_frame_].uniform_set, 0, VK_NULL_HANDLE);
+}
+
 #pragma endregion
 
 #pragma region TEXTURE
@@ -1306,22 +2409,90 @@ void Graphics::CreateTextureSampler() {
     }
 }
 
+bool HasStencilComponent(const VkFormat format) {
+    return format == VK_FORMAT_D16_UNORM_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT ||
+           format == VK_FORMAT_D32_SFLOAT_S8_UINT;
+}
+
+void Graphics::ChooseDepthFormat() {
+    std::vector<VkFormat> candidates;
+    if (settings_.depth_bits <= 16) {
+        candidates.push_back(VK_FORMAT_D16_UNORM);
+    }
+    if (settings_.depth_bits <= 24) {
+        candidates.push_back(VK_FORMAT_X8_D24_UNORM_PACK32);
+        candidates.push_back(VK_FORMAT_D24_UNORM_S8_UINT);
+    }
+    candidates.push_back(VK_FORMAT_D32_SFLOAT);
+    candidates.push_back(VK_FORMAT_D32_SFLOAT_S8_UINT);
+
+    for (const VkFormat candidate: candidates) {
+        VkFormatProperties format_properties = {};
+        vkGetPhysicalDeviceFormatProperties(physical_device_, candidate, &format_properties);
+        if (format_properties.optimalTilingFeatures & VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT) {
+            depth_format_ = candidate;
+            return;
+        }
+    }
+
+    spdlog::error("Failed to find a supported depth format!");
+    std::exit(EXIT_FAILURE);
+}
+
 void Graphics::CreateDepthResources() {
-    VkFormat depth_format = VK_FORMAT_D32_SFLOAT;
-    depth_texture_ = CreateImage({extent_.width, extent_.height}, depth_format,
-                                 VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    // Depth is cleared on load and discarded on store, so it never needs to leave tile memory.
+    depth_texture_ = CreateImage({extent_.width, extent_.height}, depth_format_,
+                                 VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT,
+                                 VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT, msaa_samples_);
+
+    VkImageAspectFlags aspect_flags = VK_IMAGE_ASPECT_DEPTH_BIT;
+    if (HasStencilComponent(depth_format_)) {
+        aspect_flags |= VK_IMAGE_ASPECT_STENCIL_BIT;
+    }
+
+    depth_texture_.image_view = CreateImageView(depth_texture_.image, depth_format_, aspect_flags);
+}
 
-    depth_texture_.image_view = CreateImageView(depth_texture_.image, depth_format, VK_IMAGE_ASPECT_DEPTH_BIT);
+void Graphics::CreateSceneColorResources() {
+    const VkImageUsageFlags upscale_usage = blit_upscale_
+                                                ? VK_IMAGE_USAGE_TRANSFER_SRC_BIT
+                                                : VK_IMAGE_USAGE_SAMPLED_BIT;
+    scene_color_texture_ = CreateImage({extent_.width, extent_.height}, surface_format_.format,
+                                       VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | upscale_usage,
+                                       VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+
+    scene_color_texture_.image_view = CreateImageView(scene_color_texture_.image, surface_format_.format,
+                                                      VK_IMAGE_ASPECT_COLOR_BIT);
+
+    if (msaa_samples_ == VK_SAMPLE_COUNT_1_BIT) {
+        return;
+    }
+
+    // Only ever resolved from, so on tilers the samples can live entirely in tile memory.
+    msaa_color_texture_ = CreateImage({extent_.width, extent_.height}, surface_format_.format,
+                                      VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT,
+                                      VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT, msaa_samples_);
+
+    msaa_color_texture_.image_view = CreateImageView(msaa_color_texture_.image, surface_format_.format,
+                                                     VK_IMAGE_ASPECT_COLOR_BIT);
 }
 
 TextureHandle Graphics::CreateImage(const glm::ivec2 extent, VkFormat image_format, VkBufferUsageFlags usage,
-                                    VkMemoryPropertyFlags properties) const {
+                                    VkMemoryPropertyFlags properties, VkSampleCountFlagBits samples,
+                                    const bool compute_shared) const {
     TextureHandle handle = {};
 
+    const std::array queue_families = {graphics_family_, compute_family_};
+
     VkImageCreateInfo image_create_info = {};
     image_create_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
     image_create_info.usage = usage;
     image_create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    if (compute_shared && compute_family_ != graphics_family_) {
+        image_create_info.sharingMode = VK_SHARING_MODE_CONCURRENT;
+        image_create_info.queueFamilyIndexCount = queue_families.size();
+        image_create_info.pQueueFamilyIndices = queue_families.data();
+    }
     image_create_info.imageType = VK_IMAGE_TYPE_2D;
     image_create_info.extent.width = extent.x;
     image_create_info.extent.height = extent.y;
@@ -1331,7 +2502,7 @@ TextureHandle Graphics::CreateImage(const glm::ivec2 extent, VkFormat image_form
     image_create_info.format = image_format;
     image_create_info.tiling = VK_IMAGE_TILING_OPTIMAL;
     image_create_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    image_create_info.samples = VK_SAMPLE_COUNT_1_BIT;
+    image_create_info.samples = samples;
     image_create_info.flags = 0;
 
     if (vkCreateImage(device_, &image_create_info, VK_NULL_HANDLE, &handle.image) != VK_SUCCESS)
@@ -1340,17 +2511,26 @@ TextureHandle Graphics::CreateImage(const glm::ivec2 extent, VkFormat image_form
     VkMemoryRequirements memory_requirements;
     vkGetImageMemoryRequirements(device_, handle.image, &memory_requirements);
 
-    const std::uint32_t memory_type_index = FindMemoryType(memory_requirements.memoryTypeBits, properties);
+    std::optional<std::uint32_t> memory_type_index = TryFindMemoryType(memory_requirements.memoryTypeBits,
+                                                                       properties);
+    if (!memory_type_index.has_value() && (properties & VK_MEMORY_PROPERTY_LAZILY_ALLOCATED_BIT)) {
+        memory_type_index = TryFindMemoryType(memory_requirements.memoryTypeBits,
+                                              VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    }
+
+    if (!memory_type_index.has_value())
+        throw std::runtime_error("failed to find suitable memory type!");
 
     VkMemoryAllocateInfo memory_allocate_info = {};
     memory_allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
     memory_allocate_info.allocationSize = memory_requirements.size;
-    memory_allocate_info.memoryTypeIndex = memory_type_index;
+    memory_allocate_info.memoryTypeIndex = memory_type_index.value();
 
     if (vkAllocateMemory(device_, &memory_allocate_info, VK_NULL_HANDLE, &handle.memory) != VK_SUCCESS)
         throw std::runtime_error("failed to allocate image memory!");
 
     vkBindImageMemory(device_, handle.image, handle.memory, 0);
+    handle.compute_shared = compute_shared;
 
     return handle;
 }
@@ -1386,9 +2566,40 @@ TextureHandle Graphics::CreateTexture(gsl::czstring path) const {
     CopyBufferToImage(staging_buffer.buffer, texture_handle.image, image_extents);
     TransitionImageLayout(texture_handle.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
                           VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+    texture_handle.layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
 
     texture_handle.image_view = CreateImageView(texture_handle.image, VK_FORMAT_R8G8B8A8_SRGB,
                                                 VK_IMAGE_ASPECT_COLOR_BIT);
+    CreateTextureDescriptor(texture_handle, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    DestroyBuffer(staging_buffer);
+
+    return texture_handle;
+}
+
+void Graphics::CreateTextureDescriptor(TextureHandle &handle, const VkImageLayout layout) const {
+    VkDescriptorImageInfo descriptor_image_info = {};
+    descriptor_image_info.imageLayout = layout;
+    descriptor_image_info.imageView = handle.image_view;
+    descriptor_image_info.sampler = texture_sampler_;
+
+    if (descriptor_buffer_supported_) {
+        handle.descriptor_offset = descriptor_allocator_.Allocate(texture_set_size_);
+        if (!handle.descriptor_offset.has_value()) {
+            spdlog::error("Descriptor buffer is full!");
+            std::exit(EXIT_FAILURE);
+        }
+
+        VkDescriptorGetInfoEXT descriptor_info = {};
+        descriptor_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT;
+        descriptor_info.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        descriptor_info.data.pCombinedImageSampler = &descriptor_image_info;
+
+        vkGetDescriptorEXT(device_, &descriptor_info, descriptor_buffer_properties_.combinedImageSamplerDescriptorSize,
+                           static_cast<std::byte *>(descriptor_buffer_location_) + handle.descriptor_offset.value() +
+                           texture_binding_offset_);
+        return;
+    }
 
     VkDescriptorSetAllocateInfo descriptor_set_allocate_info = {};
     descriptor_set_allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
@@ -1396,20 +2607,14 @@ TextureHandle Graphics::CreateTexture(gsl::czstring path) const {
     descriptor_set_allocate_info.descriptorSetCount = 1;
     descriptor_set_allocate_info.pSetLayouts = &texture_set_layout_;
 
-    if (vkAllocateDescriptorSets(device_, &descriptor_set_allocate_info, &texture_handle.descriptor_set) !=
-        VK_SUCCESS) {
+    if (vkAllocateDescriptorSets(device_, &descriptor_set_allocate_info, &handle.descriptor_set) != VK_SUCCESS) {
         spdlog::error("Failed to allocate descriptor sets!");
         std::exit(EXIT_FAILURE);
     }
 
-    VkDescriptorImageInfo descriptor_image_info = {};
-    descriptor_image_info.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-    descriptor_image_info.imageView = texture_handle.image_view;
-    descriptor_image_info.sampler = texture_sampler_;
-
     VkWriteDescriptorSet descriptor_write = {};
     descriptor_write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    descriptor_write.dstSet = texture_handle.descriptor_set;
+    descriptor_write.dstSet = handle.descriptor_set;
     descriptor_write.dstBinding = 0;
     descriptor_write.dstArrayElement = 0;
     descriptor_write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
@@ -1417,57 +2622,37 @@ TextureHandle Graphics::CreateTexture(gsl::czstring path) const {
     descriptor_write.pImageInfo = &descriptor_image_info;
 
     vkUpdateDescriptorSets(device_, 1, &descriptor_write, 0, nullptr);
-
-    DestroyBuffer(staging_buffer);
-
-    return texture_handle;
 }
 
 void Graphics::TransitionImageLayout(VkImage image, VkImageLayout old_layout, VkImageLayout new_layout) const {
     VkCommandBuffer local_command_buffer = BeginTransientCommandBuffer();
 
-    VkImageMemoryBarrier barrier = {};
-    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    const ResourceState src_state = GetLayoutState(old_layout);
+    const ResourceState dst_state = GetLayoutState(new_layout);
+
+    VkImageMemoryBarrier2 barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+    barrier.srcStageMask = src_state.stages;
+    barrier.srcAccessMask = src_state.access;
+    barrier.dstStageMask = dst_state.stages;
+    barrier.dstAccessMask = dst_state.access;
     barrier.oldLayout = old_layout;
     barrier.newLayout = new_layout;
     barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     barrier.image = image;
+    barrier.subresourceRange.aspectMask = GetLayoutAspect(new_layout);
     barrier.subresourceRange.baseArrayLayer = 0;
     barrier.subresourceRange.baseMipLevel = 0;
     barrier.subresourceRange.levelCount = 1;
     barrier.subresourceRange.layerCount = 1;
 
-    VkPipelineStageFlags src_stage_flags = 0;
-    VkPipelineStageFlags dst_stage_flags = 0;
-
-    if (old_layout == VK_IMAGE_LAYOUT_UNDEFINED && new_layout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL) {
-        barrier.srcAccessMask = 0;
-        barrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        src_stage_flags = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-        dst_stage_flags = VK_PIPELINE_STAGE_TRANSFER_BIT;
-    } else if (old_layout == VK_IMAGE_LAYOUT_UNDEFINED && new_layout ==
-               VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL) {
-        barrier.srcAccessMask = 0;
-        barrier.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT |
-                                VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-        src_stage_flags = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
-        dst_stage_flags = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-    } else if (old_layout == VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL && new_layout ==
-               VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL) {
-        barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
-        barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
-        src_stage_flags = VK_PIPELINE_STAGE_TRANSFER_BIT;
-        dst_stage_flags = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
-    }
-
-    if (new_layout == VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL)
-        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
-    else
-        barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-
-    vkCmdPipelineBarrier(local_command_buffer, src_stage_flags, dst_stage_flags, 0, 0, nullptr, 0, nullptr, 1,
-                         &barrier);
+    VkDependencyInfo dependency_info = {};
+    dependency_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+    dependency_info.imageMemoryBarrierCount = 1;
+    dependency_info.pImageMemoryBarriers = &barrier;
+
+    vkCmdPipelineBarrier2KHR(local_command_buffer, &dependency_info);
 
     EndTransientCommandBuffer(local_command_buffer);
 }
@@ -1493,13 +2678,25 @@ void Graphics::CopyBufferToImage(VkBuffer buffer, VkImage image, glm::ivec2 size
 
 void Graphics::DestroyTexture(const TextureHandle &handle) const {
     vkDeviceWaitIdle(device_);
-    vkFreeDescriptorSets(device_, texture_pool_, 1, &handle.descriptor_set);
+    if (handle.descriptor_offset.has_value()) {
+        descriptor_allocator_.Free(handle.descriptor_offset.value(), texture_set_size_);
+    } else if (handle.descriptor_set != VK_NULL_HANDLE) {
+        vkFreeDescriptorSets(device_, texture_pool_, 1, &handle.descriptor_set);
+    }
     vkDestroyImageView(device_, handle.image_view, nullptr);
     vkDestroyImage(device_, handle.image, nullptr);
     vkFreeMemory(device_, handle.memory, nullptr);
 }
 
 void Graphics::SetTexture(const TextureHandle &handle) const {
+    if (handle.descriptor_offset.has_value()) {
+        constexpr std::uint32_t buffer_index = 0;
+        vkCmdSetDescriptorBufferOffsetsEXT(buffered_frames_[current_frame_].command_buffer,
+                                           VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout_, 1, 1, &buffer_index,
+                                           &handle.descriptor_offset.value());
+        return;
+    }
+
     vkCmdBindDescriptorSets(buffered_frames_[current_frame_].command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
                             pipeline_layout_, 1, 1,
                             &handle.descriptor_set, 0, VK_NULL_HANDLE);
@@ -1507,59 +2704,636 @@ void Graphics::SetTexture(const TextureHandle &handle) const {
 
 #pragma endregion
 
+#pragma region COMPUTE
+
+constexpr std::uint32_t kComputeDescriptorSetsPerFrame = 64;
+
+void Graphics::CreateComputeResources() {
+    VkCommandPoolCreateInfo command_pool_create_info = {};
+    command_pool_create_info.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    command_pool_create_info.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    command_pool_create_info.queueFamilyIndex = compute_family_;
+
+    if (vkCreateCommandPool(device_, &command_pool_create_info, nullptr, &compute_command_pool_) != VK_SUCCESS) {
+        spdlog::error("failed to create compute command pool!");
+        std::exit(EXIT_FAILURE);
+    }
+
+    VkCommandBufferAllocateInfo command_buffer_allocate_info = {};
+    command_buffer_allocate_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    command_buffer_allocate_info.commandPool = compute_command_pool_;
+    command_buffer_allocate_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    command_buffer_allocate_info.commandBufferCount = 1;
+
+    VkSemaphoreCreateInfo semaphore_create_info = {};
+    semaphore_create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+    const std::array pool_sizes = {
+        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, kComputeDescriptorSetsPerFrame * 4},
+        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, kComputeDescriptorSetsPerFrame},
+        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, kComputeDescriptorSetsPerFrame},
+        VkDescriptorPoolSize{VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, kComputeDescriptorSetsPerFrame},
+    };
+
+    VkDescriptorPoolCreateInfo descriptor_pool_info = {};
+    descriptor_pool_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    descriptor_pool_info.poolSizeCount = pool_sizes.size();
+    descriptor_pool_info.pPoolSizes = pool_sizes.data();
+    descriptor_pool_info.maxSets = kComputeDescriptorSetsPerFrame;
+
+    VkSemaphoreTypeCreateInfo semaphore_type_info = {};
+    semaphore_type_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+    semaphore_type_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    semaphore_type_info.initialValue = graphics_timeline_value_;
+
+    VkSemaphoreCreateInfo timeline_create_info = {};
+    timeline_create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    timeline_create_info.pNext = &semaphore_type_info;
+
+    if (vkCreateSemaphore(device_, &timeline_create_info, nullptr, &graphics_timeline_semaphore_) != VK_SUCCESS) {
+        spdlog::error("Failed to create graphics timeline semaphore!");
+        std::exit(EXIT_FAILURE);
+    }
+
+    for (Frame &buffered_frame: buffered_frames_) {
+        if (vkAllocateCommandBuffers(device_, &command_buffer_allocate_info,
+                                     &buffered_frame.compute_command_buffer) != VK_SUCCESS) {
+            spdlog::error("failed to allocate compute command buffers!");
+            std::exit(EXIT_FAILURE);
+        }
+
+        if (vkCreateSemaphore(device_, &semaphore_create_info, nullptr,
+                              &buffered_frame.compute_finished_semaphore) != VK_SUCCESS) {
+            std::exit(EXIT_FAILURE);
+        }
+
+        // Dispatch descriptor sets only live for one frame, so the whole pool is reset instead of freeing them.
+        if (vkCreateDescriptorPool(device_, &descriptor_pool_info, nullptr,
+                                   &buffered_frame.compute_descriptor_pool) != VK_SUCCESS) {
+            spdlog::error("Failed to create descriptor pool!");
+            std::exit(EXIT_FAILURE);
+        }
+    }
+}
+
+ComputePipelineHandle Graphics::CreateComputePipeline(const std::string_view shader_name) const {
+    const ShaderCode code = shader_registry_.Find(shader_name);
+    if (code.IsEmpty()) {
+        spdlog::error("Failed to find shader {}!", shader_name);
+        return {};
+    }
+
+    const std::optional<ShaderReflection> reflection = ReflectShader(code.words);
+    if (!reflection.has_value() || reflection->stages != VK_SHADER_STAGE_COMPUTE_BIT) {
+        spdlog::error("{} is not a compute shader!", shader_name);
+        return {};
+    }
+
+    ComputePipelineHandle handle = {};
+    handle.layout = layout_cache_.GetPipelineLayout(reflection.value());
+    if (handle.layout == VK_NULL_HANDLE) {
+        return {};
+    }
+    for (std::uint32_t set = 0; set < reflection->GetSetCount(); ++set) {
+        handle.set_layouts.push_back(layout_cache_.GetSetLayout(reflection.value(), set));
+    }
+    handle.bindings = reflection->bindings;
+    handle.push_constants = reflection->push_constants;
+
+    VkShaderModule shader_module = CreateShaderModule(code.words);
+    if (shader_module == VK_NULL_HANDLE) {
+        return {};
+    }
+
+    VkComputePipelineCreateInfo pipeline_create_info = {};
+    pipeline_create_info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+    pipeline_create_info.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+    pipeline_create_info.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    pipeline_create_info.stage.module = shader_module;
+    pipeline_create_info.stage.pName = "main";
+    pipeline_create_info.layout = handle.layout;
+
+    const VkResult result = vkCreateComputePipelines(device_, vulkan_pipeline_cache_, 1, &pipeline_create_info,
+                                                     nullptr, &handle.pipeline);
+    vkDestroyShaderModule(device_, shader_module, nullptr);
+    if (result != VK_SUCCESS) {
+        spdlog::error("Failed to create compute pipeline for {}!", shader_name);
+        return {};
+    }
+
+    return handle;
+}
+
+void Graphics::DestroyComputePipeline(const ComputePipelineHandle &handle) const {
+    vkDeviceWaitIdle(device_);
+    vkDestroyPipeline(device_, handle.pipeline, nullptr);
+}
+
+VkCommandBuffer Graphics::GetComputeCommandBuffer() {
+    Frame &frame = buffered_frames_[current_frame_];
+    if (frame.compute_recorded) {
+        // Consecutive dispatches of a frame commonly consume each other's output.
+        VkMemoryBarrier2 barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2;
+        barrier.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+        barrier.srcAccessMask = VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+        barrier.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+        barrier.dstAccessMask = VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT;
+
+        VkDependencyInfo dependency_info = {};
+        dependency_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+        dependency_info.memoryBarrierCount = 1;
+        dependency_info.pMemoryBarriers = &barrier;
+        vkCmdPipelineBarrier2KHR(frame.compute_command_buffer, &dependency_info);
+        return frame.compute_command_buffer;
+    }
+
+    vkResetCommandBuffer(frame.compute_command_buffer, 0);
+    VkCommandBufferBeginInfo begin_info = {};
+    begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    begin_info.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+
+    if (vkBeginCommandBuffer(frame.compute_command_buffer, &begin_info) != VK_SUCCESS) {
+        throw std::runtime_error("failed to begin compute command buffer");
+    }
+    frame.compute_recorded = true;
+    return frame.compute_command_buffer;
+}
+
+void Graphics::Dispatch(const ComputePipelineHandle &pipeline, const std::span<const ComputeBinding> bindings,
+                        const glm::uvec3 group_count, const std::span<const std::byte> push_constants) {
+    if (!pipeline.IsValid()) {
+        return;
+    }
+
+    // Info structs are referenced by the writes, so they must not move while those are collected.
+    std::vector<VkDescriptorBufferInfo> buffer_infos;
+    std::vector<VkDescriptorImageInfo> image_infos;
+    buffer_infos.reserve(bindings.size());
+    image_infos.reserve(bindings.size());
+    std::vector<VkWriteDescriptorSet> writes;
+    std::vector<VkDescriptorSet> sets(pipeline.set_layouts.size(), VK_NULL_HANDLE);
+    const auto allocate_set = [&](const std::uint32_t set) {
+        VkDescriptorSetAllocateInfo allocate_info = {};
+        allocate_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocate_info.descriptorPool = buffered_frames_[current_frame_].compute_descriptor_pool;
+        allocate_info.descriptorSetCount = 1;
+        allocate_info.pSetLayouts = &pipeline.set_layouts[set];
+
+        if (vkAllocateDescriptorSets(device_, &allocate_info, &sets[set]) != VK_SUCCESS) {
+            spdlog::error("Out of compute descriptor sets this frame, skipping dispatch");
+            return false;
+        }
+        return true;
+    };
+
+    for (const ComputeBinding &binding: bindings) {
+        const auto declared = std::ranges::find_if(pipeline.bindings, [&binding](const ReflectedBinding &reflected) {
+            return reflected.set == binding.set && reflected.binding == binding.binding;
+        });
+        if (declared == pipeline.bindings.end()) {
+            spdlog::error("Compute shader has no binding {} in set {}, skipping dispatch", binding.binding,
+                          binding.set);
+            return;
+        }
+
+        if (sets[binding.set] == VK_NULL_HANDLE && !allocate_set(binding.set)) {
+            return;
+        }
+
+        VkWriteDescriptorSet write = {};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = sets[binding.set];
+        write.dstBinding = binding.binding;
+        write.descriptorType = declared->type;
+        write.descriptorCount = 1;
+
+        switch (declared->type) {
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+                buffer_infos.push_back({binding.buffer.buffer, 0, VK_WHOLE_SIZE});
+                write.pBufferInfo = &buffer_infos.back();
+                break;
+            case VK_DESCRIPTOR_TYPE_STORAGE_IMAGE:
+            case VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER: {
+                const TextureHandle &image = binding.image;
+                // Exclusive images belong to the graphics family and cannot be accessed from a separate one.
+                if (!image.compute_shared && compute_family_ != graphics_family_) {
+                    spdlog::error("Image for binding {} in set {} is not shared with the compute queue, skipping "
+                                  "dispatch", binding.binding, binding.set);
+                    return;
+                }
+                const bool storage = declared->type == VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+                if (storage ? image.layout != VK_IMAGE_LAYOUT_GENERAL : image.layout == VK_IMAGE_LAYOUT_UNDEFINED) {
+                    spdlog::error("Image for binding {} in set {} is not in a layout the binding can use, skipping "
+                                  "dispatch", binding.binding, binding.set);
+                    return;
+                }
+                image_infos.push_back({texture_sampler_, image.image_view, image.layout});
+                write.pImageInfo = &image_infos.back();
+                break;
+            }
+            default:
+                spdlog::error("Unsupported compute descriptor type {}, skipping dispatch",
+                              static_cast<std::int32_t>(declared->type));
+                return;
+        }
+        writes.push_back(write);
+    }
+
+    // Sets without bindings still have to be bound; the ones the shader does not use are empty anyway.
+    for (std::uint32_t set = 0; set < sets.size(); ++set) {
+        if (sets[set] == VK_NULL_HANDLE && !allocate_set(set)) {
+            return;
+        }
+    }
+
+    vkUpdateDescriptorSets(device_, writes.size(), writes.data(), 0, nullptr);
+
+    VkCommandBuffer command_buffer = GetComputeCommandBuffer();
+    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline.pipeline);
+    if (!sets.empty()) {
+        vkCmdBindDescriptorSets(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline.layout, 0, sets.size(),
+                                sets.data(), 0, nullptr);
+    }
+    if (pipeline.push_constants.has_value() && !push_constants.empty()) {
+        const VkPushConstantRange &range = pipeline.push_constants.value();
+        vkCmdPushConstants(command_buffer, pipeline.layout, range.stageFlags, range.offset,
+                           std::min<std::uint32_t>(push_constants.size(), range.size), push_constants.data());
+    }
+    vkCmdDispatch(command_buffer, group_count.x, group_count.y, group_count.z);
+}
+
+BufferHandle Graphics::CreateStorageBuffer(const VkDeviceSize size, const VkBufferUsageFlags additional_usage) const {
+    return CreateBuffer(size, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | additional_usage,
+                        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, true);
+}
+
+TextureHandle Graphics::CreateStorageImage(const glm::ivec2 extent, const VkFormat format) const {
+    TextureHandle texture_handle = CreateImage(extent, format,
+                                               VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+                                               VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, VK_SAMPLE_COUNT_1_BIT, true);
+
+    TransitionImageLayout(texture_handle.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_GENERAL);
+    texture_handle.layout = VK_IMAGE_LAYOUT_GENERAL;
+    texture_handle.image_view = CreateImageView(texture_handle.image, format, VK_IMAGE_ASPECT_COLOR_BIT);
+    CreateTextureDescriptor(texture_handle, VK_IMAGE_LAYOUT_GENERAL);
+
+    return texture_handle;
+}
+
+#pragma endregion
+
+#pragma region SHADER_OBJECTS
+
+// VK_EXT_shader_object provides every dynamic state command regardless of the extended dynamic state features.
+constexpr DynamicStateSupport kShaderObjectDynamicState = {true, true, true};
+
+ShaderObjects Graphics::CreateShaderObjects(const PipelineDescription &description) const {
+    const ShaderCode vertex_code = shader_registry_.Find(description.vertex_shader);
+    const ShaderCode fragment_code = shader_registry_.Find(description.fragment_shader);
+    if (vertex_code.IsEmpty() || fragment_code.IsEmpty()) {
+        spdlog::error("Failed to find shaders {} / {}!", description.vertex_shader, description.fragment_shader);
+        return {};
+    }
+
+    const std::optional<ShaderReflection> reflection = ReflectPipeline(description);
+    if (!reflection.has_value()) {
+        return {};
+    }
+
+    // The same set layouts as pipelines get, so descriptor sets bound through pipeline_layout_ stay compatible.
+    std::vector<VkDescriptorSetLayout> set_layouts;
+    for (std::uint32_t set = 0; set < reflection->GetSetCount(); ++set) {
+        set_layouts.push_back(layout_cache_.GetSetLayout(reflection.value(), set, set_layout_flags_));
+        if (set_layouts.back() == VK_NULL_HANDLE) {
+            return {};
+        }
+    }
+
+    const ShaderSpecialization specialization(description.shader_features);
+
+    VkShaderCreateInfoEXT vertex_create_info = {};
+    vertex_create_info.sType = VK_STRUCTURE_TYPE_SHADER_CREATE_INFO_EXT;
+    vertex_create_info.flags = VK_SHADER_CREATE_LINK_STAGE_BIT_EXT;
+    vertex_create_info.stage = VK_SHADER_STAGE_VERTEX_BIT;
+    vertex_create_info.nextStage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    vertex_create_info.codeType = VK_SHADER_CODE_TYPE_SPIRV_EXT;
+    vertex_create_info.codeSize = vertex_code.words.size_bytes();
+    vertex_create_info.pCode = vertex_code.words.data();
+    vertex_create_info.pName = "main";
+    vertex_create_info.setLayoutCount = set_layouts.size();
+    vertex_create_info.pSetLayouts = set_layouts.data();
+    if (reflection->push_constants.has_value()) {
+        vertex_create_info.pushConstantRangeCount = 1;
+        vertex_create_info.pPushConstantRanges = &reflection->push_constants.value();
+    }
+    vertex_create_info.pSpecializationInfo = specialization.GetInfo();
+
+    VkShaderCreateInfoEXT fragment_create_info = vertex_create_info;
+    fragment_create_info.stage = VK_SHADER_STAGE_FRAGMENT_BIT;
+    fragment_create_info.nextStage = 0;
+    fragment_create_info.codeSize = fragment_code.words.size_bytes();
+    fragment_create_info.pCode = fragment_code.words.data();
+
+    const std::array create_infos = {vertex_create_info, fragment_create_info};
+    std::array<VkShaderEXT, 2> shaders = {};
+    if (vkCreateShadersEXT(device_, create_infos.size(), create_infos.data(), nullptr, shaders.data()) !=
+        VK_SUCCESS) {
+        spdlog::error("Failed to create shader objects for {} / {}!", description.vertex_shader,
+                      description.fragment_shader);
+        for (VkShaderEXT shader: shaders) {
+            if (shader != VK_NULL_HANDLE) {
+                vkDestroyShaderEXT(device_, shader, nullptr);
+            }
+        }
+        return {};
+    }
+
+    return {shaders[0], shaders[1], VertexLayout::FromReflection(reflection.value())};
+}
+
+bool Graphics::BindShaderObjects(const PipelineDescription &description) {
+    const ShaderObjects &shaders = shader_object_cache_.GetOrCreate(description,
+                                                                    [this](const PipelineDescription &missing) {
+                                                                        return CreateShaderObjects(missing);
+                                                                    });
+    skip_draws_ = !shaders.IsValid();
+    if (skip_draws_) {
+        return false;
+    }
+
+    VkCommandBuffer command_buffer = buffered_frames_[current_frame_].command_buffer;
+    if (shaders.vertex != bound_shaders_.vertex || shaders.fragment != bound_shaders_.fragment) {
+        constexpr std::array stages = {VK_SHADER_STAGE_VERTEX_BIT, VK_SHADER_STAGE_FRAGMENT_BIT};
+        const std::array bound = {shaders.vertex, shaders.fragment};
+        vkCmdBindShadersEXT(command_buffer, stages.size(), stages.data(), bound.data());
+        bound_shaders_.vertex = shaders.vertex;
+        bound_shaders_.fragment = shaders.fragment;
+    }
+
+    SetVertexInput(command_buffer, description.vertex_layout.attributes.empty()
+                                       ? shaders.vertex_layout
+                                       : description.vertex_layout);
+    dynamic_state_.Apply(command_buffer, description, kShaderObjectDynamicState);
+    return true;
+}
+
+void Graphics::SetVertexInput(VkCommandBuffer command_buffer, const VertexLayout &vertex_layout) {
+    if (bound_vertex_layout_ == vertex_layout) {
+        return;
+    }
+
+    std::vector<VkVertexInputBindingDescription2EXT> bindings;
+    for (const VkVertexInputBindingDescription &binding: vertex_layout.bindings) {
+        VkVertexInputBindingDescription2EXT description = {};
+        description.sType = VK_STRUCTURE_TYPE_VERTEX_INPUT_BINDING_DESCRIPTION_2_EXT;
+        description.binding = binding.binding;
+        description.stride = binding.stride;
+        description.inputRate = binding.inputRate;
+        description.divisor = 1;
+        bindings.push_back(description);
+    }
+
+    std::vector<VkVertexInputAttributeDescription2EXT> attributes;
+    for (const VkVertexInputAttributeDescription &attribute: vertex_layout.attributes) {
+        VkVertexInputAttributeDescription2EXT description = {};
+        description.sType = VK_STRUCTURE_TYPE_VERTEX_INPUT_ATTRIBUTE_DESCRIPTION_2_EXT;
+        description.location = attribute.location;
+        description.binding = attribute.binding;
+        description.format = attribute.format;
+        description.offset = attribute.offset;
+        attributes.push_back(description);
+    }
+
+    vkCmdSetVertexInputEXT(command_buffer, bindings.size(), bindings.data(), attributes.size(), attributes.data());
+    bound_vertex_layout_ = vertex_layout;
+}
+
+void Graphics::SetShaderObjectState(VkCommandBuffer command_buffer) const {
+    const VkViewport viewport = GetViewport();
+    const VkRect2D scissor = GetScissor();
+    vkCmdSetViewportWithCountEXT(command_buffer, 1, &viewport);
+    vkCmdSetScissorWithCountEXT(command_buffer, 1, &scissor);
+
+    // Everything the pipelines bake in without it being part of PipelineDescription.
+    vkCmdSetRasterizerDiscardEnableEXT(command_buffer, VK_FALSE);
+    vkCmdSetPolygonModeEXT(command_buffer, VK_POLYGON_MODE_FILL);
+    vkCmdSetLineWidth(command_buffer, 1.0f);
+    vkCmdSetDepthClampEnableEXT(command_buffer, VK_FALSE);
+    vkCmdSetDepthBiasEnableEXT(command_buffer, VK_FALSE);
+    vkCmdSetDepthBoundsTestEnableEXT(command_buffer, VK_FALSE);
+    vkCmdSetStencilTestEnableEXT(command_buffer, VK_FALSE);
+    vkCmdSetRasterizationSamplesEXT(command_buffer, msaa_samples_);
+    constexpr VkSampleMask sample_mask = ~0u;
+    vkCmdSetSampleMaskEXT(command_buffer, msaa_samples_, &sample_mask);
+    vkCmdSetAlphaToCoverageEnableEXT(command_buffer, VK_FALSE);
+    constexpr VkColorComponentFlags color_write_mask =
+            VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+    vkCmdSetColorWriteMaskEXT(command_buffer, 0, 1, &color_write_mask);
+}
+
+void Graphics::BeginRendering(VkCommandBuffer command_buffer) const {
+    const bool multisampled = msaa_samples_ != VK_SAMPLE_COUNT_1_BIT;
+
+    // What the scene render pass does through its initial layouts and external dependency.
+    std::vector<VkImageMemoryBarrier2> barriers;
+    const auto transition = [&barriers](VkImage image, const VkImageAspectFlags aspect,
+                                        const VkPipelineStageFlags2 stages, const VkAccessFlags2 access,
+                                        const VkImageLayout layout) {
+        VkImageMemoryBarrier2 barrier = {};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+        barrier.srcStageMask = stages | VK_PIPELINE_STAGE_2_TRANSFER_BIT;
+        barrier.srcAccessMask = VK_ACCESS_2_NONE;
+        barrier.dstStageMask = stages;
+        barrier.dstAccessMask = access;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = layout;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange = {aspect, 0, 1, 0, 1};
+        barriers.push_back(barrier);
+    };
+
+    constexpr VkPipelineStageFlags2 color_stages = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+    constexpr VkAccessFlags2 color_access = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
+    transition(scene_color_texture_.image, VK_IMAGE_ASPECT_COLOR_BIT, color_stages, color_access,
+               VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    if (multisampled) {
+        transition(msaa_color_texture_.image, VK_IMAGE_ASPECT_COLOR_BIT, color_stages, color_access,
+                   VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    }
+
+    VkImageAspectFlags depth_aspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+    if (HasStencilComponent(depth_format_)) {
+        depth_aspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+    }
+    transition(depth_texture_.image, depth_aspect,
+               VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+               VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+               VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+
+    VkDependencyInfo dependency_info = {};
+    dependency_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+    dependency_info.imageMemoryBarrierCount = barriers.size();
+    dependency_info.pImageMemoryBarriers = barriers.data();
+    vkCmdPipelineBarrier2KHR(command_buffer, &dependency_info);
+
+    VkRenderingAttachmentInfo color_attachment = {};
+    color_attachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+    color_attachment.imageView = multisampled ? msaa_color_texture_.image_view : scene_color_texture_.image_view;
+    color_attachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    color_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    color_attachment.storeOp = multisampled ? VK_ATTACHMENT_STORE_OP_DONT_CARE : VK_ATTACHMENT_STORE_OP_STORE;
+    color_attachment.clearValue.color = {0.0f, 0.0f, 0.0f, 1.0f};
+    if (multisampled) {
+        color_attachment.resolveMode = VK_RESOLVE_MODE_AVERAGE_BIT;
+        color_attachment.resolveImageView = scene_color_texture_.image_view;
+        color_attachment.resolveImageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    }
+
+    VkRenderingAttachmentInfo depth_attachment = {};
+    depth_attachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
+    depth_attachment.imageView = depth_texture_.image_view;
+    depth_attachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    depth_attachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depth_attachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depth_attachment.clearValue.depthStencil = {1.0f, 0};
+
+    VkRenderingInfo rendering_info = {};
+    rendering_info.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
+    rendering_info.renderArea.offset = {0, 0};
+    rendering_info.renderArea.extent = render_extent_;
+    rendering_info.layerCount = 1;
+    rendering_info.colorAttachmentCount = 1;
+    rendering_info.pColorAttachments = &color_attachment;
+    rendering_info.pDepthAttachment = &depth_attachment;
+
+    vkCmdBeginRenderingKHR(command_buffer, &rendering_info);
+}
+
+void Graphics::EndRendering(VkCommandBuffer command_buffer) const {
+    vkCmdEndRenderingKHR(command_buffer);
+
+    // Leaves the scene target where the render pass's final layout would have, ready for the upscale.
+    const ResourceState upscale_read = GetAccessState(GetSceneColorAccess());
+    VkImageMemoryBarrier2 barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+    barrier.srcStageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+    barrier.srcAccessMask = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
+    barrier.dstStageMask = upscale_read.stages;
+    barrier.dstAccessMask = upscale_read.access;
+    barrier.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    barrier.newLayout = upscale_read.layout;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = scene_color_texture_.image;
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+
+    VkDependencyInfo dependency_info = {};
+    dependency_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+    dependency_info.imageMemoryBarrierCount = 1;
+    dependency_info.pImageMemoryBarriers = &barrier;
+    vkCmdPipelineBarrier2KHR(command_buffer, &dependency_info);
+}
+
+#pragma endregion
+
 #pragma region CLASS
 
-Graphics::Graphics(const gsl::not_null<GLFW_Window *> window): window_(window) {
+Graphics::Graphics(const gsl::not_null<GLFW_Window *> window, const GraphicsSettings &settings): window_(window),
+    settings_(settings), pipeline_workers_(settings.pipeline_compile_threads),
+    shader_registry_(settings.shader_override_directory) {
 #if !defined(NDEBUG)
     validation_ = true;
 #endif
+    dynamic_resolution_.SetSettings(settings_.dynamic_resolution);
     InitializeVulkan();
 }
 
 Graphics::~Graphics() {
+    // Compiles still running on the workers use the device, so they have to finish before anything is destroyed.
+    pipeline_workers_.Shutdown();
+
     if (device_ != VK_NULL_HANDLE) {
         vkDeviceWaitIdle(device_);
 
         CleanupSwapchain();
 
-        DestroyTexture(depth_texture_);
-
         if (texture_sampler_ != VK_NULL_HANDLE)
             vkDestroySampler(device_, texture_sampler_, nullptr);
 
+        if (upscale_sampler_ != VK_NULL_HANDLE)
+            vkDestroySampler(device_, upscale_sampler_, nullptr);
+
+        if (upscale_descriptor_pool_ != VK_NULL_HANDLE)
+            vkDestroyDescriptorPool(device_, upscale_descriptor_pool_, VK_NULL_HANDLE);
+
+        if (upscale_pipeline_ != VK_NULL_HANDLE)
+            vkDestroyPipeline(device_, upscale_pipeline_, VK_NULL_HANDLE);
+
+        if (upscale_render_pass_ != VK_NULL_HANDLE)
+            vkDestroyRenderPass(device_, upscale_render_pass_, VK_NULL_HANDLE);
+
         if (texture_pool_ != VK_NULL_HANDLE)
             vkDestroyDescriptorPool(device_, texture_pool_, VK_NULL_HANDLE);
 
-        if (texture_set_layout_ != VK_NULL_HANDLE)
-            vkDestroyDescriptorSetLayout(device_, texture_set_layout_, VK_NULL_HANDLE);
-
         if (uniform_pool_ != VK_NULL_HANDLE)
             vkDestroyDescriptorPool(device_, uniform_pool_, VK_NULL_HANDLE);
 
+        if (descriptor_buffer_.buffer != VK_NULL_HANDLE) {
+            spdlog::info("Descriptor buffer: {} of {} bytes in use", descriptor_allocator_.GetUsedSize(),
+                         descriptor_allocator_.GetCapacity());
+            DestroyBuffer(descriptor_buffer_);
+        }
+
         for (Frame &buffered_frame: buffered_frames_) {
             DestroyBuffer(buffered_frame.uniform_buffer_handle);
+            DestroyBuffer(buffered_frame.instance_buffer_handle);
 
             if (buffered_frame.image_available_semaphore != VK_NULL_HANDLE)
                 vkDestroySemaphore(device_, buffered_frame.image_available_semaphore, VK_NULL_HANDLE);
 
-            if (buffered_frame.render_finished_semaphore != VK_NULL_HANDLE)
-                vkDestroySemaphore(device_, buffered_frame.render_finished_semaphore, VK_NULL_HANDLE);
-
             if (buffered_frame.still_rendering_fence != VK_NULL_HANDLE)
                 vkDestroyFence(device_, buffered_frame.still_rendering_fence, VK_NULL_HANDLE);
-        }
 
-        if (uniform_set_layout_ != VK_NULL_HANDLE)
-            vkDestroyDescriptorSetLayout(device_, uniform_set_layout_, VK_NULL_HANDLE);
+            if (buffered_frame.timestamp_query_pool != VK_NULL_HANDLE)
+                vkDestroyQueryPool(device_, buffered_frame.timestamp_query_pool, VK_NULL_HANDLE);
+
+            if (buffered_frame.compute_finished_semaphore != VK_NULL_HANDLE)
+                vkDestroySemaphore(device_, buffered_frame.compute_finished_semaphore, VK_NULL_HANDLE);
+
+            if (buffered_frame.compute_descriptor_pool != VK_NULL_HANDLE)
+                vkDestroyDescriptorPool(device_, buffered_frame.compute_descriptor_pool, VK_NULL_HANDLE);
+
+            buffered_frame.transient_pool.Destroy();
+        }
 
         if (command_pool_ != VK_NULL_HANDLE)
             vkDestroyCommandPool(device_, command_pool_, VK_NULL_HANDLE);
 
-        if (graphics_pipeline_ != VK_NULL_HANDLE)
-            vkDestroyPipeline(device_, graphics_pipeline_, VK_NULL_HANDLE);
+        if (compute_command_pool_ != VK_NULL_HANDLE)
+            vkDestroyCommandPool(device_, compute_command_pool_, VK_NULL_HANDLE);
+
+        if (graphics_timeline_semaphore_ != VK_NULL_HANDLE)
+            vkDestroySemaphore(device_, graphics_timeline_semaphore_, VK_NULL_HANDLE);
+
+        spdlog::info("Pipeline cache: {} pipelines, {} hits, {} misses", pipeline_cache_.GetPipelineCount(),
+                     pipeline_cache_.GetHitCount(), pipeline_cache_.GetMissCount());
+        spdlog::info("Dynamic state: {} commands recorded, {} redundant ones skipped", dynamic_state_.GetSetCount(),
+                     dynamic_state_.GetSkippedCount());
+        pipeline_cache_.Destroy(device_);
+        if (render_backend_ == RenderBackend::ShaderObjects) {
+            spdlog::info("Shader objects: {} shader pairs", shader_object_cache_.GetShaderPairCount());
+        }
+        shader_object_cache_.Destroy(device_);
+        pipeline_library_.Destroy();
+
+        if (vulkan_pipeline_cache_ != VK_NULL_HANDLE)
+            vkDestroyPipelineCache(device_, vulkan_pipeline_cache_, VK_NULL_HANDLE);
 
-        if (pipeline_layout_ != VK_NULL_HANDLE)
-            vkDestroyPipelineLayout(device_, pipeline_layout_, VK_NULL_HANDLE);
+        layout_cache_.Destroy();
 
         if (render_pass_ != VK_NULL_HANDLE)
             vkDestroyRenderPass(device_, render_pass_, VK_NULL_HANDLE);
@@ -1583,6 +3357,8 @@ void Graphics::InitializeVulkan() {
     SetupDebugMessenger();
     CreateSurface();
     PickPhysicalDevice();
+    ChooseSampleCount();
+    ChooseDepthFormat();
     CreateLogicalDeviceAndQueues();
     CreateSwapChain();
     CreateImageViews();
@@ -1590,16 +3366,25 @@ void Graphics::InitializeVulkan() {
     CreateDescriptorSetLayouts();
     CreateGraphicsPipeline();
     CreateDepthResources();
+    CreateSceneColorResources();
     CreateFramebuffers();
+    CreateUpscalePass();
+    CreateUpscaleFramebuffers();
     CreateCommandPool();
     CreateCommandBuffer();
     CreateSignals();
+    CreateComputeResources();
+    CreateTimestampQueries();
+    CreateTransientPools();
     CreateUniformBuffers();
-    CreateDescriptorPools();
-    CreateDescriptorSets();
+    CreateInstanceBuffers();
+    if (descriptor_buffer_supported_) {
+        CreateDescriptorBuffer();
+    } else {
+        CreateDescriptorPools();
+        CreateDescriptorSets();
+    }
     CreateTextureSampler();
-    TransitionImageLayout(depth_texture_.image, VK_IMAGE_LAYOUT_UNDEFINED,
-                          VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
 }
 
 #pragma endregion
@@ -9,46 +9,157 @@
 #include <gsl/algorithm>
 
 #include "buffer_handle.h"
+#include "compute_pipeline.h"
+#include "descriptor_buffer.h"
+#include "dynamic_resolution.h"
+#include "dynamic_state.h"
+#include "frustum_culling.h"
+#include "layout_cache.h"
+#include "packed_vertex.h"
+#include "pipeline_cache.h"
+#include "pipeline_library.h"
+#include "render_graph.h"
+#include "shader_object_cache.h"
+#include "shader_registry.h"
 #include "vertex.h"
 #include "texture_handle.h"
+#include "transient_resource_pool.h"
 
 namespace veng {
 struct Frame {
     VkSemaphore image_available_semaphore = VK_NULL_HANDLE;
-    VkSemaphore render_finished_semaphore = VK_NULL_HANDLE;
     VkFence still_rendering_fence = VK_NULL_HANDLE;
 
     VkCommandBuffer command_buffer = VK_NULL_HANDLE;
 
     VkDescriptorSet uniform_set = VK_NULL_HANDLE;
+    // Where the uniform set lives instead when descriptor buffers are in use.
+    VkDeviceSize uniform_set_offset = 0;
     BufferHandle uniform_buffer_handle;
     void *uniform_buffer_location;
+    // Host-visible per-instance world matrices, read by instanced draws through vertex binding 1.
+    BufferHandle instance_buffer_handle;
+    void *instance_buffer_location = nullptr;
+
+    VkQueryPool timestamp_query_pool = VK_NULL_HANDLE;
+    bool timestamps_written = false;
+
+    // Recorded lazily by the first dispatch of the frame and submitted ahead of the graphics work, which waits on
+    // compute_finished_semaphore for it.
+    VkCommandBuffer compute_command_buffer = VK_NULL_HANDLE;
+    VkSemaphore compute_finished_semaphore = VK_NULL_HANDLE;
+    VkDescriptorPool compute_descriptor_pool = VK_NULL_HANDLE;
+    bool compute_recorded = false;
+
+    // Backs the frame graph's transient resources; per frame so a placement is never rebuilt while still in use.
+    TransientResourcePool transient_pool;
+};
+
+enum class RenderBackend : std::uint8_t {
+    // Pipeline objects drawn inside the scene render pass.
+    Pipelines,
+    // VK_EXT_shader_object with every state set dynamically, drawn with dynamic rendering.
+    ShaderObjects
+};
+
+struct GraphicsSettings {
+    // Clamped to what the device supports for both color and depth attachments.
+    VkSampleCountFlagBits msaa_samples = VK_SAMPLE_COUNT_4_BIT;
+    // Smallest depth precision the scene needs; cheaper formats are picked whenever they cover it.
+    std::uint32_t depth_bits = 24;
+    DynamicResolutionSettings dynamic_resolution{};
+    // Workers compiling pipelines requested through CompilePipelineAsync; zero picks a count from the CPU.
+    std::uint32_t pipeline_compile_threads = 0;
+    // Builds pipelines from shared VK_EXT_graphics_pipeline_library parts when the device supports it.
+    bool use_pipeline_libraries = true;
+    // Relinks library-built pipelines with link-time optimization on the compile workers and swaps them in.
+    bool optimize_linked_pipelines = true;
+    // Sets cull mode, front face, topology, depth test, primitive restart and blending per draw when the device
+    // supports the extended dynamic state extensions, instead of creating a pipeline per combination.
+    bool use_extended_dynamic_state = true;
+    // Writes graphics descriptors straight into a VK_EXT_descriptor_buffer buffer instead of allocating sets from
+    // descriptor pools, when the device supports it.
+    bool use_descriptor_buffers = true;
+    // Runs dispatches on a compute-only queue family when the device has one, overlapping them with graphics work.
+    bool use_async_compute = true;
+    // Picked once at startup; ShaderObjects falls back to Pipelines on devices without the extension.
+    RenderBackend render_backend = RenderBackend::Pipelines;
+    // World matrices each frame's instance buffer holds.
+    std::uint32_t max_instances = 262144;
+    // Compiled "<name>.spv" files found here replace the shaders built into the executable. Empty disables lookups.
+    std::filesystem::path shader_override_directory{};
 };
 
 class Graphics final {
 public:
-    explicit Graphics(gsl::not_null<GLFW_Window *> window);
+    explicit Graphics(gsl::not_null<GLFW_Window *> window, const GraphicsSettings &settings = {});
 
     ~Graphics();
 
     bool BeginFrame();
     void SetModelMatrix(const glm::mat4 &model) const;
-    void SetViewProjection(const glm::mat4 &view, const glm::mat4 &proj) const;
+    // Also updates the frustum returned by GetViewFrustum.
+    void SetViewProjection(const glm::mat4 &view, const glm::mat4 &proj);
     void SetTexture(const TextureHandle &handle) const;
     void RenderBuffer(BufferHandle buffer_handle, std::uint32_t vertex_count) const;
     void RenderIndexedBuffer(BufferHandle vertex_buffer, BufferHandle index_buffer, std::uint32_t index_count) const;
+    // World matrices of the current frame's instances, mapped GPU memory to write directly between BeginFrame and
+    // EndFrame, e.g. with TransformStore::WriteWorldMatrices.
+    [[nodiscard]] std::span<glm::mat4> GetInstanceTransforms() const;
+    // Draws instances [first_instance, first_instance + instance_count) of GetInstanceTransforms with a pipeline
+    // using VertexLayout::FromInstancedVertex, such as one with "instanced.vert".
+    void RenderIndexedBufferInstanced(BufferHandle vertex_buffer, BufferHandle index_buffer, std::uint32_t index_count,
+                                      std::uint32_t first_instance, std::uint32_t instance_count) const;
     void EndFrame();
 
+    // Pipelines are created on first request and shared by every caller asking for an equal description.
+    VkPipeline GetPipeline(const PipelineDescription &description);
+    // Binds the pipeline for the following draws of the current frame.
+    void SetPipeline(const PipelineDescription &description);
+    [[nodiscard]] const PipelineCache &GetPipelineCache() const;
+    [[nodiscard]] RenderBackend GetRenderBackend() const;
+    // Planes of the last SetViewProjection, for culling objects before they get drawn.
+    [[nodiscard]] const Frustum &GetViewFrustum() const;
+
+    // Starts compiling on a worker thread without blocking the frame.
+    PipelineHandle CompilePipelineAsync(const PipelineDescription &description);
+    // Bound in place of pipelines that are still compiling. Without one, their draws are skipped instead.
+    void SetFallbackPipeline(const PipelineDescription &description);
+    // Binds the pipeline if it is ready, otherwise the fallback; returns false when the following draws get skipped.
+    // Pipelines that failed to compile keep taking that path without recompiling until RetryFailedPipelines.
+    bool TrySetPipeline(const PipelineDescription &description);
+    // Compiles pipelines that failed again on their next use, e.g. after fixing a shader in the override directory.
+    void RetryFailedPipelines();
+
+    // Compute work is recorded between BeginFrame and EndFrame; the frame's draws see its results. It starts once the
+    // previous frame's draws finished, so resources shared between both need no per-frame copies.
+    [[nodiscard]] ComputePipelineHandle CreateComputePipeline(std::string_view shader_name) const;
+    void DestroyComputePipeline(const ComputePipelineHandle &handle) const;
+    void Dispatch(const ComputePipelineHandle &pipeline, std::span<const ComputeBinding> bindings,
+                  glm::uvec3 group_count, std::span<const std::byte> push_constants = {});
+    // Device local and accessible from both queues; `additional_usage` lets draws consume the results directly.
+    [[nodiscard]] BufferHandle CreateStorageBuffer(VkDeviceSize size, VkBufferUsageFlags additional_usage = 0) const;
+    // Stays in VK_IMAGE_LAYOUT_GENERAL and can be bound with SetTexture as well.
+    [[nodiscard]] TextureHandle CreateStorageImage(glm::ivec2 extent, VkFormat format) const;
+
     [[nodiscard]] BufferHandle CreateVertexBuffer(gsl::span<Vertex> vertices) const;
+    // Draw with PackedMesh::dequantization multiplied into the model matrix.
+    [[nodiscard]] BufferHandle CreateVertexBuffer(gsl::span<const PackedVertex> vertices) const;
     [[nodiscard]] BufferHandle CreateIndexBuffer(gsl::span<std::uint32_t> indices) const;
     void DestroyBuffer(BufferHandle handle) const;
     TextureHandle CreateTexture(gsl::czstring path) const;
     void DestroyTexture(const TextureHandle &handle) const;
 
+    void SetDynamicResolution(const DynamicResolutionSettings &settings);
+    [[nodiscard]] std::float_t GetRenderScale() const;
+    [[nodiscard]] VkSampleCountFlagBits GetSampleCount() const;
+
 private:
     struct QueueFamilyIndices {
         std::optional<std::uint32_t> graphics_family = std::nullopt;
         std::optional<std::uint32_t> present_family = std::nullopt;
+        // A compute-only family when async compute is enabled and available, the graphics family otherwise.
+        std::optional<std::uint32_t> compute_family = std::nullopt;
 
         [[nodiscard]] bool IsValid() const {
             return graphics_family.has_value() && present_family.has_value();
@@ -72,6 +183,8 @@ private:
     void CreateInstance();
     void SetupDebugMessenger();
     void PickPhysicalDevice();
+    void ChooseSampleCount();
+    void ChooseDepthFormat();
     void CreateLogicalDeviceAndQueues();
     void CreateSurface();
     void CreateSwapChain();
@@ -82,20 +195,44 @@ private:
     void CreateFramebuffers();
     void CreateCommandPool();
     void CreateCommandBuffer();
+    void CreateComputeResources();
     void CreateSignals();
     void CreateDescriptorSetLayouts();
     void CreateDescriptorPools();
     void CreateDescriptorSets();
+    void CreateDescriptorBuffer();
 
     void RecreateSwapchain();
     void CleanupSwapchain();
     void CreateTextureSampler();
     void CreateDepthResources();
+    void CreateSceneColorResources();
+    void CreateTimestampQueries();
+    void CreateTransientPools();
+    void CreateUpscalePass();
+    void CreateUpscaleFramebuffers();
 
     // Rendering
 
-    void BeginCommands() const;
-    void EndCommands() const;
+    void BeginCommands();
+    void EndCommands();
+    void BlitSceneToSwapchain(VkCommandBuffer command_buffer) const;
+    // Fullscreen triangle sampling the scene target, for surface formats or swapchains that cannot be blitted to.
+    void DrawSceneToSwapchain(VkCommandBuffer command_buffer) const;
+    [[nodiscard]] RenderGraphAccess GetSceneColorAccess() const;
+    [[nodiscard]] VkPipelineStageFlags2 GetUpscaleStage() const;
+    // Shader object counterparts of the render pass and pipeline binding.
+    void BeginRendering(VkCommandBuffer command_buffer) const;
+    void EndRendering(VkCommandBuffer command_buffer) const;
+    void SetShaderObjectState(VkCommandBuffer command_buffer) const;
+    bool BindShaderObjects(const PipelineDescription &description);
+    void SetVertexInput(VkCommandBuffer command_buffer, const VertexLayout &vertex_layout);
+    void UpdateRenderScale();
+    void BindDescriptorBuffer(VkCommandBuffer command_buffer) const;
+    void BindUniformSet(VkCommandBuffer command_buffer) const;
+    // Gives the texture its set 1 descriptor, from the texture pool or the descriptor buffer.
+    void CreateTextureDescriptor(TextureHandle &handle, VkImageLayout layout) const;
+    [[nodiscard]] VkCommandBuffer GetComputeCommandBuffer();
 
     [[nodiscard]] std::vector<gsl::czstring> GetRequiredInstanceExtensions() const;
     static gsl::span<gsl::czstring> GetSuggestedInstanceExtensions();
@@ -116,25 +253,42 @@ private:
     static VkPresentModeKHR ChooseSwapchainPresentMode(gsl::span<VkPresentModeKHR> present_modes);
     [[nodiscard]] VkExtent2D ChooseSwapchainExtent(const VkSurfaceCapabilitiesKHR &capabilities) const;
     static std::uint32_t ChooseImageCount(const VkSurfaceCapabilitiesKHR &capabilities);
-
-    [[nodiscard]] VkShaderModule CreateShaderModule(gsl::span<std::uint8_t> buffer) const;
-
+    void ChooseUpscaleMethod(const VkSurfaceCapabilitiesKHR &capabilities);
+
+    [[nodiscard]] VkShaderModule CreateShaderModule(std::span<const std::uint32_t> code) const;
+    [[nodiscard]] std::optional<ShaderReflection> ReflectPipeline(const PipelineDescription &description) const;
+    // Monolithic unless pipeline libraries are in use; then `optimize` picks link-time optimization over fast linking.
+    [[nodiscard]] VkPipeline CreatePipeline(const PipelineDescription &description, bool optimize = false) const;
+    [[nodiscard]] ShaderObjects CreateShaderObjects(const PipelineDescription &description) const;
+    [[nodiscard]] VkPipeline LinkPipeline(std::span<const VkPipeline> libraries, VkPipelineLayout layout,
+                                          bool optimize) const;
+
+    [[nodiscard]] std::optional<std::uint32_t> TryFindMemoryType(std::uint32_t memory_type_bits,
+                                                                 VkMemoryPropertyFlags properties) const;
     [[nodiscard]] std::uint32_t FindMemoryType(std::uint32_t memory_type_bits, VkMemoryPropertyFlags properties) const;
 
-    [[nodiscard]] BufferHandle CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties) const;
+    [[nodiscard]] BufferHandle CreateVertexBufferFromBytes(gsl::span<const std::byte> data) const;
+    // `compute_shared` resources are used from the compute queue too and get concurrent sharing when it is separate.
+    [[nodiscard]] BufferHandle CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties,
+                                            bool compute_shared = false) const;
     [[nodiscard]] VkCommandBuffer BeginTransientCommandBuffer() const;
     void EndTransientCommandBuffer(VkCommandBuffer command_buffer) const;
     void CreateUniformBuffers();
+    void CreateInstanceBuffers();
 
     [[nodiscard]] TextureHandle CreateImage(glm::ivec2 extent, VkFormat image_format, VkBufferUsageFlags usage,
-                              VkMemoryPropertyFlags properties) const;
+                              VkMemoryPropertyFlags properties,
+                              VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT,
+                              bool compute_shared = false) const;
     void TransitionImageLayout(VkImage image, VkImageLayout old_layout, VkImageLayout new_layout) const;
     void CopyBufferToImage(VkBuffer buffer, VkImage image, glm::ivec2 size) const;
 
     [[nodiscard]] VkViewport GetViewport() const;
     [[nodiscard]] VkRect2D GetScissor() const;
 
-    std::array<gsl::czstring, 1> required_device_extensions_ = {VK_KHR_SWAPCHAIN_EXTENSION_NAME};
+    std::array<gsl::czstring, 2> required_device_extensions_ = {
+        VK_KHR_SWAPCHAIN_EXTENSION_NAME, VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME
+    };
 
     VkInstance instance_ = VK_NULL_HANDLE;
     VkDebugUtilsMessengerEXT debug_messenger_{};
@@ -143,22 +297,73 @@ private:
     VkDevice device_ = VK_NULL_HANDLE;
     VkQueue graphics_queue_ = VK_NULL_HANDLE;
     VkQueue present_queue_ = VK_NULL_HANDLE;
+    VkQueue compute_queue_ = VK_NULL_HANDLE;
+    std::uint32_t graphics_family_ = 0;
+    std::uint32_t compute_family_ = 0;
 
     VkSurfaceKHR surface_ = VK_NULL_HANDLE;
     VkSwapchainKHR swap_chain_ = VK_NULL_HANDLE;
+    // Set while the window is minimized; BeginFrame retries the recreation until it has a size again.
+    bool swapchain_out_of_date_ = false;
     VkSurfaceFormatKHR surface_format_{};
     VkPresentModeKHR present_mode_{};
     VkExtent2D extent_{};
 
     std::vector<VkImage> swap_chain_images_;
     std::vector<VkImageView> swap_chain_image_views_;
-    std::vector<VkFramebuffer> swap_chain_framebuffers_;
-
+    // Signaled by the frame rendering into the image and waited on by its presentation.
+    std::vector<VkSemaphore> render_finished_semaphores_;
+
+    // Whether the surface format and swapchain usage allow vkCmdBlitImage; the fullscreen pass below is used otherwise.
+    bool blit_upscale_ = true;
+    // Nearest when the surface format cannot be filtered linearly.
+    VkFilter upscale_filter_ = VK_FILTER_LINEAR;
+    VkRenderPass upscale_render_pass_ = VK_NULL_HANDLE;
+    std::vector<VkFramebuffer> upscale_framebuffers_;
+    VkPipelineLayout upscale_pipeline_layout_ = VK_NULL_HANDLE;
+    VkPipeline upscale_pipeline_ = VK_NULL_HANDLE;
+    VkSampler upscale_sampler_ = VK_NULL_HANDLE;
+    VkDescriptorPool upscale_descriptor_pool_ = VK_NULL_HANDLE;
+    VkDescriptorSet upscale_descriptor_set_ = VK_NULL_HANDLE;
+
+    TextureHandle scene_color_texture_;
+    TextureHandle msaa_color_texture_;
+    VkSampleCountFlagBits msaa_samples_ = VK_SAMPLE_COUNT_1_BIT;
+    VkFormat depth_format_ = VK_FORMAT_D32_SFLOAT;
+    VkFramebuffer scene_framebuffer_ = VK_NULL_HANDLE;
+    VkExtent2D render_extent_{};
+    DynamicResolution dynamic_resolution_;
+    Frustum view_frustum_;
+    RenderGraph frame_graph_;
+    bool timestamps_supported_ = false;
+    std::float_t timestamp_period_ = 0.0f;
+
+    // Layout of the default pipeline; the engine's descriptor sets and push constants are bound through it.
     VkPipelineLayout pipeline_layout_ = VK_NULL_HANDLE;
+    VkShaderStageFlags push_constant_stages_ = 0;
+    // Mutable because pipelines, and with them their layouts, are created from const paths and worker threads.
+    mutable PipelineLayoutCache layout_cache_;
     VkRenderPass render_pass_ = VK_NULL_HANDLE;
     VkPipeline graphics_pipeline_ = VK_NULL_HANDLE;
+    VkPipeline bound_pipeline_ = VK_NULL_HANDLE;
+    VkPipeline fallback_pipeline_ = VK_NULL_HANDLE;
+    bool skip_draws_ = false;
+    PipelineCache pipeline_cache_;
+    bool pipeline_library_supported_ = false;
+    DynamicStateSupport dynamic_state_support_{};
+    DynamicStateTracker dynamic_state_;
+    RenderBackend render_backend_ = RenderBackend::Pipelines;
+    ShaderObjectCache shader_object_cache_;
+    ShaderObjects bound_shaders_{};
+    std::optional<VertexLayout> bound_vertex_layout_;
+    mutable PipelineLibraryCache pipeline_library_;
+    VkPipelineCache vulkan_pipeline_cache_ = VK_NULL_HANDLE;
 
     VkCommandPool command_pool_ = VK_NULL_HANDLE;
+    VkCommandPool compute_command_pool_ = VK_NULL_HANDLE;
+    // Signaled with an increasing value by every frame's graphics submission; compute submissions wait on the last.
+    VkSemaphore graphics_timeline_semaphore_ = VK_NULL_HANDLE;
+    std::uint64_t graphics_timeline_value_ = 0;
 
     std::uint32_t current_image_index_ = 0;
 
@@ -167,6 +372,18 @@ private:
 
     VkDescriptorSetLayout texture_set_layout_ = VK_NULL_HANDLE;
     VkDescriptorPool texture_pool_ = VK_NULL_HANDLE;
+
+    // Set layouts and pipelines are created for descriptor buffers when these are set.
+    bool descriptor_buffer_supported_ = false;
+    VkDescriptorSetLayoutCreateFlags set_layout_flags_ = 0;
+    VkPipelineCreateFlags pipeline_create_flags_ = 0;
+    VkPhysicalDeviceDescriptorBufferPropertiesEXT descriptor_buffer_properties_{};
+    BufferHandle descriptor_buffer_;
+    void *descriptor_buffer_location_ = nullptr;
+    VkDeviceAddress descriptor_buffer_address_ = 0;
+    mutable DescriptorBufferAllocator descriptor_allocator_;
+    VkDeviceSize texture_set_size_ = 0;
+    VkDeviceSize texture_binding_offset_ = 0;
     VkSampler texture_sampler_ = VK_NULL_HANDLE;
     TextureHandle depth_texture_;
 
@@ -174,6 +391,9 @@ private:
     std::int32_t current_frame_ = 0;
 
     gsl::not_null<GLFW_Window *> window_;
+    GraphicsSettings settings_;
+    ThreadPool pipeline_workers_;
+    ShaderRegistry shader_registry_;
     bool validation_ = false;
 };
 } // veng
@@ -0,0 +1,203 @@
+#include "job_system.h"
+
+#include <algorithm>
+#include <precomp.h>
+
+namespace veng {
+struct QueuedJob {
+    JobSystem::Job function;
+    JobCounter *counter = nullptr;
+};
+
+namespace {
+// The job system whose deque the current thread owns, so jobs submitted from inside jobs stay on that thread.
+thread_local const JobSystem *current_system = nullptr;
+thread_local std::uint32_t current_deque = 0;
+thread_local std::uint32_t random_state = 0;
+
+// xorshift32; only used to pick steal victims.
+std::uint32_t NextRandom() {
+    if (random_state == 0) {
+        random_state = static_cast<std::uint32_t>(std::hash<std::thread::id>{}(std::this_thread::get_id())) | 1u;
+    }
+    random_state ^= random_state << 13;
+    random_state ^= random_state >> 17;
+    random_state ^= random_state << 5;
+    return random_state;
+}
+}
+
+bool JobCounter::IsDone() const {
+    return pending_.load(std::memory_order_acquire) == 0;
+}
+
+JobSystem::JobSystem(std::uint32_t worker_count) {
+    if (worker_count == kDefaultWorkerCount) {
+        worker_count = std::max(std::thread::hardware_concurrency(), 1u) - 1;
+    }
+
+    deques_.reserve(worker_count + 1);
+    for (std::uint32_t i = 0; i <= worker_count; ++i) {
+        deques_.push_back(std::make_unique<WorkStealingDeque<QueuedJob>>());
+    }
+    current_system = this;
+    current_deque = 0;
+
+    workers_.reserve(worker_count);
+    for (std::uint32_t i = 1; i <= worker_count; ++i) {
+        workers_.emplace_back(&JobSystem::WorkerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard lock(sleep_mutex_);
+        stopping_ = true;
+    }
+    job_available_.notify_all();
+
+    for (std::thread &worker: workers_) {
+        worker.join();
+    }
+    while (QueuedJob *job = FindJob()) {
+        delete job;
+    }
+    if (current_system == this) {
+        current_system = nullptr;
+    }
+}
+
+void JobSystem::Submit(Job job, JobCounter *counter, JobCounter *dependency) {
+    if (counter != nullptr) {
+        counter->pending_.fetch_add(1, std::memory_order_relaxed);
+    }
+    auto *queued_job = new QueuedJob{std::move(job), counter};
+
+    if (dependency != nullptr) {
+        std::lock_guard lock(dependency->continuations_mutex_);
+        if (dependency->pending_.load(std::memory_order_acquire) != 0) {
+            dependency->continuations_.push_back(queued_job);
+            return;
+        }
+    }
+    Schedule(queued_job);
+}
+
+void JobSystem::Wait(JobCounter &counter) {
+    while (!counter.IsDone()) {
+        if (QueuedJob *job = FindJob()) {
+            Run(job);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+    // The last job may still be releasing the lock it decremented the count under.
+    std::lock_guard lock(counter.continuations_mutex_);
+}
+
+void JobSystem::ParallelFor(const std::size_t count, const std::size_t grain, const RangeJob &job) {
+    const std::size_t chunk_size = std::max<std::size_t>(grain, 1);
+    JobCounter counter;
+    for (std::size_t begin = 0; begin < count; begin += chunk_size) {
+        const std::size_t end = std::min(count, begin + chunk_size);
+        Submit([&job, begin, end] { job(begin, end); }, &counter);
+    }
+    Wait(counter);
+}
+
+std::size_t JobSystem::GetWorkerCount() const {
+    return workers_.size();
+}
+
+void JobSystem::WorkerLoop(const std::uint32_t deque_index) {
+    current_system = this;
+    current_deque = deque_index;
+
+    while (!stopping_.load()) {
+        if (QueuedJob *job = FindJob()) {
+            Run(job);
+            continue;
+        }
+
+        // Schedule checks for sleepers after counting its job, and the predicate checks for jobs after counting this
+        // sleeper, so one of them always sees the other.
+        std::unique_lock lock(sleep_mutex_);
+        sleeping_workers_.fetch_add(1);
+        job_available_.wait(lock, [this] { return stopping_.load() || queued_jobs_.load() > 0; });
+        sleeping_workers_.fetch_sub(1);
+    }
+}
+
+void JobSystem::Schedule(QueuedJob *job) {
+    queued_jobs_.fetch_add(1);
+    if (const std::uint32_t deque_index = GetCurrentDequeIndex(); deque_index != kNoDeque) {
+        deques_[deque_index]->Push(job);
+    } else {
+        std::lock_guard lock(shared_mutex_);
+        shared_jobs_.push_back(job);
+    }
+
+    if (sleeping_workers_.load() > 0) {
+        {
+            std::lock_guard lock(sleep_mutex_);
+        }
+        job_available_.notify_one();
+    }
+}
+
+QueuedJob *JobSystem::FindJob() {
+    if (queued_jobs_.load() <= 0) {
+        return nullptr;
+    }
+
+    const std::uint32_t own_deque = GetCurrentDequeIndex();
+    QueuedJob *job = own_deque != kNoDeque ? deques_[own_deque]->Pop() : nullptr;
+
+    // Starting at a random victim spreads the thieves over the deques.
+    const auto deque_count = static_cast<std::uint32_t>(deques_.size());
+    const std::uint32_t first_victim = NextRandom() % deque_count;
+    for (std::uint32_t offset = 0; job == nullptr && offset < deque_count; ++offset) {
+        const std::uint32_t victim = (first_victim + offset) % deque_count;
+        if (victim != own_deque) {
+            job = deques_[victim]->Steal();
+        }
+    }
+
+    if (job == nullptr) {
+        std::lock_guard lock(shared_mutex_);
+        if (!shared_jobs_.empty()) {
+            job = shared_jobs_.front();
+            shared_jobs_.pop_front();
+        }
+    }
+
+    if (job != nullptr) {
+        queued_jobs_.fetch_sub(1);
+    }
+    return job;
+}
+
+void JobSystem::Run(QueuedJob *job) {
+    job->function();
+    JobCounter *counter = job->counter;
+    delete job;
+    if (counter == nullptr) {
+        return;
+    }
+
+    std::vector<QueuedJob *> ready;
+    {
+        std::lock_guard lock(counter->continuations_mutex_);
+        if (counter->pending_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            ready.swap(counter->continuations_);
+        }
+    }
+    for (QueuedJob *continuation: ready) {
+        Schedule(continuation);
+    }
+}
+
+std::uint32_t JobSystem::GetCurrentDequeIndex() const {
+    return current_system == this ? current_deque : kNoDeque;
+}
+} // veng
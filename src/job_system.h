@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "work_stealing_deque.h"
+
+namespace veng {
+struct QueuedJob;
+
+// Counts the unfinished jobs submitted with it. Jobs can wait on it without blocking a thread, either by depending
+// on it when submitted or through JobSystem::Wait. Must outlive the jobs it counts.
+class JobCounter final {
+public:
+    JobCounter() = default;
+    JobCounter(const JobCounter &) = delete;
+    JobCounter &operator=(const JobCounter &) = delete;
+
+    [[nodiscard]] bool IsDone() const;
+
+private:
+    friend class JobSystem;
+
+    std::atomic<std::uint32_t> pending_ = 0;
+    // Guards the count reaching zero as well, so a waiter cannot destroy the counter while the last job still uses it.
+    std::mutex continuations_mutex_;
+    // Jobs submitted with this counter as their dependency while it was still pending.
+    std::vector<QueuedJob *> continuations_;
+};
+
+// Work-stealing scheduler for short CPU jobs such as culling, transform updates, texture decoding and command
+// recording. Every worker owns a Chase-Lev deque it pushes to and pops from, and steals from the others when it runs
+// dry. The thread that creates the system gets a deque too and runs jobs while it waits, so it is never idle. Other
+// threads may submit as well; their jobs go through a shared queue.
+class JobSystem final {
+public:
+    using Job = std::function<void()>;
+    using RangeJob = std::function<void(std::size_t begin, std::size_t end)>;
+
+    // One worker per hardware thread besides the creating one.
+    static constexpr std::uint32_t kDefaultWorkerCount = std::numeric_limits<std::uint32_t>::max();
+
+    // With zero workers every job runs on the creating thread, inside Wait.
+    explicit JobSystem(std::uint32_t worker_count = kDefaultWorkerCount);
+    // Jobs still queued are dropped.
+    ~JobSystem();
+
+    JobSystem(const JobSystem &) = delete;
+    JobSystem &operator=(const JobSystem &) = delete;
+
+    // `counter`, if any, counts the job until it finished. With a `dependency` the job only starts once every job
+    // counted by it finished.
+    void Submit(Job job, JobCounter *counter = nullptr, JobCounter *dependency = nullptr);
+    // Runs other jobs on the calling thread until every job counted by `counter` finished. The counter may be
+    // destroyed once this returns.
+    void Wait(JobCounter &counter);
+    // Calls `job` on chunks of at most `grain` indices covering [0, count) and returns once all of them are done.
+    void ParallelFor(std::size_t count, std::size_t grain, const RangeJob &job);
+
+    // Not counting the creating thread.
+    [[nodiscard]] std::size_t GetWorkerCount() const;
+
+private:
+    static constexpr std::uint32_t kNoDeque = std::numeric_limits<std::uint32_t>::max();
+
+    void WorkerLoop(std::uint32_t deque_index);
+    void Schedule(QueuedJob *job);
+    [[nodiscard]] QueuedJob *FindJob();
+    void Run(QueuedJob *job);
+    [[nodiscard]] std::uint32_t GetCurrentDequeIndex() const;
+
+    // Index 0 belongs to the creating thread, the rest to the workers in order.
+    std::vector<std::unique_ptr<WorkStealingDeque<QueuedJob>>> deques_;
+    std::vector<std::thread> workers_;
+
+    // Jobs from threads without a deque.
+    std::mutex shared_mutex_;
+    std::deque<QueuedJob *> shared_jobs_;
+
+    // Jobs sitting in any queue, so idle workers know whether there is anything to look for.
+    std::atomic<std::int64_t> queued_jobs_ = 0;
+    std::atomic<std::uint32_t> sleeping_workers_ = 0;
+    std::mutex sleep_mutex_;
+    std::condition_variable job_available_;
+    std::atomic<bool> stopping_ = false;
+};
+} // veng
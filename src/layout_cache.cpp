@@ -0,0 +1,140 @@
+#include "layout_cache.h"
+
+#include <precomp.h>
+#include <spdlog/spdlog.h>
+
+#include "utilities.h"
+
+namespace veng {
+std::size_t DescriptorSetLayoutKeyHash::operator()(const DescriptorSetLayoutKey &key) const {
+    std::size_t seed = 0;
+    for (const ReflectedBinding &binding: key.bindings) {
+        HashCombine(seed, binding.binding);
+        HashCombine(seed, binding.type);
+        HashCombine(seed, binding.count);
+        HashCombine(seed, binding.stages);
+    }
+    HashCombine(seed, key.flags);
+    return seed;
+}
+
+std::size_t PipelineLayoutKeyHash::operator()(const PipelineLayoutKey &key) const {
+    std::size_t seed = 0;
+    for (VkDescriptorSetLayout set_layout: key.set_layouts) {
+        HashCombine(seed, set_layout);
+    }
+    HashCombine(seed, key.push_constant_stages);
+    HashCombine(seed, key.push_constant_offset);
+    HashCombine(seed, key.push_constant_size);
+    return seed;
+}
+
+void PipelineLayoutCache::Initialize(const VkDevice device) {
+    device_ = device;
+}
+
+void PipelineLayoutCache::Destroy() {
+    std::lock_guard lock(mutex_);
+    for (const auto &[key, pipeline_layout]: pipeline_layouts_) {
+        vkDestroyPipelineLayout(device_, pipeline_layout, VK_NULL_HANDLE);
+    }
+    for (const auto &[key, set_layout]: set_layouts_) {
+        vkDestroyDescriptorSetLayout(device_, set_layout, VK_NULL_HANDLE);
+    }
+    pipeline_layouts_.clear();
+    set_layouts_.clear();
+}
+
+VkDescriptorSetLayout PipelineLayoutCache::GetSetLayout(const ShaderReflection &reflection, const std::uint32_t set,
+                                                        const VkDescriptorSetLayoutCreateFlags flags) {
+    std::lock_guard lock(mutex_);
+    return GetSetLayoutLocked(reflection, set, flags);
+}
+
+VkDescriptorSetLayout PipelineLayoutCache::GetSetLayoutLocked(const ShaderReflection &reflection,
+                                                              const std::uint32_t set,
+                                                              const VkDescriptorSetLayoutCreateFlags flags) {
+    DescriptorSetLayoutKey key;
+    key.flags = flags;
+    for (const ReflectedBinding &binding: reflection.bindings) {
+        if (binding.set == set) {
+            key.bindings.push_back(binding);
+            key.bindings.back().set = 0;
+        }
+    }
+
+    if (const auto it = set_layouts_.find(key); it != set_layouts_.end()) {
+        return it->second;
+    }
+
+    std::vector<VkDescriptorSetLayoutBinding> layout_bindings;
+    layout_bindings.reserve(key.bindings.size());
+    for (const ReflectedBinding &binding: key.bindings) {
+        VkDescriptorSetLayoutBinding layout_binding = {};
+        layout_binding.binding = binding.binding;
+        layout_binding.descriptorType = binding.type;
+        layout_binding.descriptorCount = binding.count;
+        layout_binding.stageFlags = binding.stages;
+        layout_bindings.push_back(layout_binding);
+    }
+
+    VkDescriptorSetLayoutCreateInfo layout_info = {};
+    layout_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layout_info.flags = flags;
+    layout_info.bindingCount = layout_bindings.size();
+    layout_info.pBindings = layout_bindings.data();
+
+    VkDescriptorSetLayout set_layout = VK_NULL_HANDLE;
+    if (vkCreateDescriptorSetLayout(device_, &layout_info, nullptr, &set_layout) != VK_SUCCESS) {
+        spdlog::error("Failed to create descriptor set layout for set {}!", set);
+        return VK_NULL_HANDLE;
+    }
+
+    set_layouts_.emplace(std::move(key), set_layout);
+    return set_layout;
+}
+
+VkPipelineLayout PipelineLayoutCache::GetPipelineLayout(const ShaderReflection &reflection,
+                                                        const VkDescriptorSetLayoutCreateFlags flags) {
+    std::lock_guard lock(mutex_);
+
+    PipelineLayoutKey key;
+    const std::uint32_t set_count = reflection.GetSetCount();
+    key.set_layouts.reserve(set_count);
+    for (std::uint32_t set = 0; set < set_count; ++set) {
+        VkDescriptorSetLayout set_layout = GetSetLayoutLocked(reflection, set, flags);
+        if (set_layout == VK_NULL_HANDLE) {
+            return VK_NULL_HANDLE;
+        }
+        key.set_layouts.push_back(set_layout);
+    }
+
+    if (reflection.push_constants) {
+        key.push_constant_stages = reflection.push_constants->stageFlags;
+        key.push_constant_offset = reflection.push_constants->offset;
+        key.push_constant_size = reflection.push_constants->size;
+    }
+
+    if (const auto it = pipeline_layouts_.find(key); it != pipeline_layouts_.end()) {
+        return it->second;
+    }
+
+    VkPipelineLayoutCreateInfo pipeline_layout_create_info = {};
+    pipeline_layout_create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+    pipeline_layout_create_info.setLayoutCount = key.set_layouts.size();
+    pipeline_layout_create_info.pSetLayouts = key.set_layouts.data();
+    if (reflection.push_constants) {
+        pipeline_layout_create_info.pushConstantRangeCount = 1;
+        pipeline_layout_create_info.pPushConstantRanges = &reflection.push_constants.value();
+    }
+
+    VkPipelineLayout pipeline_layout = VK_NULL_HANDLE;
+    if (vkCreatePipelineLayout(device_, &pipeline_layout_create_info, nullptr, &pipeline_layout) != VK_SUCCESS) {
+        spdlog::error("Failed to create pipeline layout!");
+        return VK_NULL_HANDLE;
+    }
+
+    pipeline_layouts_.emplace(std::move(key), pipeline_layout);
+    return pipeline_layout;
+}
+} // veng
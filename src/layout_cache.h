@@ -0,0 +1,59 @@
+#pragma once
+
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "spirv_reflection.h"
+
+namespace veng {
+struct DescriptorSetLayoutKey {
+    // Bindings of a single set; their `set` field is always zero so equal sets at different indices share a layout.
+    std::vector<ReflectedBinding> bindings;
+    VkDescriptorSetLayoutCreateFlags flags = 0;
+
+    bool operator==(const DescriptorSetLayoutKey &other) const = default;
+};
+
+struct DescriptorSetLayoutKeyHash {
+    std::size_t operator()(const DescriptorSetLayoutKey &key) const;
+};
+
+struct PipelineLayoutKey {
+    std::vector<VkDescriptorSetLayout> set_layouts;
+    VkShaderStageFlags push_constant_stages = 0;
+    std::uint32_t push_constant_offset = 0;
+    std::uint32_t push_constant_size = 0;
+
+    bool operator==(const PipelineLayoutKey &other) const = default;
+};
+
+struct PipelineLayoutKeyHash {
+    std::size_t operator()(const PipelineLayoutKey &key) const;
+};
+
+// Creates descriptor set and pipeline layouts from shader reflection. Equal layouts are created once and shared, which
+// also keeps pipelines built from the same shader interface layout-compatible. Safe to use from pipeline worker
+// threads; the cache owns every layout it hands out.
+class PipelineLayoutCache final {
+public:
+    void Initialize(VkDevice device);
+    void Destroy();
+
+    // Sets the shaders do not use get an empty layout. VK_NULL_HANDLE on failure. `flags` apply to every set layout,
+    // e.g. to create them for descriptor buffers.
+    VkDescriptorSetLayout GetSetLayout(const ShaderReflection &reflection, std::uint32_t set,
+                                       VkDescriptorSetLayoutCreateFlags flags = 0);
+    VkPipelineLayout GetPipelineLayout(const ShaderReflection &reflection, VkDescriptorSetLayoutCreateFlags flags = 0);
+
+private:
+    VkDescriptorSetLayout GetSetLayoutLocked(const ShaderReflection &reflection, std::uint32_t set,
+                                             VkDescriptorSetLayoutCreateFlags flags);
+
+    VkDevice device_ = VK_NULL_HANDLE;
+    std::mutex mutex_;
+    std::unordered_map<DescriptorSetLayoutKey, VkDescriptorSetLayout, DescriptorSetLayoutKeyHash> set_layouts_;
+    std::unordered_map<PipelineLayoutKey, VkPipelineLayout, PipelineLayoutKeyHash> pipeline_layouts_;
+};
+} // veng
@@ -1,9 +1,16 @@
 #include <precomp.h>
+#include <algorithm>
 #include <iostream>
 #include <GLFW/glfw3.h>
+#include <spdlog/spdlog.h>
 #include <glfw_aux/glfw_initialization.h>
 #include <glfw_aux/glfw_window.h>
+#include "bvh.h"
+#include "frame_loop.h"
 #include "graphics.h"
+#include "mesh_optimizer.h"
+#include "render_thread.h"
+#include "scene_hierarchy.h"
 #include "glm/gtc/matrix_transform.hpp"
 
 std::int32_t main(std::int32_t argc, gsl::zstring *argv) {
@@ -16,40 +23,99 @@ std::int32_t main(std::int32_t argc, gsl::zstring *argv) {
 
     veng::Graphics graphics{gsl::make_not_null(&window)};
 
-    std::array vertices = {
+    std::vector vertices = {
         veng::Vertex({-0.5f, -0.5f, 0.0f}, {0.0f, 1.0f}),
         veng::Vertex({0.5f, -0.5f, 0.0f}, {1.0f, 1.0f}),
         veng::Vertex({-0.5f, 0.5f, 0.0f}, {0.0f, 0.0f}),
         veng::Vertex({0.5f, 0.5f, 0.0f}, {1.0f, 0.0f}),
     };
 
-    const veng::BufferHandle buffer = graphics.CreateVertexBuffer(vertices);
-
-    std::array<std::uint32_t, 6> indices = {
+    std::vector<std::uint32_t> indices = {
         0, 3, 2, 0, 1, 3
     };
 
+    const veng::MeshOptimizationReport mesh_report = veng::OptimizeMesh(vertices, indices);
+    spdlog::info("Mesh: {} -> {} vertices, ACMR {:.2f} -> {:.2f}, ATVR {:.2f} -> {:.2f}",
+                 mesh_report.vertex_count_before, mesh_report.vertex_count_after, mesh_report.before.acmr,
+                 mesh_report.after.acmr, mesh_report.before.atvr, mesh_report.after.atvr);
+
+    const veng::BufferHandle buffer = graphics.CreateVertexBuffer(vertices);
     veng::BufferHandle index_buffer = graphics.CreateIndexBuffer(indices);
 
-    glm::mat4 rotation = glm::rotate(glm::mat4(1.0f), glm::radians(90.0f), glm::vec3(0.0f, 0.0f, 1.0f));
     glm::mat4 view = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -2.0f));
     glm::mat4 proj = glm::perspective(glm::radians(60.0f), 800.0f / 600.0f, 0.1f, 100.0f);
-    graphics.SetViewProjection(view, proj);
+    const veng::Frustum view_frustum = veng::Frustum::FromViewProjection(view, proj);
 
     veng::TextureHandle handle = graphics.CreateTexture("assets/textures/paving-stones.jpg");
 
-    while (!window.ShouldClose()) {
-        glfwPollEvents();
-        if (graphics.BeginFrame()) {
-            graphics.SetTexture(handle);
-            graphics.RenderIndexedBuffer(buffer, index_buffer, indices.size());
-            graphics.EndFrame();
-        }
+    veng::SceneHierarchy scene;
+    const veng::SceneNode root = scene.Create();
+    const veng::SceneNode quad = scene.Create(root, glm::mat4(1.0f), {{-0.5f, -0.5f, 0.0f}, {0.5f, 0.5f, 0.0f}});
+    // Scene nodes that draw the quad, indexed by their object in the BVH.
+    const std::array drawable_nodes = {quad};
+
+    std::vector<veng::SceneNode> updated_nodes;
+    scene.Update(updated_nodes);
+    std::vector<veng::Aabb> object_bounds;
+    for (const veng::SceneNode node: drawable_nodes) {
+        object_bounds.push_back(scene.GetWorldBounds(node));
     }
+    // World-space bounds of everything drawn, so only what the camera sees gets submitted.
+    veng::Bvh scene_bvh;
+    scene_bvh.Build(object_bounds);
+    std::vector<std::uint32_t> visible_objects;
+
+    // From here on Graphics belongs to the render thread; this thread polls events and simulates.
+    veng::RenderThread render_thread{gsl::make_not_null(&graphics)};
+
+    // Simulation state: the quad spins at a fixed rate, independent of the frame rate.
+    const float quad_spin_speed = glm::radians(45.0f);
+    float quad_angle = 0.0f;
+    float previous_quad_angle = 0.0f;
+
+    veng::FrameLoop frame_loop;
+    frame_loop.Run(
+        [&window] {
+            glfwPollEvents();
+            // Nothing gets drawn while minimized, so sleep until that changes instead of producing frames.
+            for (glm::ivec2 size = window.GetFrameBufferSize(); (size.x == 0 || size.y == 0) && !window.ShouldClose();
+                 size = window.GetFrameBufferSize()) {
+                glfwWaitEvents();
+            }
+            return !window.ShouldClose();
+        },
+        [&](const float step_seconds) {
+            previous_quad_angle = quad_angle;
+            quad_angle += quad_spin_speed * step_seconds;
+        },
+        [&](const float alpha) {
+            const float angle = glm::mix(previous_quad_angle, quad_angle, alpha);
+            scene.SetLocalTransform(quad, glm::rotate(glm::mat4(1.0f), angle, glm::vec3(0.0f, 0.0f, 1.0f)));
+
+            scene.Update(updated_nodes);
+            for (const veng::SceneNode node: updated_nodes) {
+                if (const auto it = std::ranges::find(drawable_nodes, node); it != drawable_nodes.end()) {
+                    scene_bvh.UpdateBounds(static_cast<std::uint32_t>(it - drawable_nodes.begin()),
+                                           scene.GetWorldBounds(node));
+                }
+            }
+
+            veng::FramePacket &packet = render_thread.BeginPacket();
+            packet.view = view;
+            packet.projection = proj;
+            scene_bvh.QueryFrustum(view_frustum, visible_objects);
+            for (const std::uint32_t object: visible_objects) {
+                packet.draws.push_back({scene.GetWorldTransform(drawable_nodes[object]), handle, buffer, index_buffer,
+                                        static_cast<std::uint32_t>(indices.size())});
+            }
+            render_thread.SubmitPacket();
+        });
 
-    graphics.DestroyTexture(handle);
-    graphics.DestroyBuffer(buffer);
-    graphics.DestroyBuffer(index_buffer);
+    render_thread.Invoke([&](veng::Graphics &render_graphics) {
+        render_graphics.DestroyTexture(handle);
+        render_graphics.DestroyBuffer(buffer);
+        render_graphics.DestroyBuffer(index_buffer);
+    }).get();
 
     return EXIT_SUCCESS;
 }
@@ -0,0 +1,335 @@
+#include "mesh_optimizer.h"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <numeric>
+#include <precomp.h>
+
+namespace veng {
+namespace {
+constexpr std::uint32_t kNoVertex = std::numeric_limits<std::uint32_t>::max();
+
+using VertexBits = std::array<std::uint32_t, 5>;
+
+// Comparing bits rather than floats keeps -0 and 0 apart, and NaNs equal to themselves.
+VertexBits GetVertexBits(const Vertex &vertex) {
+    return {
+        std::bit_cast<std::uint32_t>(vertex.position.x), std::bit_cast<std::uint32_t>(vertex.position.y),
+        std::bit_cast<std::uint32_t>(vertex.position.z), std::bit_cast<std::uint32_t>(vertex.uv.x),
+        std::bit_cast<std::uint32_t>(vertex.uv.y)
+    };
+}
+
+std::uint32_t HashVertexBits(const VertexBits &bits) {
+    std::uint32_t hash = 2166136261u;
+    for (const std::uint32_t word: bits) {
+        hash = (hash ^ word) * 16777619u;
+    }
+    return hash ^ (hash >> 15);
+}
+
+// FIFO cache emulated with timestamps: a vertex is still cached if fewer than cache_size vertices were loaded since.
+class VertexCacheModel {
+public:
+    VertexCacheModel(const std::size_t vertex_count, const std::uint32_t cache_size)
+        : timestamps_(vertex_count, 0), cache_size_(cache_size), time_(cache_size + 1) {
+    }
+
+    // Returns whether the vertex had to be transformed.
+    bool Load(const std::uint32_t vertex) {
+        if (time_ - timestamps_[vertex] <= cache_size_) {
+            return false;
+        }
+        timestamps_[vertex] = time_++;
+        return true;
+    }
+
+    std::uint32_t LoadTriangle(const std::span<const std::uint32_t> indices, const std::size_t triangle) {
+        return static_cast<std::uint32_t>(Load(indices[triangle * 3])) + Load(indices[triangle * 3 + 1]) +
+               Load(indices[triangle * 3 + 2]);
+    }
+
+    void Flush() {
+        time_ += cache_size_ + 1;
+    }
+
+    // How long ago the vertex was loaded, in loads.
+    [[nodiscard]] std::uint32_t GetAge(const std::uint32_t vertex) const {
+        return time_ - timestamps_[vertex];
+    }
+
+private:
+    std::vector<std::uint32_t> timestamps_;
+    std::uint32_t cache_size_;
+    std::uint32_t time_;
+};
+}
+
+VertexCacheStatistics AnalyzeVertexCache(const std::span<const std::uint32_t> indices,
+                                         const std::uint32_t vertex_count, const std::uint32_t cache_size) {
+    VertexCacheStatistics statistics;
+    VertexCacheModel cache(vertex_count, cache_size);
+    for (const std::uint32_t index: indices) {
+        statistics.vertices_transformed += cache.Load(index);
+    }
+
+    if (const std::size_t triangle_count = indices.size() / 3; triangle_count != 0) {
+        statistics.acmr = static_cast<float>(statistics.vertices_transformed) / static_cast<float>(triangle_count);
+    }
+    if (vertex_count != 0) {
+        statistics.atvr = static_cast<float>(statistics.vertices_transformed) / static_cast<float>(vertex_count);
+    }
+    return statistics;
+}
+
+std::size_t DeduplicateVertices(std::vector<Vertex> &vertices, const std::span<std::uint32_t> indices) {
+    // Open addressing at most half full, so probe sequences stay short.
+    const std::size_t table_size = std::bit_ceil(std::max<std::size_t>(vertices.size() * 2, 16));
+    const std::size_t table_mask = table_size - 1;
+    std::vector<std::uint32_t> table(table_size, kNoVertex);
+    std::vector<VertexBits> unique_bits;
+    unique_bits.reserve(vertices.size());
+
+    std::vector<std::uint32_t> remap(vertices.size());
+    std::size_t unique_count = 0;
+    for (std::size_t vertex = 0; vertex < vertices.size(); ++vertex) {
+        const VertexBits bits = GetVertexBits(vertices[vertex]);
+        std::size_t slot = HashVertexBits(bits) & table_mask;
+        while (table[slot] != kNoVertex && unique_bits[table[slot]] != bits) {
+            slot = (slot + 1) & table_mask;
+        }
+
+        if (table[slot] == kNoVertex) {
+            table[slot] = static_cast<std::uint32_t>(unique_count);
+            unique_bits.push_back(bits);
+            // Unique vertices only ever move towards the front, so compacting in place is safe.
+            vertices[unique_count++] = vertices[vertex];
+        }
+        remap[vertex] = table[slot];
+    }
+
+    for (std::uint32_t &index: indices) {
+        index = remap[index];
+    }
+    const std::size_t removed = vertices.size() - unique_count;
+    vertices.resize(unique_count);
+    return removed;
+}
+
+void OptimizeVertexCache(const std::span<std::uint32_t> indices, const std::uint32_t vertex_count,
+                         const std::uint32_t cache_size) {
+    const std::size_t triangle_count = indices.size() / 3;
+    if (triangle_count == 0) {
+        return;
+    }
+
+    // Triangles around every vertex, and how many of them are still to be emitted.
+    std::vector<std::uint32_t> live_triangles(vertex_count, 0);
+    for (const std::uint32_t index: indices) {
+        ++live_triangles[index];
+    }
+    std::vector<std::uint32_t> adjacency_offsets(vertex_count + 1, 0);
+    std::inclusive_scan(live_triangles.begin(), live_triangles.end(), adjacency_offsets.begin() + 1);
+    std::vector<std::uint32_t> adjacency(triangle_count * 3);
+    std::vector<std::uint32_t> adjacency_fill(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+    for (std::size_t index = 0; index < triangle_count * 3; ++index) {
+        adjacency[adjacency_fill[indices[index]]++] = static_cast<std::uint32_t>(index / 3);
+    }
+
+    std::vector<std::uint8_t> emitted(triangle_count, 0);
+    std::vector<std::uint32_t> output;
+    output.reserve(triangle_count * 3);
+    // Recently used vertices, to resume from when the fan runs out of candidates.
+    std::vector<std::uint32_t> dead_ends;
+    dead_ends.reserve(triangle_count * 3);
+    std::uint32_t next_unvisited = 0;
+    VertexCacheModel cache(vertex_count, cache_size);
+
+    std::uint32_t fan_vertex = indices[0];
+    while (fan_vertex != kNoVertex) {
+        // Emits every remaining triangle around the fan vertex; their vertices are the next fan candidates.
+        const std::size_t candidates_begin = dead_ends.size();
+        for (std::uint32_t entry = adjacency_offsets[fan_vertex]; entry < adjacency_offsets[fan_vertex + 1]; ++entry) {
+            const std::uint32_t triangle = adjacency[entry];
+            if (emitted[triangle] != 0) {
+                continue;
+            }
+            emitted[triangle] = 1;
+            for (std::size_t corner = 0; corner < 3; ++corner) {
+                const std::uint32_t vertex = indices[triangle * 3 + corner];
+                output.push_back(vertex);
+                dead_ends.push_back(vertex);
+                --live_triangles[vertex];
+                cache.Load(vertex);
+            }
+        }
+
+        // Prefers the oldest candidate that stays in the cache while its remaining triangles are emitted.
+        std::uint32_t next_vertex = kNoVertex;
+        std::int64_t best_priority = -1;
+        for (std::size_t entry = candidates_begin; entry < dead_ends.size(); ++entry) {
+            const std::uint32_t vertex = dead_ends[entry];
+            if (live_triangles[vertex] == 0) {
+                continue;
+            }
+            std::int64_t priority = 0;
+            if (cache.GetAge(vertex) + 2 * live_triangles[vertex] <= cache_size) {
+                priority = cache.GetAge(vertex);
+            }
+            if (priority > best_priority) {
+                best_priority = priority;
+                next_vertex = vertex;
+            }
+        }
+
+        while (next_vertex == kNoVertex && !dead_ends.empty()) {
+            const std::uint32_t vertex = dead_ends.back();
+            dead_ends.pop_back();
+            if (live_triangles[vertex] != 0) {
+                next_vertex = vertex;
+            }
+        }
+        for (; next_vertex == kNoVertex && next_unvisited < vertex_count; ++next_unvisited) {
+            if (live_triangles[next_unvisited] != 0) {
+                next_vertex = next_unvisited;
+            }
+        }
+        fan_vertex = next_vertex;
+    }
+
+    std::ranges::copy(output, indices.begin());
+}
+
+void OptimizeOverdraw(const std::span<std::uint32_t> indices, const std::span<const Vertex> vertices,
+                      const std::uint32_t cache_size, const float threshold) {
+    const std::size_t triangle_count = indices.size() / 3;
+    if (triangle_count == 0) {
+        return;
+    }
+
+    // Hard boundaries are where the cache order jumped and every vertex missed; reordering there costs nothing.
+    VertexCacheModel cache(vertices.size(), cache_size);
+    std::vector<std::size_t> hard_boundaries;
+    for (std::size_t triangle = 0; triangle < triangle_count; ++triangle) {
+        if (cache.LoadTriangle(indices, triangle) == 3 || triangle == 0) {
+            hard_boundaries.push_back(triangle);
+        }
+    }
+    hard_boundaries.push_back(triangle_count);
+
+    // Soft boundaries split long runs wherever the ACMR so far stays within the threshold of the run's own.
+    std::vector<std::size_t> cluster_begins;
+    for (std::size_t hard = 0; hard + 1 < hard_boundaries.size(); ++hard) {
+        const std::size_t begin = hard_boundaries[hard];
+        const std::size_t end = hard_boundaries[hard + 1];
+
+        cache.Flush();
+        std::uint32_t run_misses = 0;
+        for (std::size_t triangle = begin; triangle < end; ++triangle) {
+            run_misses += cache.LoadTriangle(indices, triangle);
+        }
+        const float split_acmr = threshold * static_cast<float>(run_misses) / static_cast<float>(end - begin);
+
+        cache.Flush();
+        cluster_begins.push_back(begin);
+        std::uint32_t misses = 0;
+        std::uint32_t triangles = 0;
+        for (std::size_t triangle = begin; triangle + 1 < end; ++triangle) {
+            misses += cache.LoadTriangle(indices, triangle);
+            ++triangles;
+            if (static_cast<float>(misses) <= split_acmr * static_cast<float>(triangles)) {
+                cluster_begins.push_back(triangle + 1);
+                cache.Flush();
+                misses = 0;
+                triangles = 0;
+            }
+        }
+    }
+    cluster_begins.push_back(triangle_count);
+    const std::size_t cluster_count = cluster_begins.size() - 1;
+
+    // Area-weighted centroid and normal of every cluster.
+    std::vector<glm::vec3> cluster_centroids(cluster_count, glm::vec3(0.0f));
+    std::vector<glm::vec3> cluster_normals(cluster_count, glm::vec3(0.0f));
+    glm::vec3 mesh_centroid(0.0f);
+    float mesh_area = 0.0f;
+    for (std::size_t cluster = 0; cluster < cluster_count; ++cluster) {
+        float cluster_area = 0.0f;
+        for (std::size_t triangle = cluster_begins[cluster]; triangle < cluster_begins[cluster + 1]; ++triangle) {
+            const glm::vec3 &a = vertices[indices[triangle * 3]].position;
+            const glm::vec3 &b = vertices[indices[triangle * 3 + 1]].position;
+            const glm::vec3 &c = vertices[indices[triangle * 3 + 2]].position;
+            const glm::vec3 scaled_normal = glm::cross(b - a, c - a);
+            const float area = glm::length(scaled_normal);
+
+            cluster_centroids[cluster] += (a + b + c) * (area / 3.0f);
+            cluster_normals[cluster] += scaled_normal;
+            cluster_area += area;
+        }
+        mesh_centroid += cluster_centroids[cluster];
+        mesh_area += cluster_area;
+        if (cluster_area > 0.0f) {
+            cluster_centroids[cluster] /= cluster_area;
+        }
+    }
+    if (mesh_area > 0.0f) {
+        mesh_centroid /= mesh_area;
+    }
+
+    // Clusters far out along their normal face away from the rest of the mesh, so they tend to occlude it.
+    std::vector<float> sort_keys(cluster_count);
+    for (std::size_t cluster = 0; cluster < cluster_count; ++cluster) {
+        const float normal_length = glm::length(cluster_normals[cluster]);
+        sort_keys[cluster] = normal_length > 0.0f
+                                 ? glm::dot(cluster_centroids[cluster] - mesh_centroid, cluster_normals[cluster]) /
+                                   normal_length
+                                 : 0.0f;
+    }
+    std::vector<std::uint32_t> cluster_order(cluster_count);
+    std::iota(cluster_order.begin(), cluster_order.end(), 0u);
+    std::ranges::stable_sort(cluster_order, [&sort_keys](const std::uint32_t a, const std::uint32_t b) {
+        return sort_keys[a] > sort_keys[b];
+    });
+
+    std::vector<std::uint32_t> output;
+    output.reserve(triangle_count * 3);
+    for (const std::uint32_t cluster: cluster_order) {
+        output.insert(output.end(), indices.begin() + static_cast<std::ptrdiff_t>(cluster_begins[cluster] * 3),
+                      indices.begin() + static_cast<std::ptrdiff_t>(cluster_begins[cluster + 1] * 3));
+    }
+    std::ranges::copy(output, indices.begin());
+}
+
+void OptimizeVertexFetch(std::vector<Vertex> &vertices, const std::span<std::uint32_t> indices) {
+    std::vector<std::uint32_t> remap(vertices.size(), kNoVertex);
+    std::vector<Vertex> reordered;
+    reordered.reserve(vertices.size());
+    for (std::uint32_t &index: indices) {
+        if (remap[index] == kNoVertex) {
+            remap[index] = static_cast<std::uint32_t>(reordered.size());
+            reordered.push_back(vertices[index]);
+        }
+        index = remap[index];
+    }
+    vertices = std::move(reordered);
+}
+
+MeshOptimizationReport OptimizeMesh(std::vector<Vertex> &vertices, std::vector<std::uint32_t> &indices,
+                                    const MeshOptimizationSettings &settings) {
+    MeshOptimizationReport report;
+    report.vertex_count_before = vertices.size();
+    report.before = AnalyzeVertexCache(indices, static_cast<std::uint32_t>(vertices.size()), settings.cache_size);
+
+    DeduplicateVertices(vertices, indices);
+    OptimizeVertexCache(indices, static_cast<std::uint32_t>(vertices.size()), settings.cache_size);
+    if (settings.overdraw_threshold > 1.0f) {
+        OptimizeOverdraw(indices, vertices, settings.cache_size, settings.overdraw_threshold);
+    }
+    OptimizeVertexFetch(vertices, indices);
+
+    report.vertex_count_after = vertices.size();
+    report.after = AnalyzeVertexCache(indices, static_cast<std::uint32_t>(vertices.size()), settings.cache_size);
+    return report;
+}
+} // veng
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "vertex.h"
+
+namespace veng {
+// Post-transform vertex cache modelled as a FIFO of this many vertices, close to what current GPUs behave like.
+constexpr std::uint32_t kDefaultVertexCacheSize = 16;
+
+struct VertexCacheStatistics {
+    std::uint32_t vertices_transformed = 0;
+    // Average cache miss ratio: vertices transformed per triangle. 0.5 is the ideal for large regular meshes, 3 the
+    // worst case.
+    float acmr = 0.0f;
+    // Average transform to vertex ratio: how often each vertex is transformed. 1 is ideal.
+    float atvr = 0.0f;
+};
+
+struct MeshOptimizationSettings {
+    std::uint32_t cache_size = kDefaultVertexCacheSize;
+    // How much worse than the cache order a triangle cluster's ACMR may get so that clusters can be reordered
+    // against overdraw. 1 keeps the cache order untouched.
+    float overdraw_threshold = 1.05f;
+};
+
+struct MeshOptimizationReport {
+    std::size_t vertex_count_before = 0;
+    std::size_t vertex_count_after = 0;
+    VertexCacheStatistics before;
+    VertexCacheStatistics after;
+};
+
+[[nodiscard]] VertexCacheStatistics AnalyzeVertexCache(std::span<const std::uint32_t> indices,
+                                                       std::uint32_t vertex_count,
+                                                       std::uint32_t cache_size = kDefaultVertexCacheSize);
+
+// Merges bitwise identical vertices and rewrites the indices to match. Returns how many were removed.
+std::size_t DeduplicateVertices(std::vector<Vertex> &vertices, std::span<std::uint32_t> indices);
+// Reorders triangles for post-transform cache hits with Tipsify (Sander et al., "Fast Triangle Reordering for Vertex
+// Locality and Reduced Overdraw"), in linear time.
+void OptimizeVertexCache(std::span<std::uint32_t> indices, std::uint32_t vertex_count,
+                         std::uint32_t cache_size = kDefaultVertexCacheSize);
+// Splits cache-ordered triangles into clusters and sorts them so that outward-facing ones come first, which lets
+// early depth testing reject more of what is behind them from any view. Expects OptimizeVertexCache output.
+void OptimizeOverdraw(std::span<std::uint32_t> indices, std::span<const Vertex> vertices,
+                      std::uint32_t cache_size = kDefaultVertexCacheSize, float threshold = 1.05f);
+// Reorders vertices by first use so fetching them walks memory linearly, and drops unreferenced ones.
+void OptimizeVertexFetch(std::vector<Vertex> &vertices, std::span<std::uint32_t> indices);
+
+// All of the above in order, meant to run once on meshes before they are uploaded.
+MeshOptimizationReport OptimizeMesh(std::vector<Vertex> &vertices, std::vector<std::uint32_t> &indices,
+                                    const MeshOptimizationSettings &settings = {});
+} // veng
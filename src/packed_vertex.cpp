@@ -0,0 +1,91 @@
+#include "packed_vertex.h"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+#include <precomp.h>
+
+#include "glm/gtc/matrix_transform.hpp"
+#include "glm/gtc/packing.hpp"
+
+namespace veng {
+namespace {
+std::uint16_t PackPositionComponent(const float value, const PackedPositionFormat format) {
+    return format == PackedPositionFormat::Float16 ? glm::packHalf1x16(value) : glm::packSnorm1x16(value);
+}
+
+std::uint16_t PackUvComponent(const float value, const PackedUvFormat format) {
+    return format == PackedUvFormat::Float16 ? glm::packHalf1x16(value) : glm::packUnorm1x16(value);
+}
+
+float SignNotZero(const float value) {
+    return value >= 0.0f ? 1.0f : -1.0f;
+}
+}
+
+PackedMesh QuantizeMesh(const std::span<const Vertex> vertices, const std::span<const glm::vec3> normals,
+                        const PackedVertexFormat &format) {
+    PackedMesh mesh;
+    mesh.format = format;
+    if (vertices.empty()) {
+        return mesh;
+    }
+
+    glm::vec3 bounds_min(std::numeric_limits<float>::max());
+    glm::vec3 bounds_max(std::numeric_limits<float>::lowest());
+    for (const Vertex &vertex: vertices) {
+        bounds_min = glm::min(bounds_min, vertex.position);
+        bounds_max = glm::max(bounds_max, vertex.position);
+    }
+    const glm::vec3 center = (bounds_min + bounds_max) * 0.5f;
+    const glm::vec3 half_extent = (bounds_max - bounds_min) * 0.5f;
+    float scale = std::max({half_extent.x, half_extent.y, half_extent.z});
+    if (scale <= 0.0f) {
+        scale = 1.0f;
+    }
+    mesh.dequantization = glm::scale(glm::translate(glm::mat4(1.0f), center), glm::vec3(scale));
+
+    const std::array<std::int16_t, 2> default_normal = EncodeOctahedralNormal(glm::vec3(0.0f, 0.0f, 1.0f));
+    const float inverse_scale = 1.0f / scale;
+    mesh.vertices.resize(vertices.size());
+    for (std::size_t index = 0; index < vertices.size(); ++index) {
+        const glm::vec3 position = (vertices[index].position - center) * inverse_scale;
+        PackedVertex &packed = mesh.vertices[index];
+        packed.position = {
+            PackPositionComponent(position.x, format.position), PackPositionComponent(position.y, format.position),
+            PackPositionComponent(position.z, format.position), PackPositionComponent(1.0f, format.position)
+        };
+        packed.uv = {PackUvComponent(vertices[index].uv.x, format.uv), PackUvComponent(vertices[index].uv.y, format.uv)};
+        packed.normal = index < normals.size() ? EncodeOctahedralNormal(normals[index]) : default_normal;
+    }
+    return mesh;
+}
+
+std::array<std::int16_t, 2> EncodeOctahedralNormal(const glm::vec3 &normal) {
+    // Projects onto the octahedron |x| + |y| + |z| = 1 and folds its lower half over the upper one.
+    const float length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+    if (length == 0.0f) {
+        return EncodeOctahedralNormal(glm::vec3(0.0f, 0.0f, 1.0f));
+    }
+    glm::vec2 encoded(normal.x / length, normal.y / length);
+    if (normal.z < 0.0f) {
+        encoded = glm::vec2((1.0f - std::abs(encoded.y)) * SignNotZero(encoded.x),
+                            (1.0f - std::abs(encoded.x)) * SignNotZero(encoded.y));
+    }
+    return {
+        std::bit_cast<std::int16_t>(glm::packSnorm1x16(encoded.x)),
+        std::bit_cast<std::int16_t>(glm::packSnorm1x16(encoded.y))
+    };
+}
+
+glm::vec3 DecodeOctahedralNormal(const std::array<std::int16_t, 2> &encoded) {
+    // Same as packed.vert.
+    glm::vec3 normal(glm::unpackSnorm1x16(std::bit_cast<std::uint16_t>(encoded[0])),
+                     glm::unpackSnorm1x16(std::bit_cast<std::uint16_t>(encoded[1])), 0.0f);
+    normal.z = 1.0f - std::abs(normal.x) - std::abs(normal.y);
+    const float fold = std::max(-normal.z, 0.0f);
+    normal.x += normal.x >= 0.0f ? -fold : fold;
+    normal.y += normal.y >= 0.0f ? -fold : fold;
+    return glm::normalize(normal);
+}
+} // veng
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <array>
+#include <span>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "vertex.h"
+
+namespace veng {
+enum class PackedPositionFormat : std::uint8_t {
+    Float16,
+    // Twice the precision of Float16 over the same range, as every value is equally far apart.
+    Snorm16
+};
+
+enum class PackedUvFormat : std::uint8_t {
+    // Only covers [0, 1]; other values are clamped.
+    Unorm16,
+    // For tiling UVs outside [0, 1].
+    Float16
+};
+
+// Picked per mesh. Both position and both UV formats read as floats in the shader, so packed.vert handles all of them;
+// only the vertex input, and with it the pipeline, differs.
+struct PackedVertexFormat {
+    PackedPositionFormat position = PackedPositionFormat::Snorm16;
+    PackedUvFormat uv = PackedUvFormat::Unorm16;
+
+    bool operator==(const PackedVertexFormat &other) const = default;
+};
+
+// 16 bytes to Vertex's 20, with a normal on top. Positions are relative to the mesh bounds, in [-1, 1], and need the
+// mesh's dequantization transform; normals are octahedral-encoded.
+struct PackedVertex {
+    // The fourth component only pads to a four-component format; three-component 16-bit vertex formats are rarely
+    // supported.
+    std::array<std::uint16_t, 4> position{};
+    std::array<std::uint16_t, 2> uv{};
+    std::array<std::int16_t, 2> normal{};
+};
+
+static_assert(sizeof(PackedVertex) == 16);
+
+// One set of traits per format combination, so every layout is still worked out while compiling.
+template <PackedPositionFormat Position, PackedUvFormat Uv>
+struct PackedVertexTraits {
+    using Type = PackedVertex;
+    static constexpr std::array attributes = {
+        VertexAttribute::Of(Position == PackedPositionFormat::Float16
+                                ? VK_FORMAT_R16G16B16A16_SFLOAT
+                                : VK_FORMAT_R16G16B16A16_SNORM, offsetof(PackedVertex, position)),
+        VertexAttribute::Of(Uv == PackedUvFormat::Float16 ? VK_FORMAT_R16G16_SFLOAT : VK_FORMAT_R16G16_UNORM,
+                            offsetof(PackedVertex, uv)),
+        VertexAttribute::Of(VK_FORMAT_R16G16_SNORM, offsetof(PackedVertex, normal))
+    };
+};
+
+template <PackedPositionFormat Position, PackedUvFormat Uv>
+using PackedVertexBinding = VertexBinding<PackedVertexTraits<Position, Uv>, VK_VERTEX_INPUT_RATE_VERTEX>;
+
+struct PackedMesh {
+    PackedVertexFormat format;
+    std::vector<PackedVertex> vertices;
+    // Maps stored positions back to mesh space; multiply it into the model matrix. Its scale is uniform, so normals
+    // transform correctly with the combined matrix.
+    glm::mat4 dequantization{1.0f};
+};
+
+// Normals are per vertex and may be left empty, which stores +Z, the facing of the engine's quads. Indices stay valid.
+PackedMesh QuantizeMesh(std::span<const Vertex> vertices, std::span<const glm::vec3> normals = {},
+                        const PackedVertexFormat &format = {});
+
+[[nodiscard]] std::array<std::int16_t, 2> EncodeOctahedralNormal(const glm::vec3 &normal);
+[[nodiscard]] glm::vec3 DecodeOctahedralNormal(const std::array<std::int16_t, 2> &encoded);
+} // veng
@@ -0,0 +1,246 @@
+#include "pipeline_cache.h"
+
+#include <algorithm>
+#include <precomp.h>
+
+#include "utilities.h"
+
+namespace veng {
+bool VertexLayout::operator==(const VertexLayout &other) const {
+    return std::ranges::equal(bindings, other.bindings,
+                              [](const VkVertexInputBindingDescription &a, const VkVertexInputBindingDescription &b) {
+                                  return a.binding == b.binding && a.stride == b.stride && a.inputRate == b.inputRate;
+                              }) &&
+           std::ranges::equal(attributes, other.attributes,
+                              [](const VkVertexInputAttributeDescription &a,
+                                 const VkVertexInputAttributeDescription &b) {
+                                  return a.location == b.location && a.binding == b.binding &&
+                                         a.format == b.format && a.offset == b.offset;
+                              });
+}
+
+VertexLayout VertexLayout::FromPackedVertex(const PackedVertexFormat &format) {
+    constexpr auto half = PackedPositionFormat::Float16;
+    constexpr auto snorm = PackedPositionFormat::Snorm16;
+    constexpr auto half_uv = PackedUvFormat::Float16;
+    constexpr auto unorm_uv = PackedUvFormat::Unorm16;
+    if (format.position == half) {
+        return format.uv == half_uv
+                   ? From<PackedVertexBinding<half, half_uv>>()
+                   : From<PackedVertexBinding<half, unorm_uv>>();
+    }
+    return format.uv == half_uv
+               ? From<PackedVertexBinding<snorm, half_uv>>()
+               : From<PackedVertexBinding<snorm, unorm_uv>>();
+}
+
+VertexLayout VertexLayout::FromReflection(const ShaderReflection &reflection) {
+    VertexLayout layout;
+    std::uint32_t offset = 0;
+    for (const ReflectedVertexInput &input: reflection.vertex_inputs) {
+        // Left out for the pipeline to report instead of creating attributes without a format.
+        if (input.format == VK_FORMAT_UNDEFINED) {
+            continue;
+        }
+        layout.attributes.push_back({input.location, 0, input.format, offset});
+        offset += input.size;
+    }
+    if (!layout.attributes.empty()) {
+        layout.bindings.push_back({0, offset, VK_VERTEX_INPUT_RATE_VERTEX});
+    }
+    return layout;
+}
+
+VkPipelineColorBlendAttachmentState GetBlendAttachmentState(const BlendMode blend_mode) {
+    VkPipelineColorBlendAttachmentState color_blend_attachment_state = {};
+    color_blend_attachment_state.colorWriteMask =
+            VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
+    switch (blend_mode) {
+        case BlendMode::Opaque:
+            color_blend_attachment_state.blendEnable = VK_FALSE;
+            break;
+        case BlendMode::AlphaBlend:
+            color_blend_attachment_state.blendEnable = VK_TRUE;
+            color_blend_attachment_state.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+            color_blend_attachment_state.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+            color_blend_attachment_state.colorBlendOp = VK_BLEND_OP_ADD;
+            color_blend_attachment_state.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+            color_blend_attachment_state.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+            color_blend_attachment_state.alphaBlendOp = VK_BLEND_OP_ADD;
+            break;
+        case BlendMode::Additive:
+            color_blend_attachment_state.blendEnable = VK_TRUE;
+            color_blend_attachment_state.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+            color_blend_attachment_state.dstColorBlendFactor = VK_BLEND_FACTOR_ONE;
+            color_blend_attachment_state.colorBlendOp = VK_BLEND_OP_ADD;
+            color_blend_attachment_state.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+            color_blend_attachment_state.dstAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+            color_blend_attachment_state.alphaBlendOp = VK_BLEND_OP_ADD;
+            break;
+    }
+
+    return color_blend_attachment_state;
+}
+
+std::size_t PipelineDescriptionHash::operator()(const PipelineDescription &description) const {
+    std::size_t seed = 0;
+    HashCombine(seed, description.vertex_shader);
+    HashCombine(seed, description.fragment_shader);
+    HashCombine(seed, description.shader_features.bits);
+    for (const VkVertexInputBindingDescription &binding: description.vertex_layout.bindings) {
+        HashCombine(seed, binding.binding);
+        HashCombine(seed, binding.stride);
+        HashCombine(seed, binding.inputRate);
+    }
+    for (const VkVertexInputAttributeDescription &attribute: description.vertex_layout.attributes) {
+        HashCombine(seed, attribute.location);
+        HashCombine(seed, attribute.binding);
+        HashCombine(seed, attribute.format);
+        HashCombine(seed, attribute.offset);
+    }
+    HashCombine(seed, description.topology);
+    HashCombine(seed, description.primitive_restart);
+    HashCombine(seed, description.cull_mode);
+    HashCombine(seed, description.front_face);
+    HashCombine(seed, description.blend_mode);
+    HashCombine(seed, description.depth_test);
+    HashCombine(seed, description.depth_write);
+    HashCombine(seed, description.depth_compare);
+    return seed;
+}
+
+PipelineStatus PipelineHandle::GetStatus() const {
+    return state_ ? state_->status.load(std::memory_order_acquire) : PipelineStatus::Failed;
+}
+
+bool PipelineHandle::IsReady() const {
+    return GetStatus() == PipelineStatus::Ready;
+}
+
+VkPipeline PipelineHandle::Get() const {
+    return IsReady() ? state_->pipeline.load(std::memory_order_acquire) : VK_NULL_HANDLE;
+}
+
+VkPipeline PipelineHandle::Wait() const {
+    if (!state_) {
+        return VK_NULL_HANDLE;
+    }
+
+    std::unique_lock lock(state_->mutex);
+    state_->finished.wait(lock, [this] {
+        return state_->status.load(std::memory_order_acquire) != PipelineStatus::Pending;
+    });
+    return state_->pipeline.load(std::memory_order_acquire);
+}
+
+std::shared_ptr<PipelineHandle::State> PipelineCache::Find(const PipelineDescription &description) {
+    const auto it = pipelines_.find(description);
+    return it != pipelines_.end() ? it->second : nullptr;
+}
+
+void PipelineCache::Finish(PipelineHandle::State &state, VkPipeline pipeline) {
+    {
+        std::lock_guard lock(state.mutex);
+        state.pipeline.store(pipeline, std::memory_order_release);
+        state.status.store(pipeline != VK_NULL_HANDLE ? PipelineStatus::Ready : PipelineStatus::Failed,
+                           std::memory_order_release);
+    }
+    state.finished.notify_all();
+}
+
+void PipelineCache::Replace(PipelineHandle::State &state, VkPipeline pipeline) {
+    std::lock_guard lock(state.mutex);
+    state.replaced = state.pipeline.exchange(pipeline, std::memory_order_acq_rel);
+}
+
+void PipelineCache::Optimize(const std::shared_ptr<PipelineHandle::State> &state,
+                             const PipelineDescription &description) {
+    if (!optimize_ || optimize_workers_ == nullptr) {
+        return;
+    }
+
+    optimize_workers_->Submit([state, description, optimize = optimize_] {
+        if (VkPipeline optimized = optimize(description); optimized != VK_NULL_HANDLE) {
+            Replace(*state, optimized);
+        }
+    });
+}
+
+void PipelineCache::SetOptimizer(CreateFunction optimize, ThreadPool &workers) {
+    optimize_ = std::move(optimize);
+    optimize_workers_ = &workers;
+}
+
+VkPipeline PipelineCache::GetOrCreate(const PipelineDescription &description, const CreateFunction &create) {
+    if (const std::shared_ptr<PipelineHandle::State> state = Find(description)) {
+        ++hits_;
+        return PipelineHandle(state).Wait();
+    }
+
+    ++misses_;
+    VkPipeline pipeline = create(description);
+    auto state = std::make_shared<PipelineHandle::State>();
+    Finish(*state, pipeline);
+    if (pipeline != VK_NULL_HANDLE) {
+        Optimize(state, description);
+    }
+    pipelines_.emplace(description, std::move(state));
+    return pipeline;
+}
+
+PipelineHandle PipelineCache::GetOrCreateAsync(const PipelineDescription &description, CreateFunction create,
+                                               ThreadPool &workers) {
+    if (std::shared_ptr<PipelineHandle::State> state = Find(description)) {
+        ++hits_;
+        return PipelineHandle(std::move(state));
+    }
+
+    ++misses_;
+    auto state = std::make_shared<PipelineHandle::State>();
+    pipelines_.emplace(description, state);
+    workers.Submit([state, description, create = std::move(create), optimize = optimize_] {
+        VkPipeline pipeline = create(description);
+        Finish(*state, pipeline);
+        // Already on a worker, so the optimized build follows right away instead of queueing behind other compiles.
+        if (pipeline != VK_NULL_HANDLE && optimize) {
+            if (VkPipeline optimized = optimize(description); optimized != VK_NULL_HANDLE) {
+                Replace(*state, optimized);
+            }
+        }
+    });
+    return PipelineHandle(std::move(state));
+}
+
+void PipelineCache::Destroy(VkDevice device) {
+    for (const auto &[description, state]: pipelines_) {
+        if (VkPipeline pipeline = state->pipeline.load(std::memory_order_acquire); pipeline != VK_NULL_HANDLE) {
+            vkDestroyPipeline(device, pipeline, VK_NULL_HANDLE);
+        }
+        if (state->replaced != VK_NULL_HANDLE) {
+            vkDestroyPipeline(device, state->replaced, VK_NULL_HANDLE);
+        }
+    }
+    pipelines_.clear();
+}
+
+std::size_t PipelineCache::GetHitCount() const {
+    return hits_;
+}
+
+std::size_t PipelineCache::GetMissCount() const {
+    return misses_;
+}
+
+void PipelineCache::RetryFailed() {
+    std::erase_if(pipelines_, [](const auto &entry) {
+        return entry.second->status.load(std::memory_order_acquire) == PipelineStatus::Failed;
+    });
+}
+
+std::size_t PipelineCache::GetPipelineCount() const {
+    return std::ranges::count_if(pipelines_, [](const auto &entry) {
+        return entry.second->status.load(std::memory_order_acquire) != PipelineStatus::Failed;
+    });
+}
+} // veng
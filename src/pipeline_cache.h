@@ -0,0 +1,158 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "packed_vertex.h"
+#include "shader_variant.h"
+#include "spirv_reflection.h"
+#include "thread_pool.h"
+#include "vertex.h"
+#include "vertex_layout.h"
+
+namespace veng {
+struct VertexLayout {
+    std::vector<VkVertexInputBindingDescription> bindings;
+    std::vector<VkVertexInputAttributeDescription> attributes;
+
+    template <typename... Bindings>
+    static VertexLayout From() {
+        constexpr auto layout = MakeVertexLayout<Bindings...>();
+        return {{layout.bindings.begin(), layout.bindings.end()}, {layout.attributes.begin(), layout.attributes.end()}};
+    }
+
+    template <typename T>
+    static VertexLayout FromVertex() {
+        return From<PerVertex<T>>();
+    }
+
+    // For meshes from QuantizeMesh, drawn with packed.vert.
+    static VertexLayout FromPackedVertex(const PackedVertexFormat &format);
+
+    // T on binding 0, plus a per-instance glm::mat4 on binding 1 taking the four locations after T's attributes.
+    template <typename T>
+    static VertexLayout FromInstancedVertex() {
+        return From<PerVertex<T>, PerInstance<glm::mat4>>();
+    }
+
+    // Tightly packed, per-vertex binding 0 holding every input in location order.
+    static VertexLayout FromReflection(const ShaderReflection &reflection);
+
+    bool operator==(const VertexLayout &other) const;
+};
+
+enum class BlendMode : std::uint8_t {
+    Opaque,
+    AlphaBlend,
+    Additive
+};
+
+VkPipelineColorBlendAttachmentState GetBlendAttachmentState(BlendMode blend_mode);
+
+// Everything that distinguishes one graphics pipeline from another. Render pass and sample count are shared by every
+// pipeline Graphics creates and the layout follows from the shaders, so none of them are part of the key.
+struct PipelineDescription {
+    std::string vertex_shader = "basic.vert";
+    std::string fragment_shader = "basic.frag";
+    // Variant of the shaders; each combination becomes its own specialized pipeline.
+    ShaderFeatures shader_features{ShaderFeature::Textured};
+    // Left empty, the layout is derived from the vertex shader's inputs.
+    VertexLayout vertex_layout = VertexLayout::FromVertex<Vertex>();
+    VkPrimitiveTopology topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
+    bool primitive_restart = false;
+    VkCullModeFlags cull_mode = VK_CULL_MODE_NONE;
+    VkFrontFace front_face = VK_FRONT_FACE_CLOCKWISE;
+    BlendMode blend_mode = BlendMode::AlphaBlend;
+    bool depth_test = true;
+    bool depth_write = true;
+    VkCompareOp depth_compare = VK_COMPARE_OP_LESS;
+
+    bool operator==(const PipelineDescription &other) const = default;
+};
+
+struct PipelineDescriptionHash {
+    std::size_t operator()(const PipelineDescription &description) const;
+};
+
+enum class PipelineStatus : std::uint8_t {
+    Pending,
+    Ready,
+    Failed
+};
+
+// Future-like view of a pipeline that may still be compiling on a worker thread. Copies share the same result.
+class PipelineHandle {
+public:
+    PipelineHandle() = default;
+
+    [[nodiscard]] PipelineStatus GetStatus() const;
+    [[nodiscard]] bool IsReady() const;
+    // VK_NULL_HANDLE until the pipeline is ready.
+    [[nodiscard]] VkPipeline Get() const;
+    // Blocks until compilation finished either way.
+    VkPipeline Wait() const;
+
+private:
+    friend class PipelineCache;
+
+    struct State {
+        std::atomic<PipelineStatus> status = PipelineStatus::Pending;
+        // Replaced once if an optimized build arrives; the replaced pipeline is kept until the cache is destroyed
+        // because frames in flight may still use it.
+        std::atomic<VkPipeline> pipeline = VK_NULL_HANDLE;
+        VkPipeline replaced = VK_NULL_HANDLE;
+        std::mutex mutex;
+        std::condition_variable finished;
+    };
+
+    explicit PipelineHandle(std::shared_ptr<State> state) : state_(std::move(state)) {}
+
+    std::shared_ptr<State> state_;
+};
+
+// Owns every pipeline built from a description; equal descriptions always get the same VkPipeline back. Lookups are
+// meant for a single thread; only the compilation itself runs on the worker pool.
+class PipelineCache final {
+public:
+    using CreateFunction = std::function<VkPipeline(const PipelineDescription &)>;
+
+    // Failed creations are cached as well and keep returning VK_NULL_HANDLE until RetryFailed. Waits if the pipeline is
+    // compiling asynchronously.
+    VkPipeline GetOrCreate(const PipelineDescription &description, const CreateFunction &create);
+    // Returns immediately; `create` runs on `workers` unless the description is already cached or in flight.
+    PipelineHandle GetOrCreateAsync(const PipelineDescription &description, CreateFunction create,
+                                    ThreadPool &workers);
+    // Forgets failed pipelines so the next request compiles them again, e.g. once broken shader overrides were fixed.
+    void RetryFailed();
+    // The worker pool must have been shut down first so no compilation is still writing results.
+    void Destroy(VkDevice device);
+
+    // For pipelines that are quick to create but not the fastest to run: every newly created pipeline is rebuilt by
+    // `optimize` on `workers` and swapped in when done. Lookups keep returning the first pipeline until then.
+    void SetOptimizer(CreateFunction optimize, ThreadPool &workers);
+
+    [[nodiscard]] std::size_t GetHitCount() const;
+    [[nodiscard]] std::size_t GetMissCount() const;
+    [[nodiscard]] std::size_t GetPipelineCount() const;
+
+private:
+    std::shared_ptr<PipelineHandle::State> Find(const PipelineDescription &description);
+    static void Finish(PipelineHandle::State &state, VkPipeline pipeline);
+    static void Replace(PipelineHandle::State &state, VkPipeline pipeline);
+    void Optimize(const std::shared_ptr<PipelineHandle::State> &state, const PipelineDescription &description);
+
+    std::unordered_map<PipelineDescription, std::shared_ptr<PipelineHandle::State>, PipelineDescriptionHash>
+    pipelines_;
+    CreateFunction optimize_;
+    ThreadPool *optimize_workers_ = nullptr;
+    std::size_t hits_ = 0;
+    std::size_t misses_ = 0;
+};
+} // veng
@@ -0,0 +1,97 @@
+#include "pipeline_library.h"
+
+#include <precomp.h>
+
+namespace veng {
+VkGraphicsPipelineLibraryFlagsEXT GetPipelineLibraryFlags(const PipelineLibraryPart part) {
+    switch (part) {
+        case PipelineLibraryPart::VertexInput:
+            return VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT;
+        case PipelineLibraryPart::PreRasterization:
+            return VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT;
+        case PipelineLibraryPart::FragmentShader:
+            return VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT;
+        case PipelineLibraryPart::FragmentOutput:
+            return VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT;
+    }
+    return 0;
+}
+
+PipelineDescription GetPipelineLibraryKey(const PipelineDescription &description, const PipelineLibraryPart part) {
+    PipelineDescription key;
+    switch (part) {
+        case PipelineLibraryPart::VertexInput:
+            key.vertex_layout = description.vertex_layout;
+            key.topology = description.topology;
+            key.primitive_restart = description.primitive_restart;
+            break;
+        case PipelineLibraryPart::PreRasterization:
+            key.vertex_shader = description.vertex_shader;
+            key.fragment_shader = description.fragment_shader;
+            key.shader_features = description.shader_features;
+            key.cull_mode = description.cull_mode;
+            key.front_face = description.front_face;
+            break;
+        case PipelineLibraryPart::FragmentShader:
+            key.vertex_shader = description.vertex_shader;
+            key.fragment_shader = description.fragment_shader;
+            key.shader_features = description.shader_features;
+            key.depth_test = description.depth_test;
+            key.depth_write = description.depth_write;
+            key.depth_compare = description.depth_compare;
+            break;
+        case PipelineLibraryPart::FragmentOutput:
+            key.blend_mode = description.blend_mode;
+            break;
+    }
+    return key;
+}
+
+void PipelineLibraryCache::Initialize(const VkDevice device) {
+    device_ = device;
+}
+
+void PipelineLibraryCache::Destroy() {
+    std::lock_guard lock(mutex_);
+    for (PartMap &parts: parts_) {
+        for (const auto &[key, library]: parts) {
+            vkDestroyPipeline(device_, library, VK_NULL_HANDLE);
+        }
+        parts.clear();
+    }
+}
+
+VkPipeline PipelineLibraryCache::GetOrCreate(const PipelineDescription &description, const PipelineLibraryPart part,
+                                             const CreateFunction &create) {
+    PipelineDescription key = GetPipelineLibraryKey(description, part);
+    PartMap &parts = parts_[static_cast<std::size_t>(part)];
+
+    {
+        std::lock_guard lock(mutex_);
+        if (const auto it = parts.find(key); it != parts.end()) {
+            return it->second;
+        }
+    }
+
+    VkPipeline library = create(part);
+    if (library == VK_NULL_HANDLE) {
+        return VK_NULL_HANDLE;
+    }
+
+    std::lock_guard lock(mutex_);
+    const auto [it, inserted] = parts.emplace(std::move(key), library);
+    if (!inserted) {
+        vkDestroyPipeline(device_, library, VK_NULL_HANDLE);
+    }
+    return it->second;
+}
+
+std::size_t PipelineLibraryCache::GetPartCount() const {
+    std::lock_guard lock(mutex_);
+    std::size_t count = 0;
+    for (const PartMap &parts: parts_) {
+        count += parts.size();
+    }
+    return count;
+}
+} // veng
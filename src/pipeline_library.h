@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vulkan/vulkan.h>
+
+#include "pipeline_cache.h"
+
+namespace veng {
+// The four independently compiled pieces of a graphics pipeline under VK_EXT_graphics_pipeline_library.
+enum class PipelineLibraryPart : std::uint8_t {
+    VertexInput,
+    PreRasterization,
+    FragmentShader,
+    FragmentOutput
+};
+
+constexpr std::size_t kPipelineLibraryPartCount = 4;
+
+VkGraphicsPipelineLibraryFlagsEXT GetPipelineLibraryFlags(PipelineLibraryPart part);
+
+// Reduces a description to the fields the part is built from, so descriptions that differ elsewhere share it. Both
+// shader parts keep both shader names because the pipeline layout follows from the pair.
+PipelineDescription GetPipelineLibraryKey(const PipelineDescription &description, PipelineLibraryPart part);
+
+// Owns pipeline library parts, keyed per part by the reduced description. Parts are built from pipeline worker
+// threads too, so lookups are locked; creation runs unlocked and the first result wins a race.
+class PipelineLibraryCache final {
+public:
+    using CreateFunction = std::function<VkPipeline(PipelineLibraryPart)>;
+
+    void Initialize(VkDevice device);
+    void Destroy();
+
+    // VK_NULL_HANDLE if `create` failed; failures are not cached.
+    VkPipeline GetOrCreate(const PipelineDescription &description, PipelineLibraryPart part,
+                           const CreateFunction &create);
+
+    [[nodiscard]] std::size_t GetPartCount() const;
+
+private:
+    using PartMap = std::unordered_map<PipelineDescription, VkPipeline, PipelineDescriptionHash>;
+
+    VkDevice device_ = VK_NULL_HANDLE;
+    mutable std::mutex mutex_;
+    std::array<PartMap, kPipelineLibraryPartCount> parts_;
+};
+} // veng
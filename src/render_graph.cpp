@@ -0,0 +1,628 @@
+#include "render_graph.h"
+
+#include <algorithm>
+#include <limits>
+#include <optional>
+#include <precomp.h>
+#include <queue>
+#include <stdexcept>
+
+namespace veng {
+namespace {
+constexpr VkAccessFlags2 kWriteAccessMask = VK_ACCESS_2_SHADER_WRITE_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT |
+                                            VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT |
+                                            VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+                                            VK_ACCESS_2_TRANSFER_WRITE_BIT | VK_ACCESS_2_HOST_WRITE_BIT |
+                                            VK_ACCESS_2_MEMORY_WRITE_BIT;
+
+bool ContainsAll(const VkFlags64 flags, const VkFlags64 required) {
+    return (flags & required) == required;
+}
+}
+
+ResourceState GetAccessState(const RenderGraphAccess access) {
+    switch (access) {
+        case RenderGraphAccess::ColorAttachmentWrite:
+            return {
+                VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+                VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT,
+                VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL
+            };
+        case RenderGraphAccess::DepthAttachmentWrite:
+            return {
+                VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+                VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+                VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL
+            };
+        case RenderGraphAccess::DepthAttachmentRead:
+            return {
+                VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+                VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT,
+                VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL
+            };
+        case RenderGraphAccess::FragmentShaderRead:
+            return {
+                VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+                VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+            };
+        case RenderGraphAccess::FragmentStorageRead:
+            return {
+                VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+                VK_ACCESS_2_SHADER_STORAGE_READ_BIT,
+                VK_IMAGE_LAYOUT_GENERAL
+            };
+        case RenderGraphAccess::ComputeShaderRead:
+            return {
+                VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                VK_ACCESS_2_SHADER_SAMPLED_READ_BIT,
+                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+            };
+        case RenderGraphAccess::ComputeStorageRead:
+            return {
+                VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                VK_ACCESS_2_SHADER_STORAGE_READ_BIT,
+                VK_IMAGE_LAYOUT_GENERAL
+            };
+        case RenderGraphAccess::ComputeShaderWrite:
+            return {
+                VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT,
+                VK_IMAGE_LAYOUT_GENERAL
+            };
+        case RenderGraphAccess::VertexInputRead:
+            return {
+                VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT,
+                VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_2_INDEX_READ_BIT,
+                VK_IMAGE_LAYOUT_UNDEFINED
+            };
+        case RenderGraphAccess::IndirectRead:
+            return {
+                VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT,
+                VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT,
+                VK_IMAGE_LAYOUT_UNDEFINED
+            };
+        case RenderGraphAccess::TransferRead:
+            return {VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_READ_BIT, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL};
+        case RenderGraphAccess::TransferWrite:
+            return {VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL};
+        case RenderGraphAccess::Present:
+            return {VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR};
+    }
+
+    return {VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT,
+            VK_IMAGE_LAYOUT_GENERAL};
+}
+
+ResourceState GetLayoutState(const VkImageLayout layout) {
+    switch (layout) {
+        case VK_IMAGE_LAYOUT_UNDEFINED:
+        case VK_IMAGE_LAYOUT_PREINITIALIZED:
+            return {VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE, layout};
+        case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:
+            return GetAccessState(RenderGraphAccess::TransferRead);
+        case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:
+            return GetAccessState(RenderGraphAccess::TransferWrite);
+        case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:
+            return {
+                VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                VK_ACCESS_2_SHADER_SAMPLED_READ_BIT, layout
+            };
+        case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:
+            return GetAccessState(RenderGraphAccess::ColorAttachmentWrite);
+        case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
+            return GetAccessState(RenderGraphAccess::DepthAttachmentWrite);
+        case VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL:
+            return GetAccessState(RenderGraphAccess::DepthAttachmentRead);
+        case VK_IMAGE_LAYOUT_PRESENT_SRC_KHR:
+            return GetAccessState(RenderGraphAccess::Present);
+        default:
+            return {
+                VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, VK_ACCESS_2_MEMORY_READ_BIT | VK_ACCESS_2_MEMORY_WRITE_BIT, layout
+            };
+    }
+}
+
+VkImageAspectFlags GetLayoutAspect(const VkImageLayout layout) {
+    switch (layout) {
+        case VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL:
+        case VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL:
+        case VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL:
+        case VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL:
+            return VK_IMAGE_ASPECT_DEPTH_BIT;
+        default:
+            return VK_IMAGE_ASPECT_COLOR_BIT;
+    }
+}
+
+#pragma region PASS_BUILDER
+
+void RenderGraph::PassBuilder::Read(const RenderGraphResource resource, const RenderGraphAccess access,
+                                    const SubresourceRange &range) {
+    graph_.passes_[pass_].usages.push_back({resource, access, false, range});
+}
+
+void RenderGraph::PassBuilder::Write(const RenderGraphResource resource, const RenderGraphAccess access,
+                                     const SubresourceRange &range) {
+    graph_.passes_[pass_].usages.push_back({resource, access, true, range});
+}
+
+void RenderGraph::PassBuilder::SetSideEffect() {
+    graph_.passes_[pass_].side_effect = true;
+}
+
+#pragma endregion
+
+#pragma region DECLARATION
+
+RenderGraphResource RenderGraph::ImportImage(std::string name, VkImage image, const VkImageAspectFlags aspect,
+                                             const ResourceState &current_state, const std::uint32_t mip_levels,
+                                             const std::uint32_t array_layers) {
+    Resource resource;
+    resource.name = std::move(name);
+    resource.image = image;
+    resource.aspect = aspect;
+    resource.mip_levels = std::max(mip_levels, 1u);
+    resource.array_layers = std::max(array_layers, 1u);
+
+    SubresourceState state;
+    state.layout = current_state.layout;
+    if (current_state.access & kWriteAccessMask) {
+        state.write_stages = current_state.stages;
+        state.write_access = current_state.access & kWriteAccessMask;
+    } else {
+        state.read_stages = current_state.stages;
+        state.read_access = current_state.access;
+    }
+    resource.initial_states.assign(resource.mip_levels * resource.array_layers, state);
+
+    resources_.push_back(std::move(resource));
+    return static_cast<RenderGraphResource>(resources_.size() - 1);
+}
+
+RenderGraphResource RenderGraph::ImportBuffer(std::string name, VkBuffer buffer, const ResourceState &current_state) {
+    const RenderGraphResource resource = ImportImage(std::move(name), VK_NULL_HANDLE, 0, current_state);
+    resources_[resource].buffer = buffer;
+    resources_[resource].initial_states[0].layout = VK_IMAGE_LAYOUT_UNDEFINED;
+    return resource;
+}
+
+RenderGraphResource RenderGraph::CreateImage(std::string name, const TransientImageDescription &description) {
+    const RenderGraphResource resource = ImportImage(std::move(name), VK_NULL_HANDLE, description.aspect, {},
+                                                     description.mip_levels, description.array_layers);
+    resources_[resource].transient = TransientResourceRequest{true, description, {}};
+    return resource;
+}
+
+RenderGraphResource RenderGraph::CreateBuffer(std::string name, const TransientBufferDescription &description) {
+    const RenderGraphResource resource = ImportBuffer(std::move(name), VK_NULL_HANDLE, {});
+    resources_[resource].transient = TransientResourceRequest{false, {}, description};
+    return resource;
+}
+
+void RenderGraph::AddPass(std::string name, const SetupFunction &setup, ExecuteFunction execute) {
+    Pass pass;
+    pass.name = std::move(name);
+    pass.execute = std::move(execute);
+    passes_.push_back(std::move(pass));
+
+    PassBuilder builder(*this, static_cast<std::uint32_t>(passes_.size() - 1));
+    setup(builder);
+}
+
+void RenderGraph::MarkOutput(const RenderGraphResource resource, const RenderGraphAccess final_access) {
+    resources_[resource].is_output = true;
+    resources_[resource].final_access = final_access;
+}
+
+void RenderGraph::Reset() {
+    resources_.clear();
+    passes_.clear();
+    execution_order_.clear();
+    final_barriers_.image_barriers.clear();
+    final_barriers_.buffer_barriers.clear();
+}
+
+#pragma endregion
+
+#pragma region COMPILATION
+
+void RenderGraph::Compile(TransientResourcePool *transient_pool) {
+    CullPasses();
+    OrderPasses();
+    RealizeTransients(transient_pool);
+    PlanBarriers();
+}
+
+void RenderGraph::CullPasses() {
+    std::vector<bool> needed(resources_.size());
+    for (std::size_t i = 0; i < resources_.size(); ++i) {
+        needed[i] = resources_[i].is_output;
+    }
+
+    for (auto pass = passes_.rbegin(); pass != passes_.rend(); ++pass) {
+        pass->culled = !pass->side_effect && std::ranges::none_of(pass->usages, [&needed](const ResourceUsage &usage) {
+            return usage.write && needed[usage.resource];
+        });
+
+        if (pass->culled) {
+            continue;
+        }
+
+        for (const ResourceUsage &usage: pass->usages) {
+            if (!usage.write) {
+                needed[usage.resource] = true;
+            }
+        }
+    }
+}
+
+void RenderGraph::OrderPasses() {
+    struct Tracking {
+        std::optional<std::uint32_t> last_writer;
+        std::vector<std::uint32_t> readers;
+    };
+
+    std::vector<std::vector<std::uint32_t>> successors(passes_.size());
+    std::vector<std::uint32_t> in_degree(passes_.size());
+    std::vector<Tracking> tracking(resources_.size());
+
+    auto add_edge = [&successors, &in_degree](const std::uint32_t from, const std::uint32_t to) {
+        if (from != to) {
+            successors[from].push_back(to);
+            ++in_degree[to];
+        }
+    };
+
+    for (std::uint32_t i = 0; i < passes_.size(); ++i) {
+        if (passes_[i].culled) {
+            continue;
+        }
+
+        for (const ResourceUsage &usage: passes_[i].usages) {
+            const Tracking &resource_tracking = tracking[usage.resource];
+            if (resource_tracking.last_writer.has_value()) {
+                add_edge(resource_tracking.last_writer.value(), i);
+            }
+            if (usage.write) {
+                for (const std::uint32_t reader: resource_tracking.readers) {
+                    add_edge(reader, i);
+                }
+            }
+        }
+
+        for (const ResourceUsage &usage: passes_[i].usages) {
+            Tracking &resource_tracking = tracking[usage.resource];
+            if (usage.write) {
+                resource_tracking.last_writer = i;
+                resource_tracking.readers.clear();
+            } else {
+                resource_tracking.readers.push_back(i);
+            }
+        }
+    }
+
+    // Ties are broken by declaration order so the schedule is deterministic frame to frame.
+    std::priority_queue<std::uint32_t, std::vector<std::uint32_t>, std::greater<>> ready;
+    for (std::uint32_t i = 0; i < passes_.size(); ++i) {
+        if (!passes_[i].culled && in_degree[i] == 0) {
+            ready.push(i);
+        }
+    }
+
+    execution_order_.clear();
+    while (!ready.empty()) {
+        const std::uint32_t pass = ready.top();
+        ready.pop();
+        execution_order_.push_back(pass);
+
+        for (const std::uint32_t successor: successors[pass]) {
+            if (--in_degree[successor] == 0) {
+                ready.push(successor);
+            }
+        }
+    }
+}
+
+void RenderGraph::RealizeTransients(TransientResourcePool *transient_pool) {
+    constexpr std::uint32_t kUnused = std::numeric_limits<std::uint32_t>::max();
+    std::vector<std::uint32_t> first_use(resources_.size(), kUnused);
+    std::vector<std::uint32_t> last_use(resources_.size(), 0);
+    for (std::uint32_t position = 0; position < execution_order_.size(); ++position) {
+        for (const ResourceUsage &usage: passes_[execution_order_[position]].usages) {
+            first_use[usage.resource] = std::min(first_use[usage.resource], position);
+            last_use[usage.resource] = position;
+        }
+    }
+
+    // Transients only touched by culled passes get no memory at all.
+    std::vector<TransientResourceRequest> requests;
+    std::vector<RenderGraphResource> requested_resources;
+    for (RenderGraphResource resource = 0; resource < resources_.size(); ++resource) {
+        if (!resources_[resource].transient.has_value() || first_use[resource] == kUnused) {
+            continue;
+        }
+
+        TransientResourceRequest request = resources_[resource].transient.value();
+        request.first_use = first_use[resource];
+        request.last_use = resources_[resource].is_output
+                               ? static_cast<std::uint32_t>(execution_order_.size())
+                               : last_use[resource];
+        requests.push_back(request);
+        requested_resources.push_back(resource);
+    }
+
+    if (requests.empty()) {
+        return;
+    }
+    if (transient_pool == nullptr) {
+        throw std::runtime_error("render graph declares transient resources but has no pool to place them in!");
+    }
+
+    const std::vector<TransientResource> &realized = transient_pool->Realize(requests);
+    for (std::size_t i = 0; i < requested_resources.size(); ++i) {
+        Resource &resource = resources_[requested_resources[i]];
+        resource.image = realized[i].image;
+        resource.image_view = realized[i].image_view;
+        resource.buffer = realized[i].buffer;
+        resource.first_use = requests[i].first_use;
+        resource.aliased_predecessors.clear();
+        for (const std::uint32_t predecessor: realized[i].aliased_predecessors) {
+            resource.aliased_predecessors.push_back(requested_resources[predecessor]);
+        }
+    }
+}
+
+void RenderGraph::PlanBarriers() {
+    std::vector<std::vector<SubresourceState>> states(resources_.size());
+    for (std::size_t i = 0; i < resources_.size(); ++i) {
+        states[i] = resources_[i].initial_states;
+    }
+
+    for (Pass &pass: passes_) {
+        pass.barriers.image_barriers.clear();
+        pass.barriers.buffer_barriers.clear();
+    }
+
+    for (std::uint32_t position = 0; position < execution_order_.size(); ++position) {
+        // A transient taking over memory must wait for everything the previous occupants still had in flight.
+        for (RenderGraphResource resource = 0; resource < resources_.size(); ++resource) {
+            const Resource &aliasing = resources_[resource];
+            if (aliasing.aliased_predecessors.empty() || aliasing.first_use != position) {
+                continue;
+            }
+
+            SubresourceState seed;
+            for (const RenderGraphResource predecessor: aliasing.aliased_predecessors) {
+                for (const SubresourceState &state: states[predecessor]) {
+                    seed.write_stages |= state.write_stages | state.read_stages;
+                    seed.write_access |= state.write_access;
+                }
+            }
+            std::ranges::fill(states[resource], seed);
+        }
+
+        Pass &pass = passes_[execution_order_[position]];
+        for (const PlannedUsage &usage: MergeUsages(pass.usages)) {
+            AddTransition(states[usage.resource], resources_[usage.resource], usage, pass.barriers);
+        }
+    }
+
+    final_barriers_.image_barriers.clear();
+    final_barriers_.buffer_barriers.clear();
+    for (RenderGraphResource resource = 0; resource < resources_.size(); ++resource) {
+        if (resources_[resource].is_output) {
+            const PlannedUsage usage = {resource, GetAccessState(resources_[resource].final_access), false, {}};
+            AddTransition(states[resource], resources_[resource], usage, final_barriers_);
+        }
+    }
+}
+
+std::vector<RenderGraph::PlannedUsage> RenderGraph::MergeUsages(const std::vector<ResourceUsage> &usages) {
+    std::vector<PlannedUsage> planned;
+    planned.reserve(usages.size());
+    for (const ResourceUsage &usage: usages) {
+        const ResourceState state = GetAccessState(usage.access);
+        auto it = std::ranges::find_if(planned, [&usage](const PlannedUsage &other) {
+            return other.resource == usage.resource && other.range == usage.range;
+        });
+        if (it == planned.end()) {
+            planned.push_back({usage.resource, state, usage.write, usage.range});
+            continue;
+        }
+
+        it->state.stages |= state.stages;
+        it->state.access |= state.access;
+        it->write = it->write || usage.write;
+        if (it->state.layout != state.layout) {
+            // Every access is valid in the general layout.
+            it->state.layout = VK_IMAGE_LAYOUT_GENERAL;
+        }
+    }
+    return planned;
+}
+
+void RenderGraph::AddTransition(std::vector<SubresourceState> &states, const Resource &resource,
+                                const PlannedUsage &usage, Barriers &barriers) const {
+    const ResourceState &desired = usage.state;
+    const VkImageLayout desired_layout = resource.buffer != VK_NULL_HANDLE ? VK_IMAGE_LAYOUT_UNDEFINED : desired.layout;
+
+    auto needs_barrier = [&](const SubresourceState &state) {
+        if (usage.write || state.layout != desired_layout) {
+            return true;
+        }
+        if (state.write_stages == VK_PIPELINE_STAGE_2_NONE) {
+            return false;
+        }
+        return !ContainsAll(state.read_stages, desired.stages) || !ContainsAll(state.read_access, desired.access);
+    };
+
+    auto apply = [&](SubresourceState &state) {
+        if (usage.write) {
+            state.write_stages = desired.stages;
+            state.write_access = desired.access & kWriteAccessMask;
+            state.read_stages = VK_PIPELINE_STAGE_2_NONE;
+            state.read_access = VK_ACCESS_2_NONE;
+        } else if (state.layout != desired_layout) {
+            // Later readers in other stages must still wait for the layout transition.
+            state.write_stages |= desired.stages;
+            state.read_stages = desired.stages;
+            state.read_access = desired.access;
+        } else {
+            state.read_stages |= desired.stages;
+            state.read_access |= desired.access;
+        }
+        state.layout = desired_layout;
+    };
+
+    if (resource.buffer != VK_NULL_HANDLE) {
+        SubresourceState &state = states[0];
+        if (needs_barrier(state)) {
+            VkBufferMemoryBarrier2 barrier = {};
+            barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2;
+            barrier.srcStageMask = state.write_stages | state.read_stages;
+            barrier.srcAccessMask = state.write_access;
+            barrier.dstStageMask = desired.stages;
+            barrier.dstAccessMask = desired.access;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.buffer = resource.buffer;
+            barrier.offset = 0;
+            barrier.size = VK_WHOLE_SIZE;
+            barriers.buffer_barriers.push_back(barrier);
+        }
+        apply(state);
+        return;
+    }
+
+    const std::uint32_t base_mip = std::min(usage.range.base_mip, resource.mip_levels - 1);
+    const std::uint32_t mip_end = usage.range.mip_count == VK_REMAINING_MIP_LEVELS
+                                      ? resource.mip_levels
+                                      : std::min(resource.mip_levels, base_mip + usage.range.mip_count);
+    const std::uint32_t base_layer = std::min(usage.range.base_layer, resource.array_layers - 1);
+    const std::uint32_t layer_end = usage.range.layer_count == VK_REMAINING_ARRAY_LAYERS
+                                        ? resource.array_layers
+                                        : std::min(resource.array_layers, base_layer + usage.range.layer_count);
+
+    const std::size_t first_barrier = barriers.image_barriers.size();
+
+    for (std::uint32_t layer = base_layer; layer < layer_end; ++layer) {
+        for (std::uint32_t mip = base_mip; mip < mip_end; ++mip) {
+            SubresourceState &state = states[layer * resource.mip_levels + mip];
+            if (!needs_barrier(state)) {
+                apply(state);
+                continue;
+            }
+
+            const VkPipelineStageFlags2 src_stages = state.write_stages | state.read_stages;
+
+            // Neighbouring mips of the same layer coming from the same state share one barrier.
+            if (barriers.image_barriers.size() > first_barrier) {
+                VkImageMemoryBarrier2 &previous = barriers.image_barriers.back();
+                if (previous.subresourceRange.baseArrayLayer == layer &&
+                    previous.subresourceRange.baseMipLevel + previous.subresourceRange.levelCount == mip &&
+                    previous.oldLayout == state.layout && previous.srcStageMask == src_stages &&
+                    previous.srcAccessMask == state.write_access) {
+                    ++previous.subresourceRange.levelCount;
+                    apply(state);
+                    continue;
+                }
+            }
+
+            VkImageMemoryBarrier2 barrier = {};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2;
+            barrier.srcStageMask = src_stages;
+            barrier.srcAccessMask = state.write_access;
+            barrier.dstStageMask = desired.stages;
+            barrier.dstAccessMask = desired.access;
+            barrier.oldLayout = state.layout;
+            barrier.newLayout = desired_layout;
+            barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+            barrier.image = resource.image;
+            barrier.subresourceRange.aspectMask = resource.aspect;
+            barrier.subresourceRange.baseMipLevel = mip;
+            barrier.subresourceRange.levelCount = 1;
+            barrier.subresourceRange.baseArrayLayer = layer;
+            barrier.subresourceRange.layerCount = 1;
+            barriers.image_barriers.push_back(barrier);
+
+            apply(state);
+        }
+    }
+
+    // Then identical mip runs of consecutive layers collapse into one barrier.
+    auto &image_barriers = barriers.image_barriers;
+    std::size_t merged_end = first_barrier;
+    for (std::size_t i = first_barrier; i < image_barriers.size(); ++i) {
+        if (merged_end > first_barrier) {
+            VkImageMemoryBarrier2 &previous = image_barriers[merged_end - 1];
+            const VkImageMemoryBarrier2 &current = image_barriers[i];
+            if (previous.subresourceRange.baseMipLevel == current.subresourceRange.baseMipLevel &&
+                previous.subresourceRange.levelCount == current.subresourceRange.levelCount &&
+                previous.subresourceRange.baseArrayLayer + previous.subresourceRange.layerCount ==
+                current.subresourceRange.baseArrayLayer &&
+                previous.oldLayout == current.oldLayout && previous.srcStageMask == current.srcStageMask &&
+                previous.srcAccessMask == current.srcAccessMask) {
+                previous.subresourceRange.layerCount += current.subresourceRange.layerCount;
+                continue;
+            }
+        }
+        image_barriers[merged_end++] = image_barriers[i];
+    }
+    image_barriers.resize(merged_end);
+}
+
+#pragma endregion
+
+#pragma region EXECUTION
+
+void RenderGraph::RecordBarriers(VkCommandBuffer command_buffer, const Barriers &barriers) {
+    if (barriers.IsEmpty()) {
+        return;
+    }
+
+    VkDependencyInfo dependency_info = {};
+    dependency_info.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO;
+    dependency_info.imageMemoryBarrierCount = barriers.image_barriers.size();
+    dependency_info.pImageMemoryBarriers = barriers.image_barriers.data();
+    dependency_info.bufferMemoryBarrierCount = barriers.buffer_barriers.size();
+    dependency_info.pBufferMemoryBarriers = barriers.buffer_barriers.data();
+
+    vkCmdPipelineBarrier2KHR(command_buffer, &dependency_info);
+}
+
+void RenderGraph::Execute(VkCommandBuffer command_buffer) const {
+    for (const std::uint32_t index: execution_order_) {
+        const Pass &pass = passes_[index];
+        RecordBarriers(command_buffer, pass.barriers);
+        if (pass.execute) {
+            pass.execute(command_buffer);
+        }
+    }
+
+    RecordBarriers(command_buffer, final_barriers_);
+}
+
+VkImage RenderGraph::GetImage(const RenderGraphResource resource) const {
+    return resources_[resource].image;
+}
+
+VkImageView RenderGraph::GetImageView(const RenderGraphResource resource) const {
+    return resources_[resource].image_view;
+}
+
+VkBuffer RenderGraph::GetBuffer(const RenderGraphResource resource) const {
+    return resources_[resource].buffer;
+}
+
+std::size_t RenderGraph::GetExecutedPassCount() const {
+    return execution_order_.size();
+}
+
+std::size_t RenderGraph::GetCulledPassCount() const {
+    return std::ranges::count_if(passes_, [](const Pass &pass) { return pass.culled; });
+}
+
+#pragma endregion
+} // veng
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+#include "transient_resource_pool.h"
+
+namespace veng {
+using RenderGraphResource = std::uint32_t;
+
+enum class RenderGraphAccess : std::uint8_t {
+    ColorAttachmentWrite,
+    DepthAttachmentWrite,
+    DepthAttachmentRead,
+    // Sampled image reads, in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL.
+    FragmentShaderRead,
+    // Storage image and storage buffer reads; images stay in VK_IMAGE_LAYOUT_GENERAL like for writes.
+    FragmentStorageRead,
+    ComputeShaderRead,
+    ComputeStorageRead,
+    ComputeShaderWrite,
+    VertexInputRead,
+    IndirectRead,
+    TransferRead,
+    TransferWrite,
+    Present
+};
+
+struct ResourceState {
+    VkPipelineStageFlags2 stages = VK_PIPELINE_STAGE_2_NONE;
+    VkAccessFlags2 access = VK_ACCESS_2_NONE;
+    VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+};
+
+struct SubresourceRange {
+    std::uint32_t base_mip = 0;
+    std::uint32_t mip_count = VK_REMAINING_MIP_LEVELS;
+    std::uint32_t base_layer = 0;
+    std::uint32_t layer_count = VK_REMAINING_ARRAY_LAYERS;
+
+    bool operator==(const SubresourceRange &other) const = default;
+};
+
+[[nodiscard]] ResourceState GetAccessState(RenderGraphAccess access);
+// Stage and access a resource in the given layout is typically used with; for one-off transitions.
+[[nodiscard]] ResourceState GetLayoutState(VkImageLayout layout);
+[[nodiscard]] VkImageAspectFlags GetLayoutAspect(VkImageLayout layout);
+
+// Passes declare the resources they touch; Compile() orders them, culls passes nothing depends on, and plans batched
+// synchronization2 barriers from the tracked per-subresource state. Rebuilt every frame, cheap to Reset().
+class RenderGraph final {
+public:
+    class PassBuilder {
+    public:
+        void Read(RenderGraphResource resource, RenderGraphAccess access, const SubresourceRange &range = {});
+        void Write(RenderGraphResource resource, RenderGraphAccess access, const SubresourceRange &range = {});
+        // Keeps the pass alive even if none of its writes are consumed.
+        void SetSideEffect();
+
+    private:
+        friend class RenderGraph;
+
+        PassBuilder(RenderGraph &graph, std::uint32_t pass) : graph_(graph), pass_(pass) {}
+
+        RenderGraph &graph_;
+        std::uint32_t pass_;
+    };
+
+    using SetupFunction = std::function<void(PassBuilder &)>;
+    using ExecuteFunction = std::function<void(VkCommandBuffer)>;
+
+    RenderGraphResource ImportImage(std::string name, VkImage image, VkImageAspectFlags aspect,
+                                    const ResourceState &current_state, std::uint32_t mip_levels = 1,
+                                    std::uint32_t array_layers = 1);
+    RenderGraphResource ImportBuffer(std::string name, VkBuffer buffer, const ResourceState &current_state);
+    // Graph-owned resources that only live between their first and last use this frame; their memory is shared with
+    // other transients whose lifetimes do not overlap. Contents start undefined, so the first use must be a write.
+    RenderGraphResource CreateImage(std::string name, const TransientImageDescription &description);
+    RenderGraphResource CreateBuffer(std::string name, const TransientBufferDescription &description);
+
+    void AddPass(std::string name, const SetupFunction &setup, ExecuteFunction execute);
+    // Resources left in `final_access` once the graph has executed; passes feeding them are never culled.
+    void MarkOutput(RenderGraphResource resource, RenderGraphAccess final_access);
+
+    // Graphs declaring transient resources need a pool to place them in.
+    void Compile(TransientResourcePool *transient_pool = nullptr);
+    void Execute(VkCommandBuffer command_buffer) const;
+    void Reset();
+
+    // Valid for transient resources once the graph has been compiled.
+    [[nodiscard]] VkImage GetImage(RenderGraphResource resource) const;
+    [[nodiscard]] VkImageView GetImageView(RenderGraphResource resource) const;
+    [[nodiscard]] VkBuffer GetBuffer(RenderGraphResource resource) const;
+
+    [[nodiscard]] std::size_t GetExecutedPassCount() const;
+    [[nodiscard]] std::size_t GetCulledPassCount() const;
+
+private:
+    struct SubresourceState {
+        VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+        VkPipelineStageFlags2 write_stages = VK_PIPELINE_STAGE_2_NONE;
+        VkAccessFlags2 write_access = VK_ACCESS_2_NONE;
+        VkPipelineStageFlags2 read_stages = VK_PIPELINE_STAGE_2_NONE;
+        VkAccessFlags2 read_access = VK_ACCESS_2_NONE;
+    };
+
+    struct Resource {
+        std::string name;
+        VkImage image = VK_NULL_HANDLE;
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkImageView image_view = VK_NULL_HANDLE;
+        VkImageAspectFlags aspect = 0;
+        std::uint32_t mip_levels = 1;
+        std::uint32_t array_layers = 1;
+        std::vector<SubresourceState> initial_states;
+        bool is_output = false;
+        RenderGraphAccess final_access = RenderGraphAccess::Present;
+        std::optional<TransientResourceRequest> transient;
+        // Position in the execution order of the first use, and the transients whose memory gets reused by then.
+        std::uint32_t first_use = 0;
+        std::vector<RenderGraphResource> aliased_predecessors;
+    };
+
+    struct ResourceUsage {
+        RenderGraphResource resource = 0;
+        RenderGraphAccess access = RenderGraphAccess::TransferRead;
+        bool write = false;
+        SubresourceRange range;
+    };
+
+    // What a pass needs from one resource range once all its usages of that range are combined.
+    struct PlannedUsage {
+        RenderGraphResource resource = 0;
+        ResourceState state;
+        bool write = false;
+        SubresourceRange range;
+    };
+
+    struct Barriers {
+        std::vector<VkImageMemoryBarrier2> image_barriers;
+        std::vector<VkBufferMemoryBarrier2> buffer_barriers;
+
+        [[nodiscard]] bool IsEmpty() const { return image_barriers.empty() && buffer_barriers.empty(); }
+    };
+
+    struct Pass {
+        std::string name;
+        std::vector<ResourceUsage> usages;
+        ExecuteFunction execute;
+        bool side_effect = false;
+        bool culled = false;
+        Barriers barriers;
+    };
+
+    void CullPasses();
+    void OrderPasses();
+    void RealizeTransients(TransientResourcePool *transient_pool);
+    void PlanBarriers();
+    // Usages of the same range within a pass become one, so reading and writing a resource in the same pass is
+    // transitioned once into a layout serving both instead of twice into conflicting ones.
+    static std::vector<PlannedUsage> MergeUsages(const std::vector<ResourceUsage> &usages);
+    void AddTransition(std::vector<SubresourceState> &states, const Resource &resource, const PlannedUsage &usage,
+                       Barriers &barriers) const;
+    static void RecordBarriers(VkCommandBuffer command_buffer, const Barriers &barriers);
+
+    std::vector<Resource> resources_;
+    std::vector<Pass> passes_;
+    std::vector<std::uint32_t> execution_order_;
+    Barriers final_barriers_;
+};
+} // veng
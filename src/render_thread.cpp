@@ -0,0 +1,109 @@
+#include "render_thread.h"
+
+#include <precomp.h>
+#include <utility>
+
+namespace veng {
+void FramePacket::Clear() {
+    view = glm::mat4(1.0f);
+    projection = glm::mat4(1.0f);
+    draws.clear();
+}
+
+RenderThread::RenderThread(const gsl::not_null<Graphics *> graphics)
+    : graphics_(graphics), thread_(&RenderThread::Loop, this) {
+}
+
+RenderThread::~RenderThread() {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    work_available_.notify_one();
+    thread_.join();
+}
+
+FramePacket &RenderThread::BeginPacket() {
+    std::unique_lock lock(mutex_);
+    packet_released_.wait(lock, [this] { return !packet_in_use_[write_packet_] || failure_ != nullptr; });
+    lock.unlock();
+    ThrowIfFailed();
+
+    FramePacket &packet = packets_[write_packet_];
+    packet.Clear();
+    return packet;
+}
+
+void RenderThread::SubmitPacket() {
+    const std::uint32_t packet_index = write_packet_;
+    write_packet_ = 1 - write_packet_;
+    {
+        std::lock_guard lock(mutex_);
+        packet_in_use_[packet_index] = true;
+        work_.emplace_back([this, packet_index](Graphics &) {
+            try {
+                Draw(packets_[packet_index]);
+            } catch (...) {
+                std::lock_guard failure_lock(mutex_);
+                failure_ = std::current_exception();
+            }
+            {
+                std::lock_guard release_lock(mutex_);
+                packet_in_use_[packet_index] = false;
+            }
+            packet_released_.notify_one();
+        });
+    }
+    work_available_.notify_one();
+}
+
+void RenderThread::Enqueue(Work work) {
+    {
+        std::lock_guard lock(mutex_);
+        work_.push_back(std::move(work));
+    }
+    work_available_.notify_one();
+}
+
+void RenderThread::Loop() {
+    while (true) {
+        Work work;
+        {
+            std::unique_lock lock(mutex_);
+            work_available_.wait(lock, [this] { return stopping_ || !work_.empty(); });
+            if (work_.empty()) {
+                return;
+            }
+            work = std::move(work_.front());
+            work_.pop_front();
+        }
+        work(*graphics_);
+    }
+}
+
+void RenderThread::Draw(const FramePacket &packet) const {
+    // A minimized window or an outdated swapchain drops the frame.
+    if (!graphics_->BeginFrame()) {
+        return;
+    }
+    // After BeginFrame, which waited until the GPU was done with this frame's uniform buffer.
+    graphics_->SetViewProjection(packet.view, packet.projection);
+    for (const DrawCommand &draw: packet.draws) {
+        graphics_->SetModelMatrix(draw.model);
+        graphics_->SetTexture(draw.texture);
+        graphics_->RenderIndexedBuffer(draw.vertex_buffer, draw.index_buffer, draw.index_count);
+    }
+    graphics_->EndFrame();
+}
+
+void RenderThread::ThrowIfFailed() {
+    std::exception_ptr failure;
+    {
+        std::lock_guard lock(mutex_);
+        failure = std::exchange(failure_, nullptr);
+    }
+    if (failure != nullptr) {
+        std::rethrow_exception(failure);
+    }
+}
+} // veng
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "graphics.h"
+
+namespace veng {
+struct DrawCommand {
+    glm::mat4 model{1.0f};
+    TextureHandle texture;
+    BufferHandle vertex_buffer;
+    BufferHandle index_buffer;
+    std::uint32_t index_count = 0;
+};
+
+// Everything the render thread needs to draw one frame, copied out of the simulation so it can move on to the next.
+struct FramePacket {
+    glm::mat4 view{1.0f};
+    glm::mat4 projection{1.0f};
+    std::vector<DrawCommand> draws;
+
+    // Keeps the capacity, so steady frames do not allocate.
+    void Clear();
+};
+
+// Owns a Graphics instance's frames and calls on a dedicated thread, so a blocking acquire or present never delays
+// event handling, and the main thread simulates frame N + 1 while frame N is recorded and submitted. Two packets
+// alternate between the threads. GLFW stays on the main thread; while this exists Graphics may only be used through
+// it.
+class RenderThread final {
+public:
+    explicit RenderThread(gsl::not_null<Graphics *> graphics);
+    // Runs the work still queued, then joins.
+    ~RenderThread();
+
+    RenderThread(const RenderThread &) = delete;
+    RenderThread &operator=(const RenderThread &) = delete;
+
+    // The packet to fill for the next frame, cleared. Blocks while the render thread is still drawing from it, which
+    // keeps the simulation at most one frame ahead.
+    FramePacket &BeginPacket();
+    // Hands the packet from BeginPacket over to be drawn.
+    void SubmitPacket();
+
+    // Runs `call` on the render thread after everything submitted before it, e.g. to create or destroy resources.
+    template <typename Call>
+    auto Invoke(Call call) -> std::future<std::invoke_result_t<Call, Graphics &>> {
+        auto task = std::make_shared<std::packaged_task<std::invoke_result_t<Call, Graphics &>(Graphics &)>>(
+            std::move(call));
+        auto result = task->get_future();
+        Enqueue([task](Graphics &graphics) { (*task)(graphics); });
+        return result;
+    }
+
+private:
+    using Work = std::function<void(Graphics &)>;
+
+    void Enqueue(Work work);
+    void Loop();
+    void Draw(const FramePacket &packet) const;
+    // Rethrows, on the main thread, what drawing a packet threw.
+    void ThrowIfFailed();
+
+    gsl::not_null<Graphics *> graphics_;
+    std::array<FramePacket, 2> packets_;
+    // Queued or being drawn, so the main thread must not touch it.
+    std::array<bool, 2> packet_in_use_{};
+    std::uint32_t write_packet_ = 0;
+
+    std::mutex mutex_;
+    std::condition_variable work_available_;
+    std::condition_variable packet_released_;
+    std::deque<Work> work_;
+    std::exception_ptr failure_;
+    bool stopping_ = false;
+    std::thread thread_;
+};
+} // veng
@@ -0,0 +1,148 @@
+#include "scene_hierarchy.h"
+
+#include <algorithm>
+#include <numeric>
+#include <precomp.h>
+#include <spdlog/spdlog.h>
+
+namespace veng {
+namespace {
+constexpr std::uint32_t kNoPosition = std::numeric_limits<std::uint32_t>::max();
+
+template <typename T>
+void Reorder(std::vector<T> &values, const std::vector<std::uint32_t> &order) {
+    std::vector<T> reordered;
+    reordered.reserve(values.size());
+    for (const std::uint32_t position: order) {
+        reordered.push_back(std::move(values[position]));
+    }
+    values = std::move(reordered);
+}
+}
+
+SceneNode SceneHierarchy::Create(const SceneNode parent, const glm::mat4 &local_transform, const Aabb &local_bounds) {
+    if (parent != kNoSceneNode && parent >= positions_.size()) {
+        spdlog::error("Cannot create a scene node under missing parent {}!", parent);
+        return kNoSceneNode;
+    }
+
+    const auto node = static_cast<SceneNode>(positions_.size());
+    const auto position = static_cast<std::uint32_t>(nodes_.size());
+    const std::uint32_t parent_position = parent != kNoSceneNode ? positions_[parent] : kNoPosition;
+    const std::uint32_t depth = parent != kNoSceneNode ? depths_[parent_position] + 1 : 0;
+    if (!depths_.empty() && depth < depths_.back()) {
+        order_dirty_ = true;
+    }
+
+    nodes_.push_back(node);
+    parents_.push_back(parent_position);
+    depths_.push_back(depth);
+    local_transforms_.push_back(local_transform);
+    world_transforms_.push_back(local_transform);
+    local_bounds_.push_back(local_bounds);
+    world_bounds_.push_back(local_bounds);
+    dirty_.push_back(0);
+    positions_.push_back(position);
+    MarkDirty(position);
+    return node;
+}
+
+void SceneHierarchy::SetLocalTransform(const SceneNode node, const glm::mat4 &local_transform) {
+    local_transforms_[positions_[node]] = local_transform;
+    MarkDirty(positions_[node]);
+}
+
+void SceneHierarchy::SetLocalBounds(const SceneNode node, const Aabb &local_bounds) {
+    local_bounds_[positions_[node]] = local_bounds;
+    MarkDirty(positions_[node]);
+}
+
+const glm::mat4 &SceneHierarchy::GetLocalTransform(const SceneNode node) const {
+    return local_transforms_[positions_[node]];
+}
+
+SceneNode SceneHierarchy::GetParent(const SceneNode node) const {
+    const std::uint32_t parent_position = parents_[positions_[node]];
+    return parent_position != kNoPosition ? nodes_[parent_position] : kNoSceneNode;
+}
+
+const glm::mat4 &SceneHierarchy::GetWorldTransform(const SceneNode node) const {
+    return world_transforms_[positions_[node]];
+}
+
+const Aabb &SceneHierarchy::GetWorldBounds(const SceneNode node) const {
+    return world_bounds_[positions_[node]];
+}
+
+void SceneHierarchy::Update(std::vector<SceneNode> &updated) {
+    updated.clear();
+    if (order_dirty_) {
+        SortByDepth();
+    }
+    if (first_dirty_ == kNoPosition) {
+        return;
+    }
+
+    // Parents are handled first, so by the time a child is reached its parent's flag says whether it moved.
+    for (std::uint32_t position = first_dirty_; position < nodes_.size(); ++position) {
+        const std::uint32_t parent = parents_[position];
+        if (dirty_[position] == 0 && (parent == kNoPosition || dirty_[parent] == 0)) {
+            continue;
+        }
+
+        dirty_[position] = 1;
+        world_transforms_[position] = parent != kNoPosition
+                                          ? world_transforms_[parent] * local_transforms_[position]
+                                          : local_transforms_[position];
+        world_bounds_[position] = local_bounds_[position].Transformed(world_transforms_[position]);
+        updated.push_back(nodes_[position]);
+    }
+
+    for (const SceneNode node: updated) {
+        dirty_[positions_[node]] = 0;
+    }
+    first_dirty_ = kNoPosition;
+}
+
+std::size_t SceneHierarchy::Size() const {
+    return nodes_.size();
+}
+
+void SceneHierarchy::MarkDirty(const std::uint32_t position) {
+    dirty_[position] = 1;
+    first_dirty_ = std::min(first_dirty_, position);
+}
+
+void SceneHierarchy::SortByDepth() {
+    std::vector<std::uint32_t> order(nodes_.size());
+    std::iota(order.begin(), order.end(), 0u);
+    // Stable, so siblings keep their creation order.
+    std::ranges::stable_sort(order, {}, [this](const std::uint32_t position) { return depths_[position]; });
+
+    Reorder(nodes_, order);
+    Reorder(parents_, order);
+    Reorder(depths_, order);
+    Reorder(local_transforms_, order);
+    Reorder(world_transforms_, order);
+    Reorder(local_bounds_, order);
+    Reorder(world_bounds_, order);
+    Reorder(dirty_, order);
+
+    // Parents still refer to old positions.
+    std::vector<std::uint32_t> new_positions(order.size());
+    for (std::uint32_t position = 0; position < order.size(); ++position) {
+        new_positions[order[position]] = position;
+        positions_[nodes_[position]] = position;
+    }
+    first_dirty_ = kNoPosition;
+    for (std::uint32_t position = 0; position < nodes_.size(); ++position) {
+        if (parents_[position] != kNoPosition) {
+            parents_[position] = new_positions[parents_[position]];
+        }
+        if (dirty_[position] != 0) {
+            first_dirty_ = std::min(first_dirty_, position);
+        }
+    }
+    order_dirty_ = false;
+}
+} // veng
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <limits>
+#include <vector>
+
+#include "bvh.h"
+
+namespace veng {
+using SceneNode = std::uint32_t;
+constexpr SceneNode kNoSceneNode = std::numeric_limits<SceneNode>::max();
+
+// Parent/child transform hierarchy. Nodes live in flat arrays sorted by depth, so parents always precede their
+// children and propagating transforms is one linear pass. Changing a node only marks it dirty; Update then recomputes
+// the world data of dirty nodes and their descendants and leaves everything else alone.
+class SceneHierarchy final {
+public:
+    // The parent has to exist already. Local bounds are the node's own geometry, in its local space.
+    SceneNode Create(SceneNode parent = kNoSceneNode, const glm::mat4 &local_transform = glm::mat4(1.0f),
+                     const Aabb &local_bounds = {});
+
+    void SetLocalTransform(SceneNode node, const glm::mat4 &local_transform);
+    void SetLocalBounds(SceneNode node, const Aabb &local_bounds);
+    [[nodiscard]] const glm::mat4 &GetLocalTransform(SceneNode node) const;
+    [[nodiscard]] SceneNode GetParent(SceneNode node) const;
+
+    // As of the last Update.
+    [[nodiscard]] const glm::mat4 &GetWorldTransform(SceneNode node) const;
+    [[nodiscard]] const Aabb &GetWorldBounds(SceneNode node) const;
+
+    // Replaces `updated` with the nodes whose world transform and bounds were recomputed, parents before children,
+    // so per-object renderer data only has to be refreshed for them.
+    void Update(std::vector<SceneNode> &updated);
+
+    [[nodiscard]] std::size_t Size() const;
+
+private:
+    void MarkDirty(std::uint32_t position);
+    void SortByDepth();
+
+    // Indexed by position in depth order.
+    std::vector<SceneNode> nodes_;
+    std::vector<std::uint32_t> parents_;
+    std::vector<std::uint32_t> depths_;
+    std::vector<glm::mat4> local_transforms_;
+    std::vector<glm::mat4> world_transforms_;
+    std::vector<Aabb> local_bounds_;
+    std::vector<Aabb> world_bounds_;
+    std::vector<std::uint8_t> dirty_;
+
+    // Indexed by node.
+    std::vector<std::uint32_t> positions_;
+
+    // Nothing before it is dirty, so Update starts there.
+    std::uint32_t first_dirty_ = std::numeric_limits<std::uint32_t>::max();
+    // Set when a node was created shallower than the deepest one, which breaks the depth order.
+    bool order_dirty_ = false;
+};
+} // veng
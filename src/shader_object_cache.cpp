@@ -0,0 +1,41 @@
+#include "shader_object_cache.h"
+
+#include <precomp.h>
+
+namespace veng {
+PipelineDescription GetShaderObjectKey(const PipelineDescription &description) {
+    PipelineDescription key;
+    key.vertex_shader = description.vertex_shader;
+    key.fragment_shader = description.fragment_shader;
+    key.shader_features = description.shader_features;
+    return key;
+}
+
+const ShaderObjects &ShaderObjectCache::GetOrCreate(const PipelineDescription &description,
+                                                     const CreateFunction &create) {
+    static const ShaderObjects kInvalid;
+
+    PipelineDescription key = GetShaderObjectKey(description);
+    if (const auto it = shaders_.find(key); it != shaders_.end()) {
+        return it->second;
+    }
+
+    ShaderObjects shaders = create(key);
+    if (!shaders.IsValid()) {
+        return kInvalid;
+    }
+    return shaders_.emplace(std::move(key), std::move(shaders)).first->second;
+}
+
+void ShaderObjectCache::Destroy(VkDevice device) {
+    for (const auto &[key, shaders]: shaders_) {
+        vkDestroyShaderEXT(device, shaders.vertex, VK_NULL_HANDLE);
+        vkDestroyShaderEXT(device, shaders.fragment, VK_NULL_HANDLE);
+    }
+    shaders_.clear();
+}
+
+std::size_t ShaderObjectCache::GetShaderPairCount() const {
+    return shaders_.size();
+}
+} // veng
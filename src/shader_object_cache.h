@@ -0,0 +1,38 @@
+#pragma once
+
+#include <functional>
+#include <unordered_map>
+#include <vulkan/vulkan.h>
+
+#include "pipeline_cache.h"
+
+namespace veng {
+// Linked vertex and fragment shader objects of one shader pair and variant.
+struct ShaderObjects {
+    VkShaderEXT vertex = VK_NULL_HANDLE;
+    VkShaderEXT fragment = VK_NULL_HANDLE;
+    // Vertex input has to be set explicitly with shader objects; this is what the vertex shader declares.
+    VertexLayout vertex_layout;
+
+    [[nodiscard]] bool IsValid() const { return vertex != VK_NULL_HANDLE && fragment != VK_NULL_HANDLE; }
+};
+
+// Under VK_EXT_shader_object everything but the shaders is dynamic state, so a description reduces to its shader
+// names and features.
+PipelineDescription GetShaderObjectKey(const PipelineDescription &description);
+
+// Shader object counterpart of PipelineCache, for the main thread only. Failed creations are not cached.
+class ShaderObjectCache final {
+public:
+    using CreateFunction = std::function<ShaderObjects(const PipelineDescription &)>;
+
+    // Returns invalid shader objects if creation failed.
+    const ShaderObjects &GetOrCreate(const PipelineDescription &description, const CreateFunction &create);
+    void Destroy(VkDevice device);
+
+    [[nodiscard]] std::size_t GetShaderPairCount() const;
+
+private:
+    std::unordered_map<PipelineDescription, ShaderObjects, PipelineDescriptionHash> shaders_;
+};
+} // veng
@@ -0,0 +1,39 @@
+#include "shader_registry.h"
+
+#include <algorithm>
+#include <cstring>
+#include <precomp.h>
+#include <spdlog/spdlog.h>
+
+#include "embedded_shaders.h"
+#include "utilities.h"
+
+namespace veng {
+ShaderRegistry::ShaderRegistry(std::filesystem::path override_directory)
+    : override_directory_(std::move(override_directory)) {
+}
+
+ShaderCode ShaderRegistry::Find(const std::string_view name) const {
+    ShaderCode code;
+
+    if (!override_directory_.empty()) {
+        const std::vector<std::uint8_t> bytes = ReadFile(override_directory_ / (std::string(name) + ".spv"));
+        if (!bytes.empty() && bytes.size() % sizeof(std::uint32_t) == 0) {
+            code.storage.resize(bytes.size() / sizeof(std::uint32_t));
+            std::memcpy(code.storage.data(), bytes.data(), bytes.size());
+            code.words = code.storage;
+            return code;
+        }
+    }
+
+    const std::span<const EmbeddedShader> shaders = GetEmbeddedShaders();
+    const auto shader = std::ranges::find(shaders, name, &EmbeddedShader::name);
+    if (shader != shaders.end()) {
+        code.words = shader->code;
+    } else {
+        spdlog::error("Unknown shader {}", name);
+    }
+
+    return code;
+}
+} // veng
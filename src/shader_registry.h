@@ -0,0 +1,36 @@
+#pragma once
+
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace veng {
+struct ShaderCode {
+    ShaderCode() = default;
+    ShaderCode(ShaderCode &&) = default;
+    ShaderCode &operator=(ShaderCode &&) = default;
+    // A copy would leave `words` pointing at the original's storage.
+    ShaderCode(const ShaderCode &) = delete;
+    ShaderCode &operator=(const ShaderCode &) = delete;
+
+    std::span<const std::uint32_t> words;
+    // Only set when the code came from disk; `words` points into it.
+    std::vector<std::uint32_t> storage;
+
+    [[nodiscard]] bool IsEmpty() const { return words.empty(); }
+};
+
+// Resolves shader names to SPIR-V. Built-in shaders come straight from the executable; a "<name>.spv" in the override
+// directory, when one is set, takes precedence so shaders can be iterated on without a rebuild. Safe to use from
+// several threads.
+class ShaderRegistry final {
+public:
+    explicit ShaderRegistry(std::filesystem::path override_directory = {});
+
+    [[nodiscard]] ShaderCode Find(std::string_view name) const;
+
+private:
+    std::filesystem::path override_directory_;
+};
+} // veng
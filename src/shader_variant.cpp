@@ -0,0 +1,23 @@
+#include "shader_variant.h"
+
+#include <precomp.h>
+
+namespace veng {
+ShaderSpecialization::ShaderSpecialization(const ShaderFeatures features) {
+    for (std::uint32_t id = 0; id < kShaderFeatureCount; ++id) {
+        entries_[id].constantID = id;
+        entries_[id].offset = id * sizeof(VkBool32);
+        entries_[id].size = sizeof(VkBool32);
+        values_[id] = features.Has(static_cast<ShaderFeature>(id)) ? VK_TRUE : VK_FALSE;
+    }
+
+    info_.mapEntryCount = entries_.size();
+    info_.pMapEntries = entries_.data();
+    info_.dataSize = sizeof(values_);
+    info_.pData = values_.data();
+}
+
+const VkSpecializationInfo *ShaderSpecialization::GetInfo() const {
+    return &info_;
+}
+} // veng
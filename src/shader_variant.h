@@ -0,0 +1,61 @@
+#pragma once
+
+#include <array>
+#include <initializer_list>
+#include <vulkan/vulkan.h>
+
+namespace veng {
+// Optional shader paths, compiled into a single module per stage as boolean specialization constants. The value is
+// the constant_id the shaders declare the switch with.
+enum class ShaderFeature : std::uint32_t {
+    Textured = 0,
+    AlphaTest = 1,
+    Fog = 2
+};
+
+constexpr std::uint32_t kShaderFeatureCount = 3;
+
+struct ShaderFeatures {
+    std::uint32_t bits = 0;
+
+    constexpr ShaderFeatures() = default;
+
+    constexpr ShaderFeatures(const std::initializer_list<ShaderFeature> features) {
+        for (const ShaderFeature feature: features) {
+            bits |= 1u << static_cast<std::uint32_t>(feature);
+        }
+    }
+
+    [[nodiscard]] constexpr bool Has(const ShaderFeature feature) const {
+        return (bits & 1u << static_cast<std::uint32_t>(feature)) != 0;
+    }
+
+    [[nodiscard]] constexpr ShaderFeatures With(const ShaderFeature feature, const bool enabled = true) const {
+        ShaderFeatures result = *this;
+        const std::uint32_t bit = 1u << static_cast<std::uint32_t>(feature);
+        result.bits = enabled ? bits | bit : bits & ~bit;
+        return result;
+    }
+
+    bool operator==(const ShaderFeatures &other) const = default;
+};
+
+// Specialization data selecting a variant; every feature is specialized, so disabled paths are removed by the driver
+// when the pipeline is created instead of being branched over per invocation. Constants a stage does not declare are
+// ignored, so the same info can be given to every stage.
+class ShaderSpecialization final {
+public:
+    explicit ShaderSpecialization(ShaderFeatures features);
+
+    // `info_` points into the object itself.
+    ShaderSpecialization(const ShaderSpecialization &) = delete;
+    ShaderSpecialization &operator=(const ShaderSpecialization &) = delete;
+
+    [[nodiscard]] const VkSpecializationInfo *GetInfo() const;
+
+private:
+    std::array<VkSpecializationMapEntry, kShaderFeatureCount> entries_{};
+    std::array<VkBool32, kShaderFeatureCount> values_{};
+    VkSpecializationInfo info_{};
+};
+} // veng
@@ -1,6 +1,15 @@
 #version 450
 #include "common.glsl"
 
+layout (constant_id = 0) const bool TEXTURED = true;
+layout (constant_id = 1) const bool ALPHA_TEST = false;
+layout (constant_id = 2) const bool FOG = false;
+
+const vec4 untextured_color = vec4(0.8, 0.8, 0.8, 1.0);
+const float alpha_cutoff = 0.5;
+const vec3 fog_color = vec3(0.6, 0.65, 0.7);
+const float fog_density = 0.05;
+
 layout (location = 0) in vec2 vertex_uv;
 
 layout (location = 0) out vec4 out_color;
@@ -8,5 +17,18 @@ layout (location = 0) out vec4 out_color;
 layout(set = 1, binding = 0) uniform sampler2D texture_sampler;
 
 void main() {
-    out_color = texture(texture_sampler, vertex_uv);
+    vec4 color = TEXTURED ? texture(texture_sampler, vertex_uv) : untextured_color;
+
+    if (ALPHA_TEST && color.a < alpha_cutoff) {
+        discard;
+    }
+
+    if (FOG) {
+        // 1 / w is the view-space depth under a perspective projection.
+        float view_depth = 1.0 / gl_FragCoord.w;
+        float visibility = exp(-fog_density * view_depth);
+        color.rgb = mix(fog_color, color.rgb, clamp(visibility, 0.0, 1.0));
+    }
+
+    out_color = color;
 }
\ No newline at end of file
@@ -0,0 +1,19 @@
+#version 450
+#include "common.glsl"
+
+layout (location = 0) in vec3 input_position;
+layout (location = 1) in vec2 input_uv;
+// Per instance, occupying locations 2 to 5.
+layout (location = 2) in mat4 instance_transformation;
+
+layout (location = 0) out vec2 vertex_uv;
+
+// Applied on top of every instance; keeps the push constant range, and so the layout, the same as basic.vert's.
+layout (push_constant) uniform Model {
+    mat4 transformation;
+} model;
+
+void main() {
+    gl_Position = camera.proj * camera.view * model.transformation * instance_transformation * vec4(input_position, 1.0);
+    vertex_uv = input_uv;
+}
@@ -0,0 +1,30 @@
+#version 450
+#include "common.glsl"
+
+// Relative to the mesh bounds; the model matrix includes the mesh's dequantization transform.
+layout (location = 0) in vec3 input_position;
+layout (location = 1) in vec2 input_uv;
+// Octahedral-encoded.
+layout (location = 2) in vec2 input_normal;
+
+layout (location = 0) out vec2 vertex_uv;
+layout (location = 1) out vec3 vertex_normal;
+
+// Same block as basic.vert's, so packed meshes share its pipeline layout.
+layout (push_constant) uniform Model {
+    mat4 transformation;
+} model;
+
+vec3 DecodeOctahedral(vec2 encoded) {
+    vec3 normal = vec3(encoded, 1.0 - abs(encoded.x) - abs(encoded.y));
+    float fold = max(-normal.z, 0.0);
+    normal.xy += mix(vec2(fold), vec2(-fold), greaterThanEqual(normal.xy, vec2(0.0)));
+    return normalize(normal);
+}
+
+void main() {
+    gl_Position = camera.proj * camera.view * model.transformation * vec4(input_position, 1.0);
+    vertex_uv = input_uv;
+    // The dequantization scale is uniform, so the model matrix keeps normals perpendicular.
+    vertex_normal = normalize(mat3(model.transformation) * DecodeOctahedral(input_normal));
+}
@@ -0,0 +1,11 @@
+#version 450
+
+layout (location = 0) in vec2 scene_uv;
+
+layout (location = 0) out vec4 out_color;
+
+layout (set = 0, binding = 0) uniform sampler2D scene_color;
+
+void main() {
+    out_color = texture(scene_color, scene_uv);
+}
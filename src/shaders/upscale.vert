@@ -0,0 +1,14 @@
+#version 450
+
+layout (push_constant) uniform UpscaleConstants {
+    vec2 uv_scale;
+} constants;
+
+layout (location = 0) out vec2 scene_uv;
+
+void main() {
+    // One triangle covering the whole viewport; the parts outside it are clipped.
+    vec2 corner = vec2((gl_VertexIndex << 1) & 2, gl_VertexIndex & 2);
+    scene_uv = corner * constants.uv_scale;
+    gl_Position = vec4(corner * 2.0 - 1.0, 0.0, 1.0);
+}
@@ -0,0 +1,41 @@
+#include "simd.h"
+
+#include <algorithm>
+#include <array>
+#include <precomp.h>
+
+#if defined(VENG_SIMD_X86) && defined(_MSC_VER) && !defined(__clang__)
+#include <immintrin.h>
+#include <intrin.h>
+#endif
+
+namespace veng {
+namespace {
+#if defined(VENG_SIMD_X86)
+bool IsAvx2Supported() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    std::array<int, 4> info = {};
+    __cpuid(info.data(), 1);
+    const bool os_saves_ymm = (info[2] & (1 << 27)) != 0 && (_xgetbv(0) & 0x6) == 0x6;
+    __cpuidex(info.data(), 7, 0);
+    return os_saves_ymm && (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+#endif
+}
+
+SimdPath GetBestSimdPath() {
+#if defined(VENG_SIMD_X86)
+    static const SimdPath best = IsAvx2Supported() ? SimdPath::Avx2 : SimdPath::Sse;
+    return best;
+#else
+    return SimdPath::Scalar;
+#endif
+}
+
+SimdPath GetSupportedSimdPath(const SimdPath requested) {
+    return std::min(requested, GetBestSimdPath());
+}
+} // veng
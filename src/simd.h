@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define VENG_SIMD_X86
+#if defined(_MSC_VER) && !defined(__clang__)
+// MSVC compiles every intrinsic regardless of the target; the paths are only taken after the CPU check.
+#define VENG_TARGET_AVX2
+#else
+#define VENG_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace veng {
+enum class SimdPath : std::uint8_t {
+    // Reference implementation every other path has to agree with.
+    Scalar,
+    Sse,
+    Avx2
+};
+
+// The widest path the running CPU supports.
+SimdPath GetBestSimdPath();
+// The requested path, narrowed to what the CPU and the build support.
+SimdPath GetSupportedSimdPath(SimdPath requested);
+} // veng
@@ -0,0 +1,437 @@
+#include "spirv_reflection.h"
+
+#include <algorithm>
+#include <array>
+#include <precomp.h>
+#include <tuple>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace veng {
+namespace {
+constexpr std::uint32_t kSpirvMagic = 0x07230203;
+constexpr std::size_t kHeaderWordCount = 5;
+
+// The handful of SPIR-V enumerants the reflection needs, from the SPIR-V specification.
+enum Opcode : std::uint32_t {
+    OpEntryPoint = 15,
+    OpTypeInt = 21,
+    OpTypeFloat = 22,
+    OpTypeVector = 23,
+    OpTypeMatrix = 24,
+    OpTypeImage = 25,
+    OpTypeSampler = 26,
+    OpTypeSampledImage = 27,
+    OpTypeArray = 28,
+    OpTypeRuntimeArray = 29,
+    OpTypeStruct = 30,
+    OpTypePointer = 32,
+    OpConstant = 43,
+    OpFunction = 54,
+    OpVariable = 59,
+    OpDecorate = 71,
+    OpMemberDecorate = 72
+};
+
+enum Decoration : std::uint32_t {
+    BufferBlock = 3,
+    ArrayStride = 6,
+    MatrixStride = 7,
+    BuiltIn = 11,
+    Location = 30,
+    Binding = 33,
+    DescriptorSet = 34,
+    Offset = 35
+};
+
+enum StorageClass : std::uint32_t {
+    UniformConstant = 0,
+    Input = 1,
+    Uniform = 2,
+    PushConstant = 9,
+    StorageBuffer = 12
+};
+
+constexpr std::uint32_t kDimBuffer = 5;
+constexpr std::uint32_t kDimSubpassData = 6;
+constexpr std::uint32_t kImageSampledStorage = 2;
+
+struct Variable {
+    std::uint32_t id = 0;
+    std::uint32_t type = 0;
+    std::uint32_t storage = 0;
+};
+
+class Module {
+public:
+    bool Parse(const std::span<const std::uint32_t> words) {
+        if (words.size() < kHeaderWordCount || words[0] != kSpirvMagic) {
+            return false;
+        }
+
+        bool in_functions = false;
+        for (std::size_t offset = kHeaderWordCount; offset < words.size();) {
+            const std::uint32_t word_count = words[offset] >> 16;
+            if (word_count == 0 || offset + word_count > words.size()) {
+                return false;
+            }
+
+            const std::span<const std::uint32_t> instruction = words.subspan(offset, word_count);
+            offset += word_count;
+
+            const std::uint32_t opcode = instruction[0] & 0xFFFF;
+            if (opcode == OpFunction) {
+                in_functions = true;
+            }
+
+            // Anything a function body mentions counts as used. Literals may collide with ids, which at worst adds
+            // a stage to a binding.
+            if (in_functions) {
+                referenced_.insert(instruction.begin() + 1, instruction.end());
+                continue;
+            }
+
+            switch (opcode) {
+                case OpEntryPoint:
+                    if (word_count > 1 && !execution_model_.has_value()) {
+                        execution_model_ = instruction[1];
+                    }
+                    break;
+                case OpDecorate:
+                    if (word_count > 2) {
+                        decorations_[instruction[1]][instruction[2]] = word_count > 3 ? instruction[3] : 0;
+                    }
+                    break;
+                case OpMemberDecorate:
+                    if (word_count > 3) {
+                        member_decorations_[instruction[1]][instruction[2]][instruction[3]] =
+                                word_count > 4 ? instruction[4] : 0;
+                    }
+                    break;
+                case OpConstant:
+                    if (word_count > 3) {
+                        definitions_[instruction[2]] = instruction;
+                    }
+                    break;
+                case OpVariable:
+                    if (word_count > 3) {
+                        variables_.push_back({instruction[2], instruction[1], instruction[3]});
+                    }
+                    break;
+                default:
+                    if (opcode >= OpTypeInt && opcode <= OpTypePointer && word_count > 1) {
+                        definitions_[instruction[1]] = instruction;
+                    }
+                    break;
+            }
+        }
+
+        return execution_model_.has_value();
+    }
+
+    [[nodiscard]] VkShaderStageFlags GetStage() const {
+        switch (execution_model_.value_or(~0u)) {
+            case 0: return VK_SHADER_STAGE_VERTEX_BIT;
+            case 1: return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+            case 2: return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+            case 3: return VK_SHADER_STAGE_GEOMETRY_BIT;
+            case 4: return VK_SHADER_STAGE_FRAGMENT_BIT;
+            case 5: return VK_SHADER_STAGE_COMPUTE_BIT;
+            default: return 0;
+        }
+    }
+
+    [[nodiscard]] const std::vector<Variable> &GetVariables() const { return variables_; }
+    [[nodiscard]] bool IsReferenced(const std::uint32_t id) const { return referenced_.contains(id); }
+
+    [[nodiscard]] std::optional<std::uint32_t> GetDecoration(const std::uint32_t id,
+                                                             const std::uint32_t decoration) const {
+        const auto it = decorations_.find(id);
+        if (it == decorations_.end()) {
+            return std::nullopt;
+        }
+        const auto value = it->second.find(decoration);
+        return value != it->second.end() ? std::optional(value->second) : std::nullopt;
+    }
+
+    [[nodiscard]] std::optional<std::uint32_t> GetMemberDecoration(const std::uint32_t id, const std::uint32_t member,
+                                                                   const std::uint32_t decoration) const {
+        const auto it = member_decorations_.find(id);
+        if (it == member_decorations_.end()) {
+            return std::nullopt;
+        }
+        const auto member_it = it->second.find(member);
+        if (member_it == it->second.end()) {
+            return std::nullopt;
+        }
+        const auto value = member_it->second.find(decoration);
+        return value != member_it->second.end() ? std::optional(value->second) : std::nullopt;
+    }
+
+    [[nodiscard]] std::span<const std::uint32_t> GetDefinition(const std::uint32_t id) const {
+        const auto it = definitions_.find(id);
+        return it != definitions_.end() ? it->second : std::span<const std::uint32_t>{};
+    }
+
+    [[nodiscard]] std::uint32_t GetOpcode(const std::uint32_t id) const {
+        const std::span<const std::uint32_t> definition = GetDefinition(id);
+        return definition.empty() ? 0 : definition[0] & 0xFFFF;
+    }
+
+    [[nodiscard]] std::uint32_t GetConstant(const std::uint32_t id) const {
+        const std::span<const std::uint32_t> definition = GetDefinition(id);
+        return definition.size() > 3 && (definition[0] & 0xFFFF) == OpConstant ? definition[3] : 0;
+    }
+
+    [[nodiscard]] std::uint32_t GetPointee(const std::uint32_t pointer_type) const {
+        const std::span<const std::uint32_t> definition = GetDefinition(pointer_type);
+        return definition.size() > 3 && (definition[0] & 0xFFFF) == OpTypePointer ? definition[3] : 0;
+    }
+
+    // Size in bytes following the explicit layout decorations of buffer blocks.
+    [[nodiscard]] std::uint32_t GetSize(const std::uint32_t type) const {
+        const std::span<const std::uint32_t> definition = GetDefinition(type);
+        if (definition.empty()) {
+            return 0;
+        }
+
+        switch (definition[0] & 0xFFFF) {
+            case OpTypeInt:
+            case OpTypeFloat:
+                return definition[2] / 8;
+            case OpTypeVector:
+            case OpTypeMatrix:
+                return definition[3] * GetSize(definition[2]);
+            case OpTypeArray:
+                return GetConstant(definition[3]) * GetDecoration(type, ArrayStride).value_or(GetSize(definition[2]));
+            case OpTypeStruct: {
+                std::uint32_t size = 0;
+                for (std::uint32_t member = 0; member + 2 < definition.size(); ++member) {
+                    const std::uint32_t member_type = definition[member + 2];
+                    const std::uint32_t offset = GetMemberDecoration(type, member, Offset).value_or(0);
+                    std::uint32_t member_size = GetSize(member_type);
+                    if (const auto stride = GetMemberDecoration(type, member, MatrixStride);
+                        stride.has_value() && GetOpcode(member_type) == OpTypeMatrix) {
+                        member_size = GetDefinition(member_type)[3] * stride.value();
+                    }
+                    size = std::max(size, offset + member_size);
+                }
+                return size;
+            }
+            default:
+                return 0;
+        }
+    }
+
+private:
+    std::optional<std::uint32_t> execution_model_;
+    std::unordered_map<std::uint32_t, std::span<const std::uint32_t>> definitions_;
+    std::unordered_map<std::uint32_t, std::unordered_map<std::uint32_t, std::uint32_t>> decorations_;
+    std::unordered_map<std::uint32_t, std::unordered_map<std::uint32_t, std::unordered_map<std::uint32_t,
+        std::uint32_t>>> member_decorations_;
+    std::vector<Variable> variables_;
+    std::unordered_set<std::uint32_t> referenced_;
+};
+
+std::optional<VkDescriptorType> GetDescriptorType(const Module &module, const std::uint32_t type,
+                                                  const std::uint32_t storage) {
+    const std::span<const std::uint32_t> definition = module.GetDefinition(type);
+    if (definition.empty()) {
+        return std::nullopt;
+    }
+
+    const std::uint32_t opcode = definition[0] & 0xFFFF;
+    if (storage == StorageBuffer) {
+        return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    }
+    if (storage == Uniform) {
+        return module.GetDecoration(type, BufferBlock).has_value()
+                   ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER
+                   : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    }
+    if (storage != UniformConstant) {
+        return std::nullopt;
+    }
+
+    switch (opcode) {
+        case OpTypeSampler:
+            return VK_DESCRIPTOR_TYPE_SAMPLER;
+        case OpTypeSampledImage: {
+            const std::span<const std::uint32_t> image = module.GetDefinition(definition[2]);
+            if (image.size() > 3 && image[3] == kDimBuffer) {
+                return VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+            }
+            return VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+        }
+        case OpTypeImage: {
+            if (definition.size() < 8) {
+                return std::nullopt;
+            }
+            const bool storage_image = definition[7] == kImageSampledStorage;
+            if (definition[3] == kDimSubpassData) {
+                return VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+            }
+            if (definition[3] == kDimBuffer) {
+                return storage_image
+                           ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER
+                           : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+            }
+            return storage_image ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+        }
+        default:
+            return std::nullopt;
+    }
+}
+
+std::uint32_t GetComponentCount(const Module &module, const std::uint32_t type) {
+    return module.GetOpcode(type) == OpTypeVector ? module.GetDefinition(type)[3] : 1;
+}
+
+VkFormat GetVertexFormat(const Module &module, const std::uint32_t type) {
+    const std::uint32_t component_type = module.GetOpcode(type) == OpTypeVector ? module.GetDefinition(type)[2] : type;
+    const std::uint32_t component_count = GetComponentCount(module, type);
+
+    const std::span<const std::uint32_t> component = module.GetDefinition(component_type);
+    if (component.size() < 3 || component[2] != 32 || component_count < 1 || component_count > 4) {
+        return VK_FORMAT_UNDEFINED;
+    }
+
+    constexpr std::array float_formats = {
+        VK_FORMAT_R32_SFLOAT, VK_FORMAT_R32G32_SFLOAT, VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R32G32B32A32_SFLOAT
+    };
+    constexpr std::array sint_formats = {
+        VK_FORMAT_R32_SINT, VK_FORMAT_R32G32_SINT, VK_FORMAT_R32G32B32_SINT, VK_FORMAT_R32G32B32A32_SINT
+    };
+    constexpr std::array uint_formats = {
+        VK_FORMAT_R32_UINT, VK_FORMAT_R32G32_UINT, VK_FORMAT_R32G32B32_UINT, VK_FORMAT_R32G32B32A32_UINT
+    };
+
+    if ((component[0] & 0xFFFF) == OpTypeFloat) {
+        return float_formats[component_count - 1];
+    }
+    if ((component[0] & 0xFFFF) == OpTypeInt && component.size() > 3) {
+        return component[3] != 0 ? sint_formats[component_count - 1] : uint_formats[component_count - 1];
+    }
+    return VK_FORMAT_UNDEFINED;
+}
+}
+
+std::optional<ShaderReflection> ReflectShader(const std::span<const std::uint32_t> words) {
+    Module module;
+    if (!module.Parse(words)) {
+        return std::nullopt;
+    }
+
+    ShaderReflection reflection;
+    reflection.stages = module.GetStage();
+
+    for (const Variable &variable: module.GetVariables()) {
+        std::uint32_t type = module.GetPointee(variable.type);
+
+        if (variable.storage == Input) {
+            const std::optional<std::uint32_t> location = module.GetDecoration(variable.id, Location);
+            if (reflection.stages == VK_SHADER_STAGE_VERTEX_BIT && location.has_value() &&
+                !module.GetDecoration(variable.id, BuiltIn).has_value()) {
+                // Matrices take one location per column, each fed like a vector attribute of its own.
+                std::uint32_t column_count = 1;
+                if (module.GetOpcode(type) == OpTypeMatrix) {
+                    column_count = module.GetDefinition(type)[3];
+                    type = module.GetDefinition(type)[2];
+                }
+
+                const VkFormat format = GetVertexFormat(module, type);
+                const std::uint32_t size = format != VK_FORMAT_UNDEFINED ? GetComponentCount(module, type) * 4 : 0;
+                for (std::uint32_t column = 0; column < column_count; ++column) {
+                    reflection.vertex_inputs.push_back({location.value() + column, format, size});
+                }
+            }
+            continue;
+        }
+
+        if (!module.IsReferenced(variable.id)) {
+            continue;
+        }
+
+        if (variable.storage == PushConstant) {
+            std::uint32_t begin = ~0u;
+            const std::span<const std::uint32_t> block = module.GetDefinition(type);
+            for (std::uint32_t member = 0; member + 2 < block.size(); ++member) {
+                begin = std::min(begin, module.GetMemberDecoration(type, member, Offset).value_or(0));
+            }
+            const std::uint32_t end = module.GetSize(type);
+            if (begin < end) {
+                reflection.push_constants = VkPushConstantRange{reflection.stages, begin, end - begin};
+            }
+            continue;
+        }
+
+        std::uint32_t count = 1;
+        while (module.GetOpcode(type) == OpTypeArray || module.GetOpcode(type) == OpTypeRuntimeArray) {
+            const std::span<const std::uint32_t> array = module.GetDefinition(type);
+            // Unsized arrays need descriptor indexing to be declared as such; a single descriptor is the safe default.
+            if ((array[0] & 0xFFFF) == OpTypeArray) {
+                count *= module.GetConstant(array[3]);
+            }
+            type = array[2];
+        }
+
+        const std::optional<VkDescriptorType> descriptor_type = GetDescriptorType(module, type, variable.storage);
+        if (!descriptor_type.has_value()) {
+            continue;
+        }
+
+        reflection.bindings.push_back({
+            module.GetDecoration(variable.id, DescriptorSet).value_or(0),
+            module.GetDecoration(variable.id, Binding).value_or(0),
+            descriptor_type.value(), count, reflection.stages
+        });
+    }
+
+    std::ranges::sort(reflection.bindings, [](const ReflectedBinding &a, const ReflectedBinding &b) {
+        return std::tie(a.set, a.binding) < std::tie(b.set, b.binding);
+    });
+    std::ranges::sort(reflection.vertex_inputs, {}, &ReflectedVertexInput::location);
+
+    return reflection;
+}
+
+void ShaderReflection::Merge(const ShaderReflection &other) {
+    stages |= other.stages;
+
+    for (const ReflectedBinding &binding: other.bindings) {
+        const auto existing = std::ranges::find_if(bindings, [&binding](const ReflectedBinding &candidate) {
+            return candidate.set == binding.set && candidate.binding == binding.binding;
+        });
+        if (existing != bindings.end()) {
+            existing->stages |= binding.stages;
+            existing->count = std::max(existing->count, binding.count);
+        } else {
+            bindings.push_back(binding);
+        }
+    }
+    std::ranges::sort(bindings, [](const ReflectedBinding &a, const ReflectedBinding &b) {
+        return std::tie(a.set, a.binding) < std::tie(b.set, b.binding);
+    });
+
+    // One range covering every stage keeps vkCmdPushConstants valid whichever stage reads which bytes.
+    if (other.push_constants.has_value()) {
+        if (push_constants.has_value()) {
+            const std::uint32_t begin = std::min(push_constants->offset, other.push_constants->offset);
+            const std::uint32_t end = std::max(push_constants->offset + push_constants->size,
+                                               other.push_constants->offset + other.push_constants->size);
+            push_constants = VkPushConstantRange{
+                push_constants->stageFlags | other.push_constants->stageFlags, begin, end - begin
+            };
+        } else {
+            push_constants = other.push_constants;
+        }
+    }
+
+    vertex_inputs.insert(vertex_inputs.end(), other.vertex_inputs.begin(), other.vertex_inputs.end());
+    std::ranges::sort(vertex_inputs, {}, &ReflectedVertexInput::location);
+}
+
+std::uint32_t ShaderReflection::GetSetCount() const {
+    return bindings.empty() ? 0 : bindings.back().set + 1;
+}
+} // veng
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <optional>
+#include <span>
+#include <vector>
+#include <vulkan/vulkan.h>
+
+namespace veng {
+struct ReflectedBinding {
+    std::uint32_t set = 0;
+    std::uint32_t binding = 0;
+    VkDescriptorType type = VK_DESCRIPTOR_TYPE_MAX_ENUM;
+    std::uint32_t count = 1;
+    VkShaderStageFlags stages = 0;
+
+    bool operator==(const ReflectedBinding &other) const = default;
+};
+
+struct ReflectedVertexInput {
+    std::uint32_t location = 0;
+    // 32-bit components matching the shader's declaration; the pipeline may still feed a packed format instead.
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    std::uint32_t size = 0;
+};
+
+// Interface of one or more shader stages as far as layouts are concerned. Only resources the entry point actually
+// touches are reported, so layouts built from it stay minimal.
+struct ShaderReflection {
+    VkShaderStageFlags stages = 0;
+    // Sorted by set, then binding.
+    std::vector<ReflectedBinding> bindings;
+    std::optional<VkPushConstantRange> push_constants;
+    // Vertex stage only, sorted by location.
+    std::vector<ReflectedVertexInput> vertex_inputs;
+
+    // Combines the interface of another stage of the same pipeline.
+    void Merge(const ShaderReflection &other);
+    [[nodiscard]] std::uint32_t GetSetCount() const;
+};
+
+// Parses the SPIR-V words directly; returns nothing for malformed modules.
+std::optional<ShaderReflection> ReflectShader(std::span<const std::uint32_t> words);
+} // veng
@@ -3,6 +3,7 @@
 //
 #pragma once
 
+#include <optional>
 #include <vulkan/vulkan.h>
 
 namespace veng {
@@ -10,6 +11,12 @@ struct TextureHandle {
     VkImage image = VK_NULL_HANDLE;
     VkImageView image_view = VK_NULL_HANDLE;
     VkDeviceMemory memory = VK_NULL_HANDLE;
+    // Layout the image stays in between uses, which descriptors reading it are written with.
+    VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+    // Created for use from the compute queue as well, with concurrent sharing when that queue is separate.
+    bool compute_shared = false;
     VkDescriptorSet descriptor_set = VK_NULL_HANDLE;
+    // Used instead of descriptor_set when descriptors live in a descriptor buffer.
+    std::optional<VkDeviceSize> descriptor_offset;
 };
 }
@@ -0,0 +1,68 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <precomp.h>
+
+namespace veng {
+ThreadPool::ThreadPool(std::uint32_t thread_count) {
+    if (thread_count == 0) {
+        thread_count = std::clamp(std::thread::hardware_concurrency(), 2u, 5u) - 1;
+    }
+
+    workers_.reserve(thread_count);
+    for (std::uint32_t i = 0; i < thread_count; ++i) {
+        workers_.emplace_back(&ThreadPool::WorkerLoop, this);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    Shutdown();
+}
+
+void ThreadPool::Submit(Task task) {
+    {
+        std::lock_guard lock(mutex_);
+        if (stopping_) {
+            return;
+        }
+        tasks_.push_back(std::move(task));
+    }
+    task_available_.notify_one();
+}
+
+void ThreadPool::Shutdown() {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+        tasks_.clear();
+    }
+    task_available_.notify_all();
+
+    for (std::thread &worker: workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers_.clear();
+}
+
+std::size_t ThreadPool::GetThreadCount() const {
+    return workers_.size();
+}
+
+void ThreadPool::WorkerLoop() {
+    while (true) {
+        Task task;
+        {
+            std::unique_lock lock(mutex_);
+            task_available_.wait(lock, [this] { return stopping_ || !tasks_.empty(); });
+            if (stopping_) {
+                return;
+            }
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+        }
+        task();
+    }
+}
+} // veng
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace veng {
+// Fixed set of worker threads draining a FIFO of tasks. Used for work that must never block the frame, such as
+// pipeline compilation.
+class ThreadPool final {
+public:
+    using Task = std::function<void()>;
+
+    // Zero picks a count from the hardware concurrency, leaving a core for the main thread.
+    explicit ThreadPool(std::uint32_t thread_count = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    void Submit(Task task);
+    // Drops tasks that have not started yet, waits for running ones and joins the workers. Submit is a no-op after.
+    void Shutdown();
+
+    [[nodiscard]] std::size_t GetThreadCount() const;
+
+private:
+    void WorkerLoop();
+
+    std::vector<std::thread> workers_;
+    std::deque<Task> tasks_;
+    std::mutex mutex_;
+    std::condition_variable task_available_;
+    bool stopping_ = false;
+};
+} // veng
@@ -0,0 +1,300 @@
+#include "transform_store.h"
+
+#include <precomp.h>
+
+#if defined(VENG_SIMD_X86)
+#include <immintrin.h>
+#endif
+
+namespace veng {
+namespace {
+struct TransformSources {
+    const float *position_x = nullptr;
+    const float *position_y = nullptr;
+    const float *position_z = nullptr;
+    const float *rotation_x = nullptr;
+    const float *rotation_y = nullptr;
+    const float *rotation_z = nullptr;
+    const float *rotation_w = nullptr;
+    const float *scale_x = nullptr;
+    const float *scale_y = nullptr;
+    const float *scale_z = nullptr;
+};
+
+// Every path evaluates the quaternion to matrix conversion in this same order, so they produce identical matrices.
+void WriteWorldMatricesScalar(const TransformSources &sources, const std::size_t begin,
+                              const std::span<glm::mat4> output) {
+    for (std::size_t index = begin; index < output.size(); ++index) {
+        const float x = sources.rotation_x[index];
+        const float y = sources.rotation_y[index];
+        const float z = sources.rotation_z[index];
+        const float w = sources.rotation_w[index];
+        const float x2 = x + x;
+        const float y2 = y + y;
+        const float z2 = z + z;
+        const float xx = x * x2;
+        const float yy = y * y2;
+        const float zz = z * z2;
+        const float xy = x * y2;
+        const float xz = x * z2;
+        const float yz = y * z2;
+        const float wx = w * x2;
+        const float wy = w * y2;
+        const float wz = w * z2;
+        const float sx = sources.scale_x[index];
+        const float sy = sources.scale_y[index];
+        const float sz = sources.scale_z[index];
+
+        glm::mat4 &matrix = output[index];
+        matrix[0] = glm::vec4((1.0f - (yy + zz)) * sx, (xy + wz) * sx, (xz - wy) * sx, 0.0f);
+        matrix[1] = glm::vec4((xy - wz) * sy, (1.0f - (xx + zz)) * sy, (yz + wx) * sy, 0.0f);
+        matrix[2] = glm::vec4((xz + wy) * sz, (yz - wx) * sz, (1.0f - (xx + yy)) * sz, 0.0f);
+        matrix[3] = glm::vec4(sources.position_x[index], sources.position_y[index], sources.position_z[index], 1.0f);
+    }
+}
+
+#if defined(VENG_SIMD_X86)
+// Non-temporal stores skip reading the destination into the cache first, which mapped GPU memory the CPU never reads
+// back does not need. They require 16-byte alignment, which mapped memory always has.
+bool CanStream(const std::span<glm::mat4> output) {
+    return reinterpret_cast<std::uintptr_t>(output.data()) % 16 == 0;
+}
+
+void StoreColumn(float *destination, const __m128 column, const bool stream) {
+    if (stream) {
+        _mm_stream_ps(destination, column);
+    } else {
+        _mm_storeu_ps(destination, column);
+    }
+}
+
+// The batches compute each matrix element for several objects at once, then transpose them into columns per object.
+// Returns the index the scalar tail has to continue from.
+std::size_t WriteWorldMatricesSse(const TransformSources &sources, const std::span<glm::mat4> output) {
+    constexpr std::size_t kWidth = 4;
+    const std::size_t batch_end = output.size() / kWidth * kWidth;
+    const bool stream = CanStream(output);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    for (std::size_t base = 0; base < batch_end; base += kWidth) {
+        const __m128 x = _mm_loadu_ps(sources.rotation_x + base);
+        const __m128 y = _mm_loadu_ps(sources.rotation_y + base);
+        const __m128 z = _mm_loadu_ps(sources.rotation_z + base);
+        const __m128 w = _mm_loadu_ps(sources.rotation_w + base);
+        const __m128 x2 = _mm_add_ps(x, x);
+        const __m128 y2 = _mm_add_ps(y, y);
+        const __m128 z2 = _mm_add_ps(z, z);
+        const __m128 xx = _mm_mul_ps(x, x2);
+        const __m128 yy = _mm_mul_ps(y, y2);
+        const __m128 zz = _mm_mul_ps(z, z2);
+        const __m128 xy = _mm_mul_ps(x, y2);
+        const __m128 xz = _mm_mul_ps(x, z2);
+        const __m128 yz = _mm_mul_ps(y, z2);
+        const __m128 wx = _mm_mul_ps(w, x2);
+        const __m128 wy = _mm_mul_ps(w, y2);
+        const __m128 wz = _mm_mul_ps(w, z2);
+        const __m128 sx = _mm_loadu_ps(sources.scale_x + base);
+        const __m128 sy = _mm_loadu_ps(sources.scale_y + base);
+        const __m128 sz = _mm_loadu_ps(sources.scale_z + base);
+
+        __m128 columns[4][4] = {
+            {_mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(yy, zz)), sx), _mm_mul_ps(_mm_add_ps(xy, wz), sx),
+             _mm_mul_ps(_mm_sub_ps(xz, wy), sx), zero},
+            {_mm_mul_ps(_mm_sub_ps(xy, wz), sy), _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, zz)), sy),
+             _mm_mul_ps(_mm_add_ps(yz, wx), sy), zero},
+            {_mm_mul_ps(_mm_add_ps(xz, wy), sz), _mm_mul_ps(_mm_sub_ps(yz, wx), sz),
+             _mm_mul_ps(_mm_sub_ps(one, _mm_add_ps(xx, yy)), sz), zero},
+            {_mm_loadu_ps(sources.position_x + base), _mm_loadu_ps(sources.position_y + base),
+             _mm_loadu_ps(sources.position_z + base), one}
+        };
+        for (__m128 (&column)[4]: columns) {
+            _MM_TRANSPOSE4_PS(column[0], column[1], column[2], column[3]);
+        }
+
+        // Written in address order, which is what write-combined GPU memory wants.
+        for (std::size_t object = 0; object < kWidth; ++object) {
+            float *destination = &output[base + object][0][0];
+            for (std::size_t column = 0; column < 4; ++column) {
+                StoreColumn(destination + column * 4, columns[column][object], stream);
+            }
+        }
+    }
+    if (stream) {
+        _mm_sfence();
+    }
+    return batch_end;
+}
+
+// Like _MM_TRANSPOSE4_PS, within each 128-bit half.
+VENG_TARGET_AVX2 void TransposeHalves(__m256 (&rows)[4]) {
+    const __m256 low_01 = _mm256_unpacklo_ps(rows[0], rows[1]);
+    const __m256 high_01 = _mm256_unpackhi_ps(rows[0], rows[1]);
+    const __m256 low_23 = _mm256_unpacklo_ps(rows[2], rows[3]);
+    const __m256 high_23 = _mm256_unpackhi_ps(rows[2], rows[3]);
+    rows[0] = _mm256_shuffle_ps(low_01, low_23, _MM_SHUFFLE(1, 0, 1, 0));
+    rows[1] = _mm256_shuffle_ps(low_01, low_23, _MM_SHUFFLE(3, 2, 3, 2));
+    rows[2] = _mm256_shuffle_ps(high_01, high_23, _MM_SHUFFLE(1, 0, 1, 0));
+    rows[3] = _mm256_shuffle_ps(high_01, high_23, _MM_SHUFFLE(3, 2, 3, 2));
+}
+
+VENG_TARGET_AVX2 std::size_t WriteWorldMatricesAvx2(const TransformSources &sources,
+                                                    const std::span<glm::mat4> output) {
+    constexpr std::size_t kWidth = 8;
+    const std::size_t batch_end = output.size() / kWidth * kWidth;
+    const bool stream = CanStream(output);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 one = _mm256_set1_ps(1.0f);
+    for (std::size_t base = 0; base < batch_end; base += kWidth) {
+        const __m256 x = _mm256_loadu_ps(sources.rotation_x + base);
+        const __m256 y = _mm256_loadu_ps(sources.rotation_y + base);
+        const __m256 z = _mm256_loadu_ps(sources.rotation_z + base);
+        const __m256 w = _mm256_loadu_ps(sources.rotation_w + base);
+        const __m256 x2 = _mm256_add_ps(x, x);
+        const __m256 y2 = _mm256_add_ps(y, y);
+        const __m256 z2 = _mm256_add_ps(z, z);
+        const __m256 xx = _mm256_mul_ps(x, x2);
+        const __m256 yy = _mm256_mul_ps(y, y2);
+        const __m256 zz = _mm256_mul_ps(z, z2);
+        const __m256 xy = _mm256_mul_ps(x, y2);
+        const __m256 xz = _mm256_mul_ps(x, z2);
+        const __m256 yz = _mm256_mul_ps(y, z2);
+        const __m256 wx = _mm256_mul_ps(w, x2);
+        const __m256 wy = _mm256_mul_ps(w, y2);
+        const __m256 wz = _mm256_mul_ps(w, z2);
+        const __m256 sx = _mm256_loadu_ps(sources.scale_x + base);
+        const __m256 sy = _mm256_loadu_ps(sources.scale_y + base);
+        const __m256 sz = _mm256_loadu_ps(sources.scale_z + base);
+
+        __m256 columns[4][4] = {
+            {_mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(yy, zz)), sx), _mm256_mul_ps(_mm256_add_ps(xy, wz), sx),
+             _mm256_mul_ps(_mm256_sub_ps(xz, wy), sx), zero},
+            {_mm256_mul_ps(_mm256_sub_ps(xy, wz), sy), _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, zz)), sy),
+             _mm256_mul_ps(_mm256_add_ps(yz, wx), sy), zero},
+            {_mm256_mul_ps(_mm256_add_ps(xz, wy), sz), _mm256_mul_ps(_mm256_sub_ps(yz, wx), sz),
+             _mm256_mul_ps(_mm256_sub_ps(one, _mm256_add_ps(xx, yy)), sz), zero},
+            {_mm256_loadu_ps(sources.position_x + base), _mm256_loadu_ps(sources.position_y + base),
+             _mm256_loadu_ps(sources.position_z + base), one}
+        };
+        // Afterwards entry i holds a column of object i in its low half and of object i + 4 in its high half.
+        for (__m256 (&column)[4]: columns) {
+            TransposeHalves(column);
+        }
+
+        for (std::size_t object = 0; object < kWidth; ++object) {
+            float *destination = &output[base + object][0][0];
+            for (std::size_t column = 0; column < 4; ++column) {
+                const __m256 pair = columns[column][object % 4];
+                StoreColumn(destination + column * 4,
+                            object < 4 ? _mm256_castps256_ps128(pair) : _mm256_extractf128_ps(pair, 1), stream);
+            }
+        }
+    }
+    if (stream) {
+        _mm_sfence();
+    }
+    return batch_end;
+}
+#endif
+}
+
+std::uint32_t TransformStore::Add(const glm::vec3 &position, const glm::quat &rotation, const glm::vec3 &scale) {
+    position_x_.push_back(position.x);
+    position_y_.push_back(position.y);
+    position_z_.push_back(position.z);
+    rotation_x_.push_back(rotation.x);
+    rotation_y_.push_back(rotation.y);
+    rotation_z_.push_back(rotation.z);
+    rotation_w_.push_back(rotation.w);
+    scale_x_.push_back(scale.x);
+    scale_y_.push_back(scale.y);
+    scale_z_.push_back(scale.z);
+    return static_cast<std::uint32_t>(position_x_.size() - 1);
+}
+
+void TransformStore::SetPosition(const std::uint32_t object, const glm::vec3 &position) {
+    position_x_[object] = position.x;
+    position_y_[object] = position.y;
+    position_z_[object] = position.z;
+}
+
+void TransformStore::SetRotation(const std::uint32_t object, const glm::quat &rotation) {
+    rotation_x_[object] = rotation.x;
+    rotation_y_[object] = rotation.y;
+    rotation_z_[object] = rotation.z;
+    rotation_w_[object] = rotation.w;
+}
+
+void TransformStore::SetScale(const std::uint32_t object, const glm::vec3 &scale) {
+    scale_x_[object] = scale.x;
+    scale_y_[object] = scale.y;
+    scale_z_[object] = scale.z;
+}
+
+glm::vec3 TransformStore::GetPosition(const std::uint32_t object) const {
+    return {position_x_[object], position_y_[object], position_z_[object]};
+}
+
+glm::quat TransformStore::GetRotation(const std::uint32_t object) const {
+    return {rotation_w_[object], rotation_x_[object], rotation_y_[object], rotation_z_[object]};
+}
+
+glm::vec3 TransformStore::GetScale(const std::uint32_t object) const {
+    return {scale_x_[object], scale_y_[object], scale_z_[object]};
+}
+
+void TransformStore::Reserve(const std::size_t count) {
+    position_x_.reserve(count);
+    position_y_.reserve(count);
+    position_z_.reserve(count);
+    rotation_x_.reserve(count);
+    rotation_y_.reserve(count);
+    rotation_z_.reserve(count);
+    rotation_w_.reserve(count);
+    scale_x_.reserve(count);
+    scale_y_.reserve(count);
+    scale_z_.reserve(count);
+}
+
+void TransformStore::Clear() {
+    position_x_.clear();
+    position_y_.clear();
+    position_z_.clear();
+    rotation_x_.clear();
+    rotation_y_.clear();
+    rotation_z_.clear();
+    rotation_w_.clear();
+    scale_x_.clear();
+    scale_y_.clear();
+    scale_z_.clear();
+}
+
+std::size_t TransformStore::Size() const {
+    return position_x_.size();
+}
+
+void TransformStore::WriteWorldMatrices(const std::size_t first, const std::span<glm::mat4> output,
+                                        const SimdPath path) const {
+    const TransformSources sources = {
+        position_x_.data() + first, position_y_.data() + first, position_z_.data() + first,
+        rotation_x_.data() + first, rotation_y_.data() + first, rotation_z_.data() + first,
+        rotation_w_.data() + first, scale_x_.data() + first, scale_y_.data() + first, scale_z_.data() + first
+    };
+
+    std::size_t tail_begin = 0;
+#if defined(VENG_SIMD_X86)
+    switch (GetSupportedSimdPath(path)) {
+        case SimdPath::Avx2:
+            tail_begin = WriteWorldMatricesAvx2(sources, output);
+            break;
+        case SimdPath::Sse:
+            tail_begin = WriteWorldMatricesSse(sources, output);
+            break;
+        case SimdPath::Scalar:
+            break;
+    }
+#else
+    static_cast<void>(path);
+#endif
+    WriteWorldMatricesScalar(sources, tail_begin, output);
+}
+} // veng
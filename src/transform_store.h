@@ -0,0 +1,46 @@
+#pragma once
+
+#include <span>
+#include <vector>
+
+#include "glm/gtc/quaternion.hpp"
+#include "simd.h"
+
+namespace veng {
+// Positions, rotations and scales of many objects as structure-of-arrays, turned into world matrices in SIMD
+// batches. Objects are identified by the index Add returned.
+class TransformStore final {
+public:
+    std::uint32_t Add(const glm::vec3 &position, const glm::quat &rotation = glm::quat(1.0f, 0.0f, 0.0f, 0.0f),
+                      const glm::vec3 &scale = glm::vec3(1.0f));
+    void SetPosition(std::uint32_t object, const glm::vec3 &position);
+    // Expected to be normalized.
+    void SetRotation(std::uint32_t object, const glm::quat &rotation);
+    void SetScale(std::uint32_t object, const glm::vec3 &scale);
+
+    [[nodiscard]] glm::vec3 GetPosition(std::uint32_t object) const;
+    [[nodiscard]] glm::quat GetRotation(std::uint32_t object) const;
+    [[nodiscard]] glm::vec3 GetScale(std::uint32_t object) const;
+
+    void Reserve(std::size_t count);
+    void Clear();
+    [[nodiscard]] std::size_t Size() const;
+
+    // Writes translation * rotation * scale for objects [first, first + output.size()), so disjoint ranges can be
+    // computed in parallel and written straight into mapped GPU memory.
+    void WriteWorldMatrices(std::size_t first, std::span<glm::mat4> output,
+                            SimdPath path = GetBestSimdPath()) const;
+
+private:
+    std::vector<float> position_x_;
+    std::vector<float> position_y_;
+    std::vector<float> position_z_;
+    std::vector<float> rotation_x_;
+    std::vector<float> rotation_y_;
+    std::vector<float> rotation_z_;
+    std::vector<float> rotation_w_;
+    std::vector<float> scale_x_;
+    std::vector<float> scale_y_;
+    std::vector<float> scale_z_;
+};
+} // veng
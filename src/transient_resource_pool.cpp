@@ -0,0 +1,259 @@
+#include "transient_resource_pool.h"
+
+#include <algorithm>
+#include <numeric>
+#include <precomp.h>
+#include <spdlog/spdlog.h>
+
+namespace veng {
+namespace {
+VkDeviceSize AlignUp(const VkDeviceSize value, const VkDeviceSize alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+bool LifetimesOverlap(const TransientResourceRequest &a, const TransientResourceRequest &b) {
+    return a.first_use <= b.last_use && b.first_use <= a.last_use;
+}
+
+std::float_t ToMiB(const VkDeviceSize bytes) {
+    return static_cast<std::float_t>(bytes) / (1024.0f * 1024.0f);
+}
+}
+
+void TransientResourcePool::Initialize(VkDevice device, VkPhysicalDevice physical_device) {
+    device_ = device;
+    physical_device_ = physical_device;
+
+    VkPhysicalDeviceProperties properties;
+    vkGetPhysicalDeviceProperties(physical_device_, &properties);
+    // Buffers and optimally tiled images may end up next to each other in the same heap.
+    granularity_ = std::max<VkDeviceSize>(properties.limits.bufferImageGranularity, 1);
+}
+
+void TransientResourcePool::Destroy() {
+    Release();
+    current_requests_.clear();
+}
+
+const TransientPoolStatistics &TransientResourcePool::GetStatistics() const {
+    return statistics_;
+}
+
+const std::vector<TransientResource> &TransientResourcePool::Realize(
+    const std::vector<TransientResourceRequest> &requests) {
+    if (requests == current_requests_ && resources_.size() == requests.size()) {
+        return resources_;
+    }
+
+    Release();
+    current_requests_ = requests;
+    if (requests.empty()) {
+        return resources_;
+    }
+
+    std::vector<Placement> placements;
+    CreateResources(requests, placements);
+    PlaceResources(requests, placements);
+    BindResources(requests);
+
+    statistics_.resource_count = resources_.size();
+    statistics_.heap_count = heaps_.size();
+    statistics_.requested_bytes = std::accumulate(placements.begin(), placements.end(), VkDeviceSize{0},
+                                                  [](const VkDeviceSize total, const Placement &placement) {
+                                                      return total + placement.requirements.size;
+                                                  });
+    statistics_.allocated_bytes = std::accumulate(heap_sizes_.begin(), heap_sizes_.end(), VkDeviceSize{0});
+
+    spdlog::info("Transient pool: {} resources in {} heap(s), {:.1f} MiB instead of {:.1f} MiB ({:.1f} MiB saved)",
+                 statistics_.resource_count, statistics_.heap_count, ToMiB(statistics_.allocated_bytes),
+                 ToMiB(statistics_.requested_bytes), ToMiB(statistics_.GetSavedBytes()));
+
+    return resources_;
+}
+
+void TransientResourcePool::CreateResources(const std::vector<TransientResourceRequest> &requests,
+                                            std::vector<Placement> &placements) {
+    resources_.resize(requests.size());
+    placements.resize(requests.size());
+
+    for (std::uint32_t i = 0; i < requests.size(); ++i) {
+        const TransientResourceRequest &request = requests[i];
+        TransientResource &resource = resources_[i];
+        Placement &placement = placements[i];
+        placement.request = i;
+
+        if (request.is_image) {
+            VkImageCreateInfo image_info = {};
+            image_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+            image_info.imageType = VK_IMAGE_TYPE_2D;
+            image_info.format = request.image.format;
+            image_info.extent = {request.image.width, request.image.height, 1};
+            image_info.mipLevels = std::max(request.image.mip_levels, 1u);
+            image_info.arrayLayers = std::max(request.image.array_layers, 1u);
+            image_info.samples = request.image.samples;
+            image_info.tiling = VK_IMAGE_TILING_OPTIMAL;
+            image_info.usage = request.image.usage;
+            image_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+            image_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+
+            if (vkCreateImage(device_, &image_info, nullptr, &resource.image) != VK_SUCCESS) {
+                throw std::runtime_error("failed to create transient image!");
+            }
+            vkGetImageMemoryRequirements(device_, resource.image, &placement.requirements);
+        } else {
+            VkBufferCreateInfo buffer_info = {};
+            buffer_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+            buffer_info.size = request.buffer.size;
+            buffer_info.usage = request.buffer.usage;
+            buffer_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+            if (vkCreateBuffer(device_, &buffer_info, nullptr, &resource.buffer) != VK_SUCCESS) {
+                throw std::runtime_error("failed to create transient buffer!");
+            }
+            vkGetBufferMemoryRequirements(device_, resource.buffer, &placement.requirements);
+        }
+
+        placement.memory_type = FindDeviceLocalMemoryType(placement.requirements.memoryTypeBits);
+        resource.size = placement.requirements.size;
+    }
+}
+
+void TransientResourcePool::PlaceResources(const std::vector<TransientResourceRequest> &requests,
+                                           std::vector<Placement> &placements) {
+    // Largest first keeps the big targets at the bottom of the heap and lets small ones fill the gaps above them.
+    std::ranges::sort(placements, [](const Placement &a, const Placement &b) {
+        if (a.requirements.size != b.requirements.size) {
+            return a.requirements.size > b.requirements.size;
+        }
+        return a.request < b.request;
+    });
+
+    struct Interval {
+        VkDeviceSize begin;
+        VkDeviceSize end;
+    };
+
+    std::vector<std::uint32_t> placed;
+    for (const Placement &placement: placements) {
+        const TransientResourceRequest &request = requests[placement.request];
+        TransientResource &resource = resources_[placement.request];
+
+        const auto heap_it = std::ranges::find(heap_memory_types_, placement.memory_type);
+        resource.heap = static_cast<std::uint32_t>(heap_it - heap_memory_types_.begin());
+        if (heap_it == heap_memory_types_.end()) {
+            heap_memory_types_.push_back(placement.memory_type);
+            heap_sizes_.push_back(0);
+        }
+
+        // Only resources alive at the same time as this one block a range of the heap.
+        std::vector<Interval> occupied;
+        for (const std::uint32_t other: placed) {
+            if (resources_[other].heap == resource.heap && LifetimesOverlap(request, requests[other])) {
+                occupied.push_back({resources_[other].offset, resources_[other].offset + resources_[other].size});
+            }
+        }
+        std::ranges::sort(occupied, {}, &Interval::begin);
+
+        const VkDeviceSize alignment = std::max(placement.requirements.alignment, granularity_);
+        VkDeviceSize offset = 0;
+        for (const Interval &interval: occupied) {
+            if (offset + resource.size <= interval.begin) {
+                break;
+            }
+            offset = std::max(offset, AlignUp(interval.end, alignment));
+        }
+
+        resource.offset = offset;
+        heap_sizes_[resource.heap] = std::max(heap_sizes_[resource.heap], offset + resource.size);
+        placed.push_back(placement.request);
+    }
+
+    for (std::uint32_t i = 0; i < resources_.size(); ++i) {
+        for (std::uint32_t other = 0; other < resources_.size(); ++other) {
+            const TransientResource &a = resources_[i];
+            const TransientResource &b = resources_[other];
+            if (other != i && a.heap == b.heap && requests[other].last_use < requests[i].first_use &&
+                a.offset < b.offset + b.size && b.offset < a.offset + a.size) {
+                resources_[i].aliased_predecessors.push_back(other);
+            }
+        }
+    }
+}
+
+void TransientResourcePool::BindResources(const std::vector<TransientResourceRequest> &requests) {
+    heaps_.resize(heap_sizes_.size(), VK_NULL_HANDLE);
+    for (std::size_t heap = 0; heap < heaps_.size(); ++heap) {
+        VkMemoryAllocateInfo allocation_info = {};
+        allocation_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocation_info.allocationSize = heap_sizes_[heap];
+        allocation_info.memoryTypeIndex = heap_memory_types_[heap];
+
+        if (vkAllocateMemory(device_, &allocation_info, nullptr, &heaps_[heap]) != VK_SUCCESS) {
+            throw std::runtime_error("failed to allocate transient memory!");
+        }
+    }
+
+    for (std::uint32_t i = 0; i < resources_.size(); ++i) {
+        TransientResource &resource = resources_[i];
+        if (resource.buffer != VK_NULL_HANDLE) {
+            vkBindBufferMemory(device_, resource.buffer, heaps_[resource.heap], resource.offset);
+            continue;
+        }
+
+        vkBindImageMemory(device_, resource.image, heaps_[resource.heap], resource.offset);
+
+        const TransientImageDescription &description = requests[i].image;
+        VkImageViewCreateInfo view_info = {};
+        view_info.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        view_info.image = resource.image;
+        view_info.viewType = description.array_layers > 1 ? VK_IMAGE_VIEW_TYPE_2D_ARRAY : VK_IMAGE_VIEW_TYPE_2D;
+        view_info.format = description.format;
+        view_info.subresourceRange.aspectMask = description.aspect;
+        view_info.subresourceRange.baseMipLevel = 0;
+        view_info.subresourceRange.levelCount = std::max(description.mip_levels, 1u);
+        view_info.subresourceRange.baseArrayLayer = 0;
+        view_info.subresourceRange.layerCount = std::max(description.array_layers, 1u);
+
+        if (vkCreateImageView(device_, &view_info, nullptr, &resource.image_view) != VK_SUCCESS) {
+            throw std::runtime_error("failed to create transient image view!");
+        }
+    }
+}
+
+void TransientResourcePool::Release() {
+    for (const TransientResource &resource: resources_) {
+        if (resource.image_view != VK_NULL_HANDLE) {
+            vkDestroyImageView(device_, resource.image_view, nullptr);
+        }
+        if (resource.image != VK_NULL_HANDLE) {
+            vkDestroyImage(device_, resource.image, nullptr);
+        }
+        if (resource.buffer != VK_NULL_HANDLE) {
+            vkDestroyBuffer(device_, resource.buffer, nullptr);
+        }
+    }
+    for (VkDeviceMemory heap: heaps_) {
+        vkFreeMemory(device_, heap, nullptr);
+    }
+
+    resources_.clear();
+    heaps_.clear();
+    heap_memory_types_.clear();
+    heap_sizes_.clear();
+    statistics_ = {};
+}
+
+std::uint32_t TransientResourcePool::FindDeviceLocalMemoryType(const std::uint32_t memory_type_bits) const {
+    VkPhysicalDeviceMemoryProperties memory_properties;
+    vkGetPhysicalDeviceMemoryProperties(physical_device_, &memory_properties);
+
+    for (std::uint32_t i = 0; i < memory_properties.memoryTypeCount; ++i) {
+        if ((memory_type_bits & (1u << i)) &&
+            (memory_properties.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT)) {
+            return i;
+        }
+    }
+
+    throw std::runtime_error("failed to find transient memory type!");
+}
+} // veng
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <vector>
+#include <vulkan/vulkan.h>
+
+namespace veng {
+struct TransientImageDescription {
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    std::uint32_t width = 0;
+    std::uint32_t height = 0;
+    VkImageUsageFlags usage = 0;
+    VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+    std::uint32_t mip_levels = 1;
+    std::uint32_t array_layers = 1;
+    VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
+
+    bool operator==(const TransientImageDescription &) const = default;
+};
+
+struct TransientBufferDescription {
+    VkDeviceSize size = 0;
+    VkBufferUsageFlags usage = 0;
+
+    bool operator==(const TransientBufferDescription &) const = default;
+};
+
+// Lifetimes are positions in the frame's pass execution order, inclusive on both ends.
+struct TransientResourceRequest {
+    bool is_image = true;
+    TransientImageDescription image{};
+    TransientBufferDescription buffer{};
+    std::uint32_t first_use = 0;
+    std::uint32_t last_use = 0;
+
+    bool operator==(const TransientResourceRequest &) const = default;
+};
+
+struct TransientResource {
+    VkImage image = VK_NULL_HANDLE;
+    VkImageView image_view = VK_NULL_HANDLE;
+    VkBuffer buffer = VK_NULL_HANDLE;
+    std::uint32_t heap = 0;
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = 0;
+    // Earlier resources whose memory this one reuses; their last accesses must finish before its first one.
+    std::vector<std::uint32_t> aliased_predecessors;
+};
+
+struct TransientPoolStatistics {
+    std::size_t resource_count = 0;
+    std::size_t heap_count = 0;
+    VkDeviceSize requested_bytes = 0;
+    VkDeviceSize allocated_bytes = 0;
+
+    [[nodiscard]] VkDeviceSize GetSavedBytes() const { return requested_bytes - allocated_bytes; }
+};
+
+// Places per-frame resources whose lifetimes never overlap in the same device memory. One pool per frame in flight,
+// so the placement can only be rebuilt once the frame that used it has retired.
+class TransientResourcePool final {
+public:
+    void Initialize(VkDevice device, VkPhysicalDevice physical_device);
+    void Destroy();
+
+    // Handles come back in request order; an unchanged request list reuses the previous placement.
+    const std::vector<TransientResource> &Realize(const std::vector<TransientResourceRequest> &requests);
+
+    [[nodiscard]] const TransientPoolStatistics &GetStatistics() const;
+
+private:
+    struct Placement {
+        std::uint32_t request = 0;
+        VkMemoryRequirements requirements{};
+        std::uint32_t memory_type = 0;
+    };
+
+    void Release();
+    void CreateResources(const std::vector<TransientResourceRequest> &requests, std::vector<Placement> &placements);
+    void PlaceResources(const std::vector<TransientResourceRequest> &requests, std::vector<Placement> &placements);
+    void BindResources(const std::vector<TransientResourceRequest> &requests);
+    [[nodiscard]] std::uint32_t FindDeviceLocalMemoryType(std::uint32_t memory_type_bits) const;
+
+    VkDevice device_ = VK_NULL_HANDLE;
+    VkPhysicalDevice physical_device_ = VK_NULL_HANDLE;
+    VkDeviceSize granularity_ = 1;
+
+    std::vector<TransientResourceRequest> current_requests_;
+    std::vector<TransientResource> resources_;
+    std::vector<VkDeviceMemory> heaps_;
+    std::vector<std::uint32_t> heap_memory_types_;
+    std::vector<VkDeviceSize> heap_sizes_;
+    TransientPoolStatistics statistics_;
+};
+} // veng
@@ -10,5 +10,10 @@ namespace veng {
 bool streq(gsl::czstring a, gsl::czstring b);
 std::vector<std::uint8_t> ReadFile(std::filesystem::path file);
 
+template <typename T>
+void HashCombine(std::size_t &seed, const T &value) {
+    seed ^= std::hash<T>{}(value) + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+}
+
 } // veng
 
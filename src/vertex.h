@@ -7,6 +7,7 @@
 #include <vulkan/vulkan.h>
 
 #include "glm/vec3.hpp"
+#include "vertex_layout.h"
 
 namespace veng {
 struct Vertex {
@@ -15,21 +16,14 @@ struct Vertex {
 
     glm::vec3 position;
     glm::vec2 uv;
+};
 
-    static VkVertexInputBindingDescription GetBindingDescription() {
-        return VkVertexInputBindingDescription{0, sizeof(Vertex), VK_VERTEX_INPUT_RATE_VERTEX};
-    }
-
-    static std::array<VkVertexInputAttributeDescription, 2> GetAttributeDescriptions() {
-        constexpr VkVertexInputAttributeDescription position_attribute_description = {
-            0, 0, VK_FORMAT_R32G32B32_SFLOAT, offsetof(Vertex, position)
-        };
-
-        constexpr VkVertexInputAttributeDescription color_attribute_description = {
-            1, 0, VK_FORMAT_R32G32_SFLOAT, offsetof(Vertex, uv)
-        };
-
-        return {position_attribute_description, color_attribute_description};
-    }
+template <>
+struct VertexTraits<Vertex> {
+    using Type = Vertex;
+    static constexpr std::array attributes = {
+        VertexAttribute::Of<glm::vec3>(offsetof(Vertex, position)),
+        VertexAttribute::Of<glm::vec2>(offsetof(Vertex, uv))
+    };
 };
 }
@@ -0,0 +1,195 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vulkan/vulkan.h>
+
+namespace veng {
+// Bytes per element of the formats vertex attributes may use; zero for the rest.
+constexpr std::uint32_t GetVertexFormatSize(const VkFormat format) {
+    switch (format) {
+        case VK_FORMAT_R32_SFLOAT:
+        case VK_FORMAT_R32_UINT:
+        case VK_FORMAT_R32_SINT:
+        case VK_FORMAT_R16G16_SFLOAT:
+        case VK_FORMAT_R16G16_UNORM:
+        case VK_FORMAT_R16G16_SNORM:
+        case VK_FORMAT_R8G8B8A8_UNORM:
+        case VK_FORMAT_R8G8B8A8_SNORM:
+        case VK_FORMAT_R8G8B8A8_UINT:
+        case VK_FORMAT_A2B10G10R10_UNORM_PACK32:
+        case VK_FORMAT_A2B10G10R10_SNORM_PACK32:
+            return 4;
+        case VK_FORMAT_R32G32_SFLOAT:
+        case VK_FORMAT_R32G32_UINT:
+        case VK_FORMAT_R32G32_SINT:
+        case VK_FORMAT_R16G16B16A16_SFLOAT:
+        case VK_FORMAT_R16G16B16A16_UNORM:
+        case VK_FORMAT_R16G16B16A16_SNORM:
+        case VK_FORMAT_R16G16B16A16_UINT:
+            return 8;
+        case VK_FORMAT_R32G32B32_SFLOAT:
+        case VK_FORMAT_R32G32B32_UINT:
+        case VK_FORMAT_R32G32B32_SINT:
+            return 12;
+        case VK_FORMAT_R32G32B32A32_SFLOAT:
+        case VK_FORMAT_R32G32B32A32_UINT:
+        case VK_FORMAT_R32G32B32A32_SINT:
+            return 16;
+        default:
+            return 0;
+    }
+}
+
+// How a member of type T is read. Specialise it for further member types.
+template <typename T>
+struct VertexFormatOf;
+
+template <>
+struct VertexFormatOf<float> {
+    static constexpr VkFormat format = VK_FORMAT_R32_SFLOAT;
+    static constexpr std::uint32_t columns = 1;
+};
+
+template <>
+struct VertexFormatOf<glm::vec2> {
+    static constexpr VkFormat format = VK_FORMAT_R32G32_SFLOAT;
+    static constexpr std::uint32_t columns = 1;
+};
+
+template <>
+struct VertexFormatOf<glm::vec3> {
+    static constexpr VkFormat format = VK_FORMAT_R32G32B32_SFLOAT;
+    static constexpr std::uint32_t columns = 1;
+};
+
+template <>
+struct VertexFormatOf<glm::vec4> {
+    static constexpr VkFormat format = VK_FORMAT_R32G32B32A32_SFLOAT;
+    static constexpr std::uint32_t columns = 1;
+};
+
+template <>
+struct VertexFormatOf<glm::mat4> {
+    static constexpr VkFormat format = VK_FORMAT_R32G32B32A32_SFLOAT;
+    static constexpr std::uint32_t columns = 4;
+};
+
+struct VertexAttribute {
+    VkFormat format = VK_FORMAT_UNDEFINED;
+    std::uint32_t offset = 0;
+    // Matrices take one location per column, the columns packed one after the other.
+    std::uint32_t columns = 1;
+
+    template <typename Member>
+    static constexpr VertexAttribute Of(const std::size_t offset) {
+        return {VertexFormatOf<Member>::format, static_cast<std::uint32_t>(offset), VertexFormatOf<Member>::columns};
+    }
+
+    // For members whose type does not determine the format, such as packed integers.
+    static constexpr VertexAttribute Of(const VkFormat format, const std::size_t offset) {
+        return {format, static_cast<std::uint32_t>(offset), 1};
+    }
+
+    [[nodiscard]] constexpr std::uint32_t GetSize() const {
+        return GetVertexFormatSize(format) * columns;
+    }
+};
+
+// Describes the attributes of a vertex type, in shader location order. Specialise it next to the type:
+//
+//     template <>
+//     struct VertexTraits<Vertex> {
+//         using Type = Vertex;
+//         static constexpr std::array attributes = {VertexAttribute::Of<glm::vec3>(offsetof(Vertex, position))};
+//     };
+//
+// Types read in more than one way, like PackedVertex, use standalone structs of the same shape instead.
+template <typename T>
+struct VertexTraits;
+
+// Per-instance transforms, as instanced.vert reads them.
+template <>
+struct VertexTraits<glm::mat4> {
+    using Type = glm::mat4;
+    static constexpr std::array attributes = {VertexAttribute::Of<glm::mat4>(0)};
+};
+
+// One vertex buffer binding of a layout, read with Traits.
+template <typename Traits, VkVertexInputRate InputRate>
+struct VertexBinding {
+    using TraitsType = Traits;
+    static constexpr VkVertexInputRate input_rate = InputRate;
+};
+
+template <typename T>
+using PerVertex = VertexBinding<VertexTraits<T>, VK_VERTEX_INPUT_RATE_VERTEX>;
+template <typename T>
+using PerInstance = VertexBinding<VertexTraits<T>, VK_VERTEX_INPUT_RATE_INSTANCE>;
+
+// Every attribute has a known format, lies within the vertex and overlaps no other.
+template <typename Traits>
+consteval bool AreValidVertexTraits() {
+    const auto &attributes = Traits::attributes;
+    for (std::size_t index = 0; index < attributes.size(); ++index) {
+        const VertexAttribute &attribute = attributes[index];
+        if (GetVertexFormatSize(attribute.format) == 0 ||
+            attribute.offset + attribute.GetSize() > sizeof(typename Traits::Type)) {
+            return false;
+        }
+        for (std::size_t other_index = 0; other_index < index; ++other_index) {
+            const VertexAttribute &other = attributes[other_index];
+            if (attribute.offset < other.offset + other.GetSize() &&
+                other.offset < attribute.offset + attribute.GetSize()) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+template <typename Traits>
+consteval std::size_t CountVertexLocations() {
+    std::size_t locations = 0;
+    for (const VertexAttribute &attribute: Traits::attributes) {
+        locations += attribute.columns;
+    }
+    return locations;
+}
+
+template <std::size_t BindingCount, std::size_t AttributeCount>
+struct StaticVertexLayout {
+    std::array<VkVertexInputBindingDescription, BindingCount> bindings{};
+    std::array<VkVertexInputAttributeDescription, AttributeCount> attributes{};
+};
+
+template <typename Binding, typename Layout>
+constexpr void AppendVertexBinding(Layout &layout, std::uint32_t &binding, std::uint32_t &location) {
+    using Traits = typename Binding::TraitsType;
+    constexpr auto stride = static_cast<std::uint32_t>(sizeof(typename Traits::Type));
+    layout.bindings[binding] = {binding, stride, Binding::input_rate};
+    for (const VertexAttribute &attribute: Traits::attributes) {
+        for (std::uint32_t column = 0; column < attribute.columns; ++column) {
+            layout.attributes[location] = {
+                location, binding, attribute.format, attribute.offset + column * GetVertexFormatSize(attribute.format)
+            };
+            ++location;
+        }
+    }
+    ++binding;
+}
+
+// Binding and attribute descriptions for the given bindings, worked out while compiling. Bindings are numbered in
+// argument order and locations continue across them, which is how shaders declare per-vertex and per-instance inputs.
+template <typename... Bindings>
+consteval auto MakeVertexLayout() {
+    static_assert((AreValidVertexTraits<typename Bindings::TraitsType>() && ...),
+                  "Vertex attributes need a supported format, have to lie within their vertex and must not overlap");
+
+    StaticVertexLayout<sizeof...(Bindings), (CountVertexLocations<typename Bindings::TraitsType>() + ... + 0)> layout;
+    std::uint32_t binding = 0;
+    std::uint32_t location = 0;
+    (AppendVertexBinding<Bindings>(layout, binding, location), ...);
+    return layout;
+}
+} // veng
@@ -0,0 +1,317 @@
+#include "vulkan_extensions.h"
+
+#pragma region VK_FUNCITON_EXT_IMPL
+
+namespace {
+PFN_vkCmdPipelineBarrier2KHR cmd_pipeline_barrier2 = nullptr;
+PFN_vkCmdSetCullModeEXT cmd_set_cull_mode = nullptr;
+PFN_vkCmdSetFrontFaceEXT cmd_set_front_face = nullptr;
+PFN_vkCmdSetPrimitiveTopologyEXT cmd_set_primitive_topology = nullptr;
+PFN_vkCmdSetDepthTestEnableEXT cmd_set_depth_test_enable = nullptr;
+PFN_vkCmdSetDepthWriteEnableEXT cmd_set_depth_write_enable = nullptr;
+PFN_vkCmdSetDepthCompareOpEXT cmd_set_depth_compare_op = nullptr;
+PFN_vkCmdSetPrimitiveRestartEnableEXT cmd_set_primitive_restart_enable = nullptr;
+PFN_vkCmdSetColorBlendEnableEXT cmd_set_color_blend_enable = nullptr;
+PFN_vkCmdSetColorBlendEquationEXT cmd_set_color_blend_equation = nullptr;
+PFN_vkCreateShadersEXT create_shaders = nullptr;
+PFN_vkDestroyShaderEXT destroy_shader = nullptr;
+PFN_vkCmdBindShadersEXT cmd_bind_shaders = nullptr;
+PFN_vkCmdBeginRenderingKHR cmd_begin_rendering = nullptr;
+PFN_vkCmdEndRenderingKHR cmd_end_rendering = nullptr;
+PFN_vkCmdSetViewportWithCountEXT cmd_set_viewport_with_count = nullptr;
+PFN_vkCmdSetScissorWithCountEXT cmd_set_scissor_with_count = nullptr;
+PFN_vkCmdSetVertexInputEXT cmd_set_vertex_input = nullptr;
+PFN_vkCmdSetRasterizerDiscardEnableEXT cmd_set_rasterizer_discard_enable = nullptr;
+PFN_vkCmdSetDepthBiasEnableEXT cmd_set_depth_bias_enable = nullptr;
+PFN_vkCmdSetDepthBoundsTestEnableEXT cmd_set_depth_bounds_test_enable = nullptr;
+PFN_vkCmdSetStencilTestEnableEXT cmd_set_stencil_test_enable = nullptr;
+PFN_vkCmdSetDepthClampEnableEXT cmd_set_depth_clamp_enable = nullptr;
+PFN_vkCmdSetPolygonModeEXT cmd_set_polygon_mode = nullptr;
+PFN_vkCmdSetRasterizationSamplesEXT cmd_set_rasterization_samples = nullptr;
+PFN_vkCmdSetSampleMaskEXT cmd_set_sample_mask = nullptr;
+PFN_vkCmdSetAlphaToCoverageEnableEXT cmd_set_alpha_to_coverage_enable = nullptr;
+PFN_vkCmdSetColorWriteMaskEXT cmd_set_color_write_mask = nullptr;
+PFN_vkGetDescriptorSetLayoutSizeEXT get_descriptor_set_layout_size = nullptr;
+PFN_vkGetDescriptorSetLayoutBindingOffsetEXT get_descriptor_set_layout_binding_offset = nullptr;
+PFN_vkGetDescriptorEXT get_descriptor = nullptr;
+PFN_vkCmdBindDescriptorBuffersEXT cmd_bind_descriptor_buffers = nullptr;
+PFN_vkCmdSetDescriptorBufferOffsetsEXT cmd_set_descriptor_buffer_offsets = nullptr;
+
+template<typename Function>
+void LoadDeviceFunction(VkDevice device, Function &function, const char *name) {
+    function = reinterpret_cast<Function>(vkGetDeviceProcAddr(device, name));
+}
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdPipelineBarrier2KHR(VkCommandBuffer commandBuffer,
+                                                    const VkDependencyInfo *pDependencyInfo) {
+    if (cmd_pipeline_barrier2 != nullptr) {
+        cmd_pipeline_barrier2(commandBuffer, pDependencyInfo);
+    }
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetCullModeEXT(VkCommandBuffer commandBuffer, VkCullModeFlags cullMode) {
+    if (cmd_set_cull_mode != nullptr) {
+        cmd_set_cull_mode(commandBuffer, cullMode);
+    }
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetFrontFaceEXT(VkCommandBuffer commandBuffer, VkFrontFace frontFace) {
+    if (cmd_set_front_face != nullptr) {
+        cmd_set_front_face(commandBuffer, frontFace);
+    }
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetPrimitiveTopologyEXT(VkCommandBuffer commandBuffer,
+                                                        VkPrimitiveTopology primitiveTopology) {
+    if (cmd_set_primitive_topology != nullptr) {
+        cmd_set_primitive_topology(commandBuffer, primitiveTopology);
+    }
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetDepthTestEnableEXT(VkCommandBuffer commandBuffer, VkBool32 depthTestEnable) {
+    if (cmd_set_depth_test_enable != nullptr) {
+        cmd_set_depth_test_enable(commandBuffer, depthTestEnable);
+    }
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetDepthWriteEnableEXT(VkCommandBuffer commandBuffer, VkBool32 depthWriteEnable) {
+    if (cmd_set_depth_write_enable != nullptr) {
+        cmd_set_depth_write_enable(commandBuffer, depthWriteEnable);
+    }
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetDepthCompareOpEXT(VkCommandBuffer commandBuffer, VkCompareOp depthCompareOp) {
+    if (cmd_set_depth_compare_op != nullptr) {
+        cmd_set_depth_compare_op(commandBuffer, depthCompareOp);
+    }
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetPrimitiveRestartEnableEXT(VkCommandBuffer commandBuffer,
+                                                             VkBool32 primitiveRestartEnable) {
+    if (cmd_set_primitive_restart_enable != nullptr) {
+        cmd_set_primitive_restart_enable(commandBuffer, primitiveRestartEnable);
+    }
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetColorBlendEnableEXT(VkCommandBuffer commandBuffer, uint32_t firstAttachment,
+                                                       uint32_t attachmentCount,
+                                                       const VkBool32 *pColorBlendEnables) {
+    if (cmd_set_color_blend_enable != nullptr) {
+        cmd_set_color_blend_enable(commandBuffer, firstAttachment, attachmentCount, pColorBlendEnables);
+    }
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetColorBlendEquationEXT(VkCommandBuffer commandBuffer, uint32_t firstAttachment,
+                                                         uint32_t attachmentCount,
+                                                         const VkColorBlendEquationEXT *pColorBlendEquations) {
+    if (cmd_set_color_blend_equation != nullptr) {
+        cmd_set_color_blend_equation(commandBuffer, firstAttachment, attachmentCount, pColorBlendEquations);
+    }
+}
+
+VKAPI_ATTR VkResult VKAPI_CALL vkCreateShadersEXT(VkDevice device, uint32_t createInfoCount,
+                                                  const VkShaderCreateInfoEXT *pCreateInfos,
+                                                  const VkAllocationCallbacks *pAllocator, VkShaderEXT *pShaders) {
+    if (create_shaders == nullptr) {
+        return VK_ERROR_EXTENSION_NOT_PRESENT;
+    }
+    return create_shaders(device, createInfoCount, pCreateInfos, pAllocator, pShaders);
+}
+
+VKAPI_ATTR void VKAPI_CALL vkDestroyShaderEXT(VkDevice device, VkShaderEXT shader,
+                                              const VkAllocationCallbacks *pAllocator) {
+    if (destroy_shader != nullptr) {
+        destroy_shader(device, shader, pAllocator);
+    }
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdBindShadersEXT(VkCommandBuffer commandBuffer, uint32_t stageCount,
+                                               const VkShaderStageFlagBits *pStages, const VkShaderEXT *pShaders) {
+    if (cmd_bind_shaders != nullptr) {
+        cmd_bind_shaders(commandBuffer, stageCount, pStages, pShaders);
+    }
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdBeginRenderingKHR(VkCommandBuffer commandBuffer,
+                                                  const VkRenderingInfo *pRenderingInfo) {
+    if (cmd_begin_rendering != nullptr) {
+        cmd_begin_rendering(commandBuffer, pRenderingInfo);
+    }
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdEndRenderingKHR(VkCommandBuffer commandBuffer) {
+    if (cmd_end_rendering != nullptr) {
+        cmd_end_rendering(commandBuffer);
+    }
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetViewportWithCountEXT(VkCommandBuffer commandBuffer, uint32_t viewportCount,
+                                                        const VkViewport *pViewports) {
+    if (cmd_set_viewport_with_count != nullptr) {
+        cmd_set_viewport_with_count(commandBuffer, viewportCount, pViewports);
+    }
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetScissorWithCountEXT(VkCommandBuffer commandBuffer, uint32_t scissorCount,
+                                                       const VkRect2D *pScissors) {
+    if (cmd_set_scissor_with_count != nullptr) {
+        cmd_set_scissor_with_count(commandBuffer, scissorCount, pScissors);
+    }
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetVertexInputEXT(
+    VkCommandBuffer commandBuffer, uint32_t vertexBindingDescriptionCount,
+    const VkVertexInputBindingDescription2EXT *pVertexBindingDescriptions, uint32_t vertexAttributeDescriptionCount,
+    const VkVertexInputAttributeDescription2EXT *pVertexAttributeDescriptions) {
+    if (cmd_set_vertex_input != nullptr) {
+        cmd_set_vertex_input(commandBuffer, vertexBindingDescriptionCount, pVertexBindingDescriptions,
+                             vertexAttributeDescriptionCount, pVertexAttributeDescriptions);
+    }
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetRasterizerDiscardEnableEXT(VkCommandBuffer commandBuffer,
+                                                              VkBool32 rasterizerDiscardEnable) {
+    if (cmd_set_rasterizer_discard_enable != nullptr) {
+        cmd_set_rasterizer_discard_enable(commandBuffer, rasterizerDiscardEnable);
+    }
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetDepthBiasEnableEXT(VkCommandBuffer commandBuffer, VkBool32 depthBiasEnable) {
+    if (cmd_set_depth_bias_enable != nullptr) {
+        cmd_set_depth_bias_enable(commandBuffer, depthBiasEnable);
+    }
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetDepthBoundsTestEnableEXT(VkCommandBuffer commandBuffer,
+                                                            VkBool32 depthBoundsTestEnable) {
+    if (cmd_set_depth_bounds_test_enable != nullptr) {
+        cmd_set_depth_bounds_test_enable(commandBuffer, depthBoundsTestEnable);
+    }
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetStencilTestEnableEXT(VkCommandBuffer commandBuffer, VkBool32 stencilTestEnable) {
+    if (cmd_set_stencil_test_enable != nullptr) {
+        cmd_set_stencil_test_enable(commandBuffer, stencilTestEnable);
+    }
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetDepthClampEnableEXT(VkCommandBuffer commandBuffer, VkBool32 depthClampEnable) {
+    if (cmd_set_depth_clamp_enable != nullptr) {
+        cmd_set_depth_clamp_enable(commandBuffer, depthClampEnable);
+    }
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetPolygonModeEXT(VkCommandBuffer commandBuffer, VkPolygonMode polygonMode) {
+    if (cmd_set_polygon_mode != nullptr) {
+        cmd_set_polygon_mode(commandBuffer, polygonMode);
+    }
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetRasterizationSamplesEXT(VkCommandBuffer commandBuffer,
+                                                           VkSampleCountFlagBits rasterizationSamples) {
+    if (cmd_set_rasterization_samples != nullptr) {
+        cmd_set_rasterization_samples(commandBuffer, rasterizationSamples);
+    }
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetSampleMaskEXT(VkCommandBuffer commandBuffer, VkSampleCountFlagBits samples,
+                                                 const VkSampleMask *pSampleMask) {
+    if (cmd_set_sample_mask != nullptr) {
+        cmd_set_sample_mask(commandBuffer, samples, pSampleMask);
+    }
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetAlphaToCoverageEnableEXT(VkCommandBuffer commandBuffer,
+                                                            VkBool32 alphaToCoverageEnable) {
+    if (cmd_set_alpha_to_coverage_enable != nullptr) {
+        cmd_set_alpha_to_coverage_enable(commandBuffer, alphaToCoverageEnable);
+    }
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetColorWriteMaskEXT(VkCommandBuffer commandBuffer, uint32_t firstAttachment,
+                                                     uint32_t attachmentCount,
+                                                     const VkColorComponentFlags *pColorWriteMasks) {
+    if (cmd_set_color_write_mask != nullptr) {
+        cmd_set_color_write_mask(commandBuffer, firstAttachment, attachmentCount, pColorWriteMasks);
+    }
+}
+
+VKAPI_ATTR void VKAPI_CALL vkGetDescriptorSetLayoutSizeEXT(VkDevice device, VkDescriptorSetLayout layout,
+                                                           VkDeviceSize *pLayoutSizeInBytes) {
+    if (get_descriptor_set_layout_size != nullptr) {
+        get_descriptor_set_layout_size(device, layout, pLayoutSizeInBytes);
+    }
+}
+
+VKAPI_ATTR void VKAPI_CALL vkGetDescriptorSetLayoutBindingOffsetEXT(VkDevice device, VkDescriptorSetLayout layout,
+                                                                    uint32_t binding, VkDeviceSize *pOffset) {
+    if (get_descriptor_set_layout_binding_offset != nullptr) {
+        get_descriptor_set_layout_binding_offset(device, layout, binding, pOffset);
+    }
+}
+
+VKAPI_ATTR void VKAPI_CALL vkGetDescriptorEXT(VkDevice device, const VkDescriptorGetInfoEXT *pDescriptorInfo,
+                                              size_t dataSize, void *pDescriptor) {
+    if (get_descriptor != nullptr) {
+        get_descriptor(device, pDescriptorInfo, dataSize, pDescriptor);
+    }
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdBindDescriptorBuffersEXT(VkCommandBuffer commandBuffer, uint32_t bufferCount,
+                                                         const VkDescriptorBufferBindingInfoEXT *pBindingInfos) {
+    if (cmd_bind_descriptor_buffers != nullptr) {
+        cmd_bind_descriptor_buffers(commandBuffer, bufferCount, pBindingInfos);
+    }
+}
+
+VKAPI_ATTR void VKAPI_CALL vkCmdSetDescriptorBufferOffsetsEXT(VkCommandBuffer commandBuffer,
+                                                              VkPipelineBindPoint pipelineBindPoint,
+                                                              VkPipelineLayout layout, uint32_t firstSet,
+                                                              uint32_t setCount, const uint32_t *pBufferIndices,
+                                                              const VkDeviceSize *pOffsets) {
+    if (cmd_set_descriptor_buffer_offsets != nullptr) {
+        cmd_set_descriptor_buffer_offsets(commandBuffer, pipelineBindPoint, layout, firstSet, setCount,
+                                          pBufferIndices, pOffsets);
+    }
+}
+
+#pragma endregion
+
+namespace veng {
+void LoadDeviceExtensionFunctions(VkDevice device) {
+    LoadDeviceFunction(device, cmd_pipeline_barrier2, "vkCmdPipelineBarrier2KHR");
+    LoadDeviceFunction(device, cmd_set_cull_mode, "vkCmdSetCullModeEXT");
+    LoadDeviceFunction(device, cmd_set_front_face, "vkCmdSetFrontFaceEXT");
+    LoadDeviceFunction(device, cmd_set_primitive_topology, "vkCmdSetPrimitiveTopologyEXT");
+    LoadDeviceFunction(device, cmd_set_depth_test_enable, "vkCmdSetDepthTestEnableEXT");
+    LoadDeviceFunction(device, cmd_set_depth_write_enable, "vkCmdSetDepthWriteEnableEXT");
+    LoadDeviceFunction(device, cmd_set_depth_compare_op, "vkCmdSetDepthCompareOpEXT");
+    LoadDeviceFunction(device, cmd_set_primitive_restart_enable, "vkCmdSetPrimitiveRestartEnableEXT");
+    LoadDeviceFunction(device, cmd_set_color_blend_enable, "vkCmdSetColorBlendEnableEXT");
+    LoadDeviceFunction(device, cmd_set_color_blend_equation, "vkCmdSetColorBlendEquationEXT");
+    LoadDeviceFunction(device, create_shaders, "vkCreateShadersEXT");
+    LoadDeviceFunction(device, destroy_shader, "vkDestroyShaderEXT");
+    LoadDeviceFunction(device, cmd_bind_shaders, "vkCmdBindShadersEXT");
+    LoadDeviceFunction(device, cmd_begin_rendering, "vkCmdBeginRenderingKHR");
+    LoadDeviceFunction(device, cmd_end_rendering, "vkCmdEndRenderingKHR");
+    LoadDeviceFunction(device, cmd_set_viewport_with_count, "vkCmdSetViewportWithCountEXT");
+    LoadDeviceFunction(device, cmd_set_scissor_with_count, "vkCmdSetScissorWithCountEXT");
+    LoadDeviceFunction(device, cmd_set_vertex_input, "vkCmdSetVertexInputEXT");
+    LoadDeviceFunction(device, cmd_set_rasterizer_discard_enable, "vkCmdSetRasterizerDiscardEnableEXT");
+    LoadDeviceFunction(device, cmd_set_depth_bias_enable, "vkCmdSetDepthBiasEnableEXT");
+    LoadDeviceFunction(device, cmd_set_depth_bounds_test_enable, "vkCmdSetDepthBoundsTestEnableEXT");
+    LoadDeviceFunction(device, cmd_set_stencil_test_enable, "vkCmdSetStencilTestEnableEXT");
+    LoadDeviceFunction(device, cmd_set_depth_clamp_enable, "vkCmdSetDepthClampEnableEXT");
+    LoadDeviceFunction(device, cmd_set_polygon_mode, "vkCmdSetPolygonModeEXT");
+    LoadDeviceFunction(device, cmd_set_rasterization_samples, "vkCmdSetRasterizationSamplesEXT");
+    LoadDeviceFunction(device, cmd_set_sample_mask, "vkCmdSetSampleMaskEXT");
+    LoadDeviceFunction(device, cmd_set_alpha_to_coverage_enable, "vkCmdSetAlphaToCoverageEnableEXT");
+    LoadDeviceFunction(device, cmd_set_color_write_mask, "vkCmdSetColorWriteMaskEXT");
+    LoadDeviceFunction(device, get_descriptor_set_layout_size, "vkGetDescriptorSetLayoutSizeEXT");
+    LoadDeviceFunction(device, get_descriptor_set_layout_binding_offset, "vkGetDescriptorSetLayoutBindingOffsetEXT");
+    LoadDeviceFunction(device, get_descriptor, "vkGetDescriptorEXT");
+    LoadDeviceFunction(device, cmd_bind_descriptor_buffers, "vkCmdBindDescriptorBuffersEXT");
+    LoadDeviceFunction(device, cmd_set_descriptor_buffer_offsets, "vkCmdSetDescriptorBufferOffsetsEXT");
+}
+} // veng
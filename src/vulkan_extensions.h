@@ -0,0 +1,9 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+
+namespace veng {
+// Device-level extension entry points are not exported by the loader, so they are resolved once per device and
+// forwarded by the definitions in vulkan_extensions.cpp.
+void LoadDeviceExtensionFunctions(VkDevice device);
+} // veng
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+namespace veng {
+// Chase-Lev deque with the memory orderings of Lê et al., "Correct and Efficient Work-Stealing for Weak Memory
+// Models". The owning thread pushes and pops at the bottom, any other thread steals from the top. The ring buffer
+// grows when full; replaced buffers are kept until destruction because thieves may still be reading them.
+template <typename T>
+class WorkStealingDeque final {
+public:
+    explicit WorkStealingDeque(const std::int64_t capacity = 1024) {
+        buffers_.push_back(std::make_unique<Buffer>(capacity));
+        buffer_.store(buffers_.back().get(), std::memory_order_relaxed);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque &) = delete;
+    WorkStealingDeque &operator=(const WorkStealingDeque &) = delete;
+
+    // Owner only.
+    void Push(T *item) {
+        const std::int64_t bottom = bottom_.load(std::memory_order_relaxed);
+        const std::int64_t top = top_.load(std::memory_order_acquire);
+        Buffer *buffer = buffer_.load(std::memory_order_relaxed);
+        if (bottom - top > buffer->capacity - 1) {
+            buffer = Grow(buffer, top, bottom);
+        }
+        buffer->Put(bottom, item);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    // Owner only; the most recently pushed item, or null when empty.
+    T *Pop() {
+        const std::int64_t bottom = bottom_.load(std::memory_order_relaxed) - 1;
+        Buffer *buffer = buffer_.load(std::memory_order_relaxed);
+        bottom_.store(bottom, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        std::int64_t top = top_.load(std::memory_order_relaxed);
+
+        if (top > bottom) {
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        T *item = buffer->Get(bottom);
+        if (top == bottom) {
+            // Last item; a thief may be taking it at the same time.
+            if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                item = nullptr;
+            }
+            bottom_.store(bottom + 1, std::memory_order_relaxed);
+        }
+        return item;
+    }
+
+    // Any thread; the oldest item, or null when empty or another thread won the race for it.
+    T *Steal() {
+        std::int64_t top = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const std::int64_t bottom = bottom_.load(std::memory_order_acquire);
+        if (top >= bottom) {
+            return nullptr;
+        }
+
+        T *item = buffer_.load(std::memory_order_acquire)->Get(top);
+        if (!top_.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return item;
+    }
+
+private:
+    struct Buffer {
+        explicit Buffer(const std::int64_t buffer_capacity)
+            : capacity(buffer_capacity), slots(std::make_unique<std::atomic<T *>[]>(buffer_capacity)) {
+        }
+
+        // Capacities are powers of two, so wrapping is a mask.
+        [[nodiscard]] T *Get(const std::int64_t index) const {
+            return slots[index & (capacity - 1)].load(std::memory_order_relaxed);
+        }
+
+        void Put(const std::int64_t index, T *item) {
+            slots[index & (capacity - 1)].store(item, std::memory_order_relaxed);
+        }
+
+        std::int64_t capacity;
+        std::unique_ptr<std::atomic<T *>[]> slots;
+    };
+
+    Buffer *Grow(const Buffer *old_buffer, const std::int64_t top, const std::int64_t bottom) {
+        buffers_.push_back(std::make_unique<Buffer>(old_buffer->capacity * 2));
+        Buffer *buffer = buffers_.back().get();
+        for (std::int64_t index = top; index < bottom; ++index) {
+            buffer->Put(index, old_buffer->Get(index));
+        }
+        buffer_.store(buffer, std::memory_order_release);
+        return buffer;
+    }
+
+    // Apart, so the owner's bottom updates do not invalidate the thieves' cache line holding top.
+    alignas(64) std::atomic<std::int64_t> top_ = 0;
+    alignas(64) std::atomic<std::int64_t> bottom_ = 0;
+    std::atomic<Buffer *> buffer_ = nullptr;
+    // Owner only.
+    std::vector<std::unique_ptr<Buffer>> buffers_;
+};
+} // veng
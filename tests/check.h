@@ -0,0 +1,32 @@
+#pragma once
+
+#include <atomic>
+#include <cstdlib>
+#include <source_location>
+#include <string_view>
+
+#include <spdlog/spdlog.h>
+
+namespace veng::test {
+// Atomic since checks may run on job system workers.
+inline std::atomic<int> failed_checks = 0;
+
+// Reports a failed condition without stopping, so one run lists every failure.
+inline void Check(const bool condition, const std::string_view what,
+                  const std::source_location location = std::source_location::current()) {
+    if (!condition) {
+        ++failed_checks;
+        spdlog::error("{}:{}: {}", location.file_name(), location.line(), what);
+    }
+}
+
+// Returned from main so ctest picks up failures.
+inline int GetExitCode() {
+    if (failed_checks != 0) {
+        spdlog::error("{} checks failed", failed_checks.load());
+        return EXIT_FAILURE;
+    }
+    spdlog::info("All checks passed");
+    return EXIT_SUCCESS;
+}
+} // veng::test
@@ -0,0 +1,122 @@
+#include "frustum_culling.h"
+
+#include <algorithm>
+#include <precomp.h>
+#include <random>
+
+#include <spdlog/spdlog.h>
+
+#include "check.h"
+#include "glm/gtc/matrix_transform.hpp"
+
+namespace {
+using veng::test::Check;
+
+constexpr std::array kPaths = {veng::SimdPath::Scalar, veng::SimdPath::Sse, veng::SimdPath::Avx2};
+// None are multiples of four or eight, so every SIMD path also runs its scalar tail.
+constexpr std::array<std::size_t, 6> kCounts = {1, 3, 7, 13, 1021, 100003};
+
+veng::Frustum MakeFrustum() {
+    const glm::mat4 view = glm::translate(glm::mat4(1.0f), glm::vec3(0.0f, 0.0f, -5.0f));
+    const glm::mat4 proj = glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 0.1f, 100.0f);
+    return veng::Frustum::FromViewProjection(view, proj);
+}
+
+void CheckAscending(const std::vector<std::uint32_t> &visible) {
+    Check(std::ranges::adjacent_find(visible, std::greater_equal<>()) == visible.end(),
+          "visible indices are ascending");
+}
+
+void TestSpheresAgreeAcrossPaths(const veng::Frustum &frustum) {
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+    std::uniform_real_distribution<float> radius(0.0f, 4.0f);
+
+    for (const std::size_t count: kCounts) {
+        veng::BoundingSpheres spheres;
+        spheres.Reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            spheres.Add({position(random), position(random), position(random)}, radius(random));
+        }
+
+        std::vector<std::uint32_t> reference;
+        veng::CullSpheres(frustum, spheres, reference, veng::SimdPath::Scalar);
+        CheckAscending(reference);
+        if (count > 1000) {
+            Check(!reference.empty() && reference.size() < count, "the scene is partially visible");
+        }
+        for (const veng::SimdPath path: kPaths) {
+            std::vector<std::uint32_t> visible = {42};
+            veng::CullSpheres(frustum, spheres, visible, path);
+            Check(visible == reference, "sphere culling matches the scalar path");
+        }
+    }
+}
+
+void TestBoxesAgreeAcrossPaths(const veng::Frustum &frustum) {
+    std::mt19937 random(11);
+    std::uniform_real_distribution<float> position(-60.0f, 60.0f);
+    std::uniform_real_distribution<float> extent(0.0f, 4.0f);
+
+    for (const std::size_t count: kCounts) {
+        veng::BoundingBoxes boxes;
+        boxes.Reserve(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            const glm::vec3 center = {position(random), position(random), position(random)};
+            const glm::vec3 half_extent = {extent(random), extent(random), extent(random)};
+            boxes.Add(center - half_extent, center + half_extent);
+        }
+
+        std::vector<std::uint32_t> reference;
+        veng::CullBoxes(frustum, boxes, reference, veng::SimdPath::Scalar);
+        CheckAscending(reference);
+        if (count > 1000) {
+            Check(!reference.empty() && reference.size() < count, "the scene is partially visible");
+        }
+        for (const veng::SimdPath path: kPaths) {
+            std::vector<std::uint32_t> visible = {42};
+            veng::CullBoxes(frustum, boxes, visible, path);
+            Check(visible == reference, "box culling matches the scalar path");
+        }
+    }
+}
+
+void TestKnownVisibility(const veng::Frustum &frustum) {
+    veng::BoundingSpheres spheres;
+    spheres.Add({0.0f, 0.0f, 0.0f}, 0.5f);
+    spheres.Add({0.0f, 0.0f, 10.0f}, 0.5f);
+    spheres.Add({0.0f, 0.0f, -200.0f}, 0.5f);
+    spheres.Add({500.0f, 0.0f, 0.0f}, 0.5f);
+    spheres.Add({0.0f, 0.0f, -10.0f}, 1.0f);
+
+    veng::BoundingBoxes boxes;
+    for (std::size_t i = 0; i < spheres.Size(); ++i) {
+        const glm::vec3 center = {spheres.center_x[i], spheres.center_y[i], spheres.center_z[i]};
+        const glm::vec3 half_extent(spheres.radius[i]);
+        boxes.Add(center - half_extent, center + half_extent);
+    }
+
+    const std::vector<std::uint32_t> expected = {0, 4};
+    for (const veng::SimdPath path: kPaths) {
+        std::vector<std::uint32_t> visible;
+        veng::CullSpheres(frustum, spheres, visible, path);
+        Check(visible == expected, "only the spheres in front of the camera are visible");
+        veng::CullBoxes(frustum, boxes, visible, path);
+        Check(visible == expected, "only the boxes in front of the camera are visible");
+    }
+
+    std::vector<std::uint32_t> visible = {1, 2, 3};
+    veng::CullSpheres(frustum, {}, visible);
+    Check(visible.empty(), "culling nothing clears the output");
+}
+}
+
+int main() {
+    spdlog::info("Best SIMD path: {}", static_cast<int>(veng::GetBestSimdPath()));
+
+    const veng::Frustum frustum = MakeFrustum();
+    TestSpheresAgreeAcrossPaths(frustum);
+    TestBoxesAgreeAcrossPaths(frustum);
+    TestKnownVisibility(frustum);
+    return veng::test::GetExitCode();
+}
@@ -0,0 +1,158 @@
+#include "job_system.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <precomp.h>
+#include <thread>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "check.h"
+
+namespace {
+using veng::test::Check;
+
+void TestParallelForCoversEveryIndex(veng::JobSystem &jobs) {
+    constexpr std::array<std::size_t, 5> kCounts = {0, 1, 97, 1000, 100003};
+    constexpr std::array<std::size_t, 4> kGrains = {1, 7, 64, 200000};
+
+    for (const std::size_t count: kCounts) {
+        for (const std::size_t grain: kGrains) {
+            if (count / grain > 20000) {
+                continue;
+            }
+
+            std::vector<std::atomic<std::uint32_t>> visits(count);
+            std::atomic<std::uint64_t> sum = 0;
+            jobs.ParallelFor(count, grain, [&](const std::size_t begin, const std::size_t end) {
+                Check(begin < end && end <= count && end - begin <= grain, "chunks are non-empty and within bounds");
+                std::uint64_t chunk_sum = 0;
+                for (std::size_t i = begin; i < end; ++i) {
+                    visits[i].fetch_add(1, std::memory_order_relaxed);
+                    chunk_sum += i;
+                }
+                sum.fetch_add(chunk_sum, std::memory_order_relaxed);
+            });
+
+            const std::uint64_t expected = count == 0 ? 0 : static_cast<std::uint64_t>(count) * (count - 1) / 2;
+            Check(sum.load() == expected, "ParallelFor sums every index");
+            Check(std::ranges::all_of(visits, [](const std::atomic<std::uint32_t> &visit) { return visit == 1; }),
+                  "ParallelFor visits every index once");
+        }
+    }
+}
+
+void TestDependencies(veng::JobSystem &jobs) {
+    constexpr std::uint32_t kJobsPerStage = 200;
+
+    veng::JobCounter first;
+    veng::JobCounter second;
+    veng::JobCounter third;
+    std::atomic<bool> released = false;
+    std::atomic<std::uint32_t> first_done = 0;
+    std::atomic<std::uint32_t> second_done = 0;
+    std::atomic<bool> ordered = true;
+
+    // The first stage holds until every stage is queued, so the later ones really wait on pending counters.
+    for (std::uint32_t i = 0; i < kJobsPerStage; ++i) {
+        jobs.Submit([&] {
+            while (!released.load()) {
+                std::this_thread::yield();
+            }
+            first_done.fetch_add(1);
+        }, &first);
+    }
+    for (std::uint32_t i = 0; i < kJobsPerStage; ++i) {
+        jobs.Submit([&] {
+            if (first_done.load() != kJobsPerStage) {
+                ordered = false;
+            }
+            second_done.fetch_add(1);
+        }, &second, &first);
+    }
+    for (std::uint32_t i = 0; i < kJobsPerStage; ++i) {
+        jobs.Submit([&] {
+            if (second_done.load() != kJobsPerStage) {
+                ordered = false;
+            }
+        }, &third, &second);
+    }
+    Check(!second.IsDone() && !third.IsDone(), "dependent stages are still pending");
+    released = true;
+
+    jobs.Wait(third);
+    Check(ordered.load(), "jobs only start once their dependency finished");
+    Check(first.IsDone() && second.IsDone() && third.IsDone(), "every counter finished");
+
+    // A dependency that already finished does not hold the job back.
+    std::atomic<bool> ran = false;
+    veng::JobCounter after_done;
+    jobs.Submit([&] { ran = true; }, &after_done, &first);
+    jobs.Wait(after_done);
+    Check(ran.load(), "jobs depending on a finished counter run");
+}
+
+void TestNestedWait(veng::JobSystem &jobs) {
+    constexpr std::size_t kOuterJobs = 64;
+    constexpr std::uint32_t kInnerJobs = 50;
+
+    std::atomic<std::uint32_t> inner_done = 0;
+    std::atomic<bool> waited = true;
+    jobs.ParallelFor(kOuterJobs, 1, [&](std::size_t, std::size_t) {
+        veng::JobCounter inner;
+        std::atomic<std::uint32_t> local_done = 0;
+        for (std::uint32_t i = 0; i < kInnerJobs; ++i) {
+            jobs.Submit([&] {
+                local_done.fetch_add(1);
+                inner_done.fetch_add(1);
+            }, &inner);
+        }
+        jobs.Wait(inner);
+        if (local_done.load() != kInnerJobs) {
+            waited = false;
+        }
+    });
+
+    Check(waited.load(), "Wait inside a job returns once its jobs finished");
+    Check(inner_done.load() == kOuterJobs * kInnerJobs, "every nested job ran");
+}
+
+void TestForeignThreadSubmit(veng::JobSystem &jobs) {
+    constexpr std::uint32_t kThreads = 4;
+    constexpr std::uint32_t kJobsPerThread = 1000;
+
+    veng::JobCounter counter;
+    std::atomic<std::uint32_t> done = 0;
+    std::vector<std::thread> threads;
+    for (std::uint32_t thread = 0; thread < kThreads; ++thread) {
+        threads.emplace_back([&] {
+            for (std::uint32_t i = 0; i < kJobsPerThread; ++i) {
+                // Jobs submitting more jobs push to the running worker's own deque instead.
+                jobs.Submit([&] { jobs.Submit([&] { done.fetch_add(1); }, &counter); }, &counter);
+            }
+        });
+    }
+    for (std::thread &thread: threads) {
+        thread.join();
+    }
+
+    jobs.Wait(counter);
+    Check(done.load() == kThreads * kJobsPerThread, "jobs submitted from other threads run");
+}
+}
+
+int main() {
+    for (const std::uint32_t worker_count: {0u, 1u, 3u}) {
+        spdlog::info("Testing with {} workers", worker_count);
+        veng::JobSystem jobs(worker_count);
+        Check(jobs.GetWorkerCount() == worker_count, "the requested workers are started");
+
+        TestParallelForCoversEveryIndex(jobs);
+        TestDependencies(jobs);
+        TestNestedWait(jobs);
+        TestForeignThreadSubmit(jobs);
+    }
+    return veng::test::GetExitCode();
+}
@@ -0,0 +1,161 @@
+#include "mesh_optimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <precomp.h>
+#include <random>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "check.h"
+
+namespace {
+using veng::test::Check;
+using Triangle = std::array<std::uint32_t, 3>;
+
+constexpr std::uint32_t kGridSize = 48;
+
+bool IsBitwiseEqual(const veng::Vertex &a, const veng::Vertex &b) {
+    return std::bit_cast<std::array<std::uint32_t, 5>>(std::array{a.position.x, a.position.y, a.position.z, a.uv.x,
+                                                                  a.uv.y}) ==
+           std::bit_cast<std::array<std::uint32_t, 5>>(std::array{b.position.x, b.position.y, b.position.z, b.uv.x,
+                                                                  b.uv.y});
+}
+
+// Triangles rotated to start at their smallest index, which keeps the winding, then sorted.
+std::vector<Triangle> GetTriangleSet(const std::span<const std::uint32_t> indices) {
+    std::vector<Triangle> triangles;
+    for (std::size_t i = 0; i + 2 < indices.size(); i += 3) {
+        Triangle triangle = {indices[i], indices[i + 1], indices[i + 2]};
+        std::ranges::rotate(triangle, std::ranges::min_element(triangle));
+        triangles.push_back(triangle);
+    }
+    std::ranges::sort(triangles);
+    return triangles;
+}
+
+// A grid of shared vertices bulged into a dome, so the overdraw pass sees clusters facing different ways, with its
+// triangles in random order and rotated at random.
+void MakeShuffledGrid(std::vector<veng::Vertex> &vertices, std::vector<std::uint32_t> &indices) {
+    for (std::uint32_t y = 0; y <= kGridSize; ++y) {
+        for (std::uint32_t x = 0; x <= kGridSize; ++x) {
+            const float u = static_cast<float>(x) / kGridSize;
+            const float v = static_cast<float>(y) / kGridSize;
+            const float height = 1.0f - (u - 0.5f) * (u - 0.5f) - (v - 0.5f) * (v - 0.5f);
+            vertices.emplace_back(glm::vec3(u, v, height), glm::vec2(u, v));
+        }
+    }
+
+    std::vector<Triangle> triangles;
+    for (std::uint32_t y = 0; y < kGridSize; ++y) {
+        for (std::uint32_t x = 0; x < kGridSize; ++x) {
+            const std::uint32_t corner = y * (kGridSize + 1) + x;
+            triangles.push_back({corner, corner + 1, corner + kGridSize + 2});
+            triangles.push_back({corner, corner + kGridSize + 2, corner + kGridSize + 1});
+        }
+    }
+
+    std::mt19937 random(1);
+    std::ranges::shuffle(triangles, random);
+    for (Triangle &triangle: triangles) {
+        std::ranges::rotate(triangle, triangle.begin() + random() % 3);
+        indices.insert(indices.end(), triangle.begin(), triangle.end());
+    }
+}
+
+void TestAnalyzeVertexCache() {
+    const std::array<std::uint32_t, 6> quad = {0, 1, 2, 2, 1, 3};
+    const veng::VertexCacheStatistics statistics = veng::AnalyzeVertexCache(quad, 4);
+    Check(statistics.vertices_transformed == 4, "shared vertices are transformed once");
+    Check(statistics.acmr == 2.0f && statistics.atvr == 1.0f, "ACMR and ATVR of a quad");
+}
+
+void TestDeduplicateVertices() {
+    std::vector<veng::Vertex> vertices = {
+        veng::Vertex({0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}),
+        veng::Vertex({1.0f, 0.0f, 0.0f}, {1.0f, 0.0f}),
+        veng::Vertex({0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}),
+        // Compares equal to the first vertex as floats, but not bitwise.
+        veng::Vertex({-0.0f, 0.0f, 0.0f}, {0.0f, 0.0f}),
+        veng::Vertex({1.0f, 0.0f, 0.0f}, {1.0f, 0.0f}),
+        veng::Vertex({0.0f, 1.0f, 0.0f}, {0.0f, 1.0f}),
+    };
+    std::vector<std::uint32_t> indices = {0, 1, 5, 2, 4, 3, 3, 5, 4};
+    const std::vector<veng::Vertex> original_vertices = vertices;
+    const std::vector<std::uint32_t> original_indices = indices;
+
+    const std::size_t removed = veng::DeduplicateVertices(vertices, indices);
+    Check(removed == 2 && vertices.size() == 4, "bitwise equal vertices are merged, -0 is kept apart from 0");
+    Check(indices[0] == indices[3] && indices[1] == indices[4], "duplicates map to the same vertex");
+    for (std::size_t i = 0; i < indices.size(); ++i) {
+        Check(IsBitwiseEqual(vertices[indices[i]], original_vertices[original_indices[i]]),
+              "every index still refers to the same vertex data");
+    }
+    for (std::size_t i = 0; i < vertices.size(); ++i) {
+        for (std::size_t j = i + 1; j < vertices.size(); ++j) {
+            Check(!IsBitwiseEqual(vertices[i], vertices[j]), "no duplicates are left");
+        }
+    }
+}
+
+void TestCacheAndOverdrawOrder() {
+    std::vector<veng::Vertex> vertices;
+    std::vector<std::uint32_t> indices;
+    MakeShuffledGrid(vertices, indices);
+    const auto vertex_count = static_cast<std::uint32_t>(vertices.size());
+    const std::vector<Triangle> triangle_set = GetTriangleSet(indices);
+    const float shuffled_acmr = veng::AnalyzeVertexCache(indices, vertex_count).acmr;
+
+    veng::OptimizeVertexCache(indices, vertex_count);
+    const float cache_acmr = veng::AnalyzeVertexCache(indices, vertex_count).acmr;
+    Check(GetTriangleSet(indices) == triangle_set, "OptimizeVertexCache keeps the triangles and their winding");
+    Check(cache_acmr < shuffled_acmr * 0.5f, "OptimizeVertexCache lowers ACMR");
+    spdlog::info("Grid ACMR: shuffled {}, cache order {}", shuffled_acmr, cache_acmr);
+
+    constexpr float kThreshold = 1.05f;
+    veng::OptimizeOverdraw(indices, vertices, veng::kDefaultVertexCacheSize, kThreshold);
+    const float overdraw_acmr = veng::AnalyzeVertexCache(indices, vertex_count).acmr;
+    Check(GetTriangleSet(indices) == triangle_set, "OptimizeOverdraw keeps the triangles and their winding");
+    Check(overdraw_acmr < shuffled_acmr, "the overdraw order still has a lower ACMR than the shuffled one");
+    // Clusters stay within the threshold on their own; where they are cut may cost a few more misses.
+    Check(overdraw_acmr <= cache_acmr * kThreshold * 1.1f, "OptimizeOverdraw stays close to the cache order");
+    spdlog::info("Grid ACMR after overdraw ordering {}", overdraw_acmr);
+}
+
+void TestOptimizeVertexFetch() {
+    std::vector<veng::Vertex> vertices;
+    std::vector<std::uint32_t> indices;
+    MakeShuffledGrid(vertices, indices);
+    // Nothing refers to this one, so it gets dropped.
+    vertices.emplace_back(glm::vec3(9.0f, 9.0f, 9.0f), glm::vec2(9.0f, 9.0f));
+    const std::vector<veng::Vertex> original_vertices = vertices;
+    const std::vector<std::uint32_t> original_indices = indices;
+
+    veng::OptimizeVertexFetch(vertices, indices);
+    Check(vertices.size() == original_vertices.size() - 1, "unreferenced vertices are dropped");
+
+    std::uint32_t next_new_vertex = 0;
+    bool first_use_order = true;
+    bool same_data = true;
+    for (std::size_t i = 0; i < indices.size(); ++i) {
+        if (indices[i] == next_new_vertex) {
+            ++next_new_vertex;
+        } else if (indices[i] > next_new_vertex) {
+            first_use_order = false;
+        }
+        same_data = same_data && IsBitwiseEqual(vertices[indices[i]], original_vertices[original_indices[i]]);
+    }
+    Check(first_use_order && next_new_vertex == vertices.size(), "vertices are numbered by first use");
+    Check(same_data, "every index still refers to the same vertex data");
+}
+}
+
+int main() {
+    TestAnalyzeVertexCache();
+    TestDeduplicateVertices();
+    TestCacheAndOverdrawOrder();
+    TestOptimizeVertexFetch();
+    return veng::test::GetExitCode();
+}
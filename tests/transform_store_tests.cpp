@@ -0,0 +1,150 @@
+#include "transform_store.h"
+
+#include <array>
+#include <cstring>
+#include <precomp.h>
+#include <random>
+#include <vector>
+
+#include <spdlog/spdlog.h>
+
+#include "check.h"
+
+namespace {
+using veng::test::Check;
+
+constexpr std::array kPaths = {veng::SimdPath::Scalar, veng::SimdPath::Sse, veng::SimdPath::Avx2};
+// None are multiples of four or eight, so every SIMD path also runs its scalar tail.
+constexpr std::array<std::size_t, 6> kCounts = {1, 3, 7, 13, 1021, 10007};
+// Offsets the sources off any SIMD width, so batches start at unaligned loads.
+constexpr std::array<std::size_t, 2> kFirsts = {0, 5};
+
+// Mapped GPU memory is aligned and gets streamed to; any other destination takes the unaligned store path.
+class MatrixBuffer {
+public:
+    MatrixBuffer(const std::size_t count, const bool aligned)
+        : storage_(count + 1), count_(count), offset_(aligned ? 0 : 1) {}
+
+    [[nodiscard]] std::span<glm::mat4> Get() {
+        // glm::mat4 only needs float alignment, so starting one float in is a valid misaligned destination.
+        return {reinterpret_cast<glm::mat4 *>(reinterpret_cast<float *>(storage_.data()) + offset_), count_};
+    }
+
+private:
+    std::vector<glm::mat4> storage_;
+    std::size_t count_;
+    std::size_t offset_;
+};
+
+bool IsBitwiseEqual(const std::span<const glm::mat4> a, const std::span<const glm::mat4> b) {
+    return a.size() == b.size() && std::memcmp(a.data(), b.data(), a.size_bytes()) == 0;
+}
+
+veng::TransformStore MakeRandomStore(const std::size_t count) {
+    std::mt19937 random(5);
+    std::uniform_real_distribution<float> position(-100.0f, 100.0f);
+    std::uniform_real_distribution<float> component(-1.0f, 1.0f);
+    std::uniform_real_distribution<float> scale(0.1f, 4.0f);
+
+    veng::TransformStore store;
+    store.Reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        float x = component(random);
+        float y = component(random);
+        float z = component(random);
+        float w = component(random);
+        const float inverse_length = 1.0f / std::sqrt(x * x + y * y + z * z + w * w);
+        x *= inverse_length;
+        y *= inverse_length;
+        z *= inverse_length;
+        w *= inverse_length;
+        store.Add({position(random), position(random), position(random)}, glm::quat(w, x, y, z),
+                  {scale(random), scale(random), scale(random)});
+    }
+    return store;
+}
+
+void TestPathsAgree() {
+    const veng::TransformStore store = MakeRandomStore(kCounts.back() + kFirsts.back());
+
+    for (const std::size_t count: kCounts) {
+        for (const std::size_t first: kFirsts) {
+            std::vector<glm::mat4> reference(count);
+            store.WriteWorldMatrices(first, reference, veng::SimdPath::Scalar);
+
+            for (const bool aligned: {true, false}) {
+                for (const veng::SimdPath path: kPaths) {
+                    MatrixBuffer buffer(count, aligned);
+                    const std::span<glm::mat4> output = buffer.Get();
+                    Check((reinterpret_cast<std::uintptr_t>(output.data()) % 16 == 0) == aligned,
+                          "the destination has the intended alignment");
+
+                    store.WriteWorldMatrices(first, output, path);
+                    Check(IsBitwiseEqual(output, reference), "world matrices match the scalar path bit for bit");
+                }
+            }
+        }
+    }
+}
+
+void CheckNear(const glm::vec4 &actual, const glm::vec4 &expected, const std::string_view what) {
+    constexpr float kTolerance = 1e-6f;
+    Check(std::abs(actual.x - expected.x) <= kTolerance && std::abs(actual.y - expected.y) <= kTolerance &&
+          std::abs(actual.z - expected.z) <= kTolerance && std::abs(actual.w - expected.w) <= kTolerance, what);
+}
+
+void TestKnownMatrices() {
+    veng::TransformStore store;
+    store.Add({1.0f, 2.0f, 3.0f}, glm::quat(1.0f, 0.0f, 0.0f, 0.0f), {2.0f, 3.0f, 4.0f});
+    // A quarter turn around z takes x to y and y to -x.
+    const float half_sqrt2 = std::sqrt(0.5f);
+    store.Add({-4.0f, 0.0f, 0.5f}, glm::quat(half_sqrt2, 0.0f, 0.0f, half_sqrt2), {2.0f, 1.0f, 1.0f});
+
+    for (const veng::SimdPath path: kPaths) {
+        std::vector<glm::mat4> output(store.Size());
+        store.WriteWorldMatrices(0, output, path);
+
+        CheckNear(output[0][0], {2.0f, 0.0f, 0.0f, 0.0f}, "scale lands on the diagonal");
+        CheckNear(output[0][1], {0.0f, 3.0f, 0.0f, 0.0f}, "scale lands on the diagonal");
+        CheckNear(output[0][2], {0.0f, 0.0f, 4.0f, 0.0f}, "scale lands on the diagonal");
+        CheckNear(output[0][3], {1.0f, 2.0f, 3.0f, 1.0f}, "the position is the last column");
+
+        CheckNear(output[1][0], {0.0f, 2.0f, 0.0f, 0.0f}, "scaled x axis is rotated onto y");
+        CheckNear(output[1][1], {-1.0f, 0.0f, 0.0f, 0.0f}, "y axis is rotated onto -x");
+        CheckNear(output[1][2], {0.0f, 0.0f, 1.0f, 0.0f}, "z axis stays in place");
+        CheckNear(output[1][3], {-4.0f, 0.0f, 0.5f, 1.0f}, "the position is the last column");
+    }
+}
+
+void TestWritesOnlyTheRange() {
+    const veng::TransformStore store = MakeRandomStore(64);
+    for (const veng::SimdPath path: kPaths) {
+        std::vector<glm::mat4> output(20, glm::mat4(7.0f));
+        const std::span<glm::mat4> range = std::span(output).subspan(2, 13);
+        store.WriteWorldMatrices(9, range, path);
+
+        std::vector<glm::mat4> reference(range.size());
+        store.WriteWorldMatrices(9, reference, veng::SimdPath::Scalar);
+        Check(IsBitwiseEqual(range, reference), "the range holds the world matrices");
+
+        const std::array untouched = {glm::mat4(7.0f)};
+        bool outside_untouched = true;
+        for (std::size_t i = 0; i < output.size(); ++i) {
+            if (i < 2 || i >= 15) {
+                outside_untouched = outside_untouched && IsBitwiseEqual(std::span(output).subspan(i, 1), untouched);
+            }
+        }
+        Check(outside_untouched, "matrices outside the range are untouched");
+
+    }
+}
+}
+
+int main() {
+    spdlog::info("Best SIMD path: {}", static_cast<int>(veng::GetBestSimdPath()));
+
+    TestPathsAgree();
+    TestKnownMatrices();
+    TestWritesOnlyTheRange();
+    return veng::test::GetExitCode();
+}